@@ -0,0 +1,60 @@
+#include <chrono>
+#include <vector>
+#include <iomanip>
+#include <iostream>
+#include <gtest/gtest.h>
+#include <cpputils/container/handle_manager.h>
+#include <cpputils/container/dense_handle_pool.h>
+
+using namespace utl;
+
+namespace dense_handle_pool_benchmark
+{
+    static constexpr size_t value_count = 4000000;
+    static constexpr size_t type_count  = 16;
+    static constexpr size_t iterations  = 10;
+
+    template<class T_func>
+    inline double measure_ms(T_func&& func)
+    {
+        auto start = std::chrono::steady_clock::now();
+        func();
+        auto end = std::chrono::steady_clock::now();
+        return std::chrono::duration<double, std::milli>(end - start).count();
+    }
+}
+
+using namespace ::dense_handle_pool_benchmark;
+
+TEST(dense_handle_pool_benchmark, type_iteration)
+{
+    handle_manager<int>     manager;
+    dense_handle_pool<int>  pool;
+    for (size_t i = 0; i < value_count; ++i)
+    {
+        auto tId = static_cast<type_id_type>(i % type_count);
+        manager.insert(tId, 0, static_cast<int>(i));
+        pool.insert   (tId, 0, static_cast<int>(i));
+    }
+
+    int64_t manager_sum = 0;
+    auto manager_ms = measure_ms([&]{
+        for (size_t i = 0; i < iterations; ++i)
+            for (auto v : manager.type_values(7))
+                manager_sum += v.second;
+    });
+
+    int64_t pool_sum = 0;
+    auto pool_ms = measure_ms([&]{
+        for (size_t i = 0; i < iterations; ++i)
+            for (auto& v : pool.values(7))
+                pool_sum += v;
+    });
+
+    EXPECT_EQ(manager_sum, pool_sum);
+    std::cout
+        << "values of type 7: "     << pool.size(7)
+        << "    manager [ms]: "     << std::fixed << std::setprecision(2) << manager_ms / iterations
+        << "    dense pool [ms]: "  << std::fixed << std::setprecision(2) << pool_ms    / iterations
+        << std::endl;
+}
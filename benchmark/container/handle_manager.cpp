@@ -0,0 +1,285 @@
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <random>
+#include <vector>
+#include <iomanip>
+#include <iostream>
+#include <gtest/gtest.h>
+#include <cpputils/misc/mapped_file.h>
+#include <cpputils/container/handle_manager.h>
+
+using namespace utl;
+
+namespace handle_manager_benchmark
+{
+    static constexpr size_t lookup_count = 10000000;
+
+    template<class T_func>
+    inline double measure_ns(size_t count, T_func&& func)
+    {
+        auto start = std::chrono::steady_clock::now();
+        func();
+        auto end = std::chrono::steady_clock::now();
+        return std::chrono::duration<double, std::nano>(end - start).count() / static_cast<double>(count);
+    }
+
+    /* unchanged copy of the original handle::to_string implementation (reference for the string_round_trip benchmark) */
+    inline std::string legacy_to_string(const handle& h)
+    {
+        char buffer[2*sizeof(h)+3];
+        memset(&buffer[0], 0, sizeof(buffer));
+        const uint8_t *p = reinterpret_cast<const uint8_t*>(&h);
+        size_t x = 0;
+        for (size_t i = 0; i < sizeof(h); ++i)
+        {
+            if (i == 1 || i == 2 || i == 4)
+            {
+                buffer[2*i+x] = '-';
+                ++x;
+            }
+            buffer[2*i+x]   = static_cast<char>((p[i] >> 4) & 0x0F);
+            buffer[2*i+x+1] = static_cast<char>((p[i] >> 0) & 0x0F);
+            buffer[2*i+x]   = static_cast<char>(buffer[2*i+x]   + (buffer[2*i+x]   > 9 ? 'A' - 10 : '0'));
+            buffer[2*i+x+1] = static_cast<char>(buffer[2*i+x+1] + (buffer[2*i+x+1] > 9 ? 'A' - 10 : '0'));
+        }
+        return std::string(&buffer[0], sizeof(buffer));
+    }
+
+    /* unchanged copy of the original handle::from_string implementation (reference for the string_round_trip
+     * benchmark). It still has the bugs of the original: the two digits of a byte are stored in swapped order
+     * and 'a'..'f' / 'A'..'F' are parsed as 0..5. Only its speed is measured, the parsed handles are not checked. */
+    inline bool legacy_from_string(const std::string& str, handle& h)
+    {
+        h = handle();
+        const char *c = str.c_str();
+        const char *e = c + str.size();
+        uint8_t* p = reinterpret_cast<uint8_t*>(&h);
+        size_t i = 0;
+        while(c < e && i < 2*sizeof(h))
+        {
+            if (*c != '-')
+            {
+                uint8_t v;
+                if (*c >= '0' && *c <= '9')
+                    v = static_cast<uint8_t>(*c - '0');
+                else if (*c >= 'a' && *c <= 'f')
+                    v = static_cast<uint8_t>(*c - 'a');
+                else if (*c >= 'A' && *c <= 'F')
+                    v = static_cast<uint8_t>(*c - 'A');
+                else
+                    return false;
+                if (i & 1)
+                    v = static_cast<uint8_t>(v << 4);
+                p[i >> 1] |= v;
+                ++i;
+            }
+            ++c;
+        }
+        return (c == e && i == 2*sizeof(h));
+    }
+
+    /* random lookups on a manager with the given number of handles (every second handle is removed again) */
+    template<class T_manager>
+    inline void run_lookup(const char* name, size_t handle_count)
+    {
+        T_manager manager;
+        std::vector<handle> handles;
+        handles.reserve(handle_count);
+        for (size_t i = 0; i < handle_count; ++i)
+            handles.push_back(manager.insert(0, 0, static_cast<int>(i)));
+        for (size_t i = 0; i < handle_count; i += 2)
+            manager.remove(handles[i]);
+
+        std::mt19937 rng(42);
+        std::vector<handle> lookups;
+        lookups.reserve(lookup_count);
+        for (size_t i = 0; i < lookup_count; ++i)
+            lookups.push_back(handles[rng() % handles.size()]);
+
+        size_t valid = 0;
+        auto is_valid_ns = measure_ns(lookup_count, [&]{
+            for (auto& h : lookups)
+                valid += manager.is_valid(h) ? 1 : 0;
+        });
+
+        int64_t sum = 0;
+        auto try_get_ns = measure_ns(lookup_count, [&]{
+            int val;
+            for (auto& h : lookups)
+            {
+                if (manager.try_get(h, val))
+                    sum += val;
+            }
+        });
+
+        std::cout
+            << std::setw(8)  << name
+            << std::setw(12) << handle_count
+            << std::setw(18) << std::fixed << std::setprecision(2) << is_valid_ns
+            << std::setw(18) << std::fixed << std::setprecision(2) << try_get_ns
+            << "    (" << valid << ", " << sum << ")"
+            << std::endl;
+    }
+}
+
+using namespace ::handle_manager_benchmark;
+
+TEST(handle_manager_benchmark, layout_lookup)
+{
+    std::cout << "  layout     handles    is_valid [ns]     try_get [ns]" << std::endl;
+    for (size_t handle_count : { 1000000, 10000000 })
+    {
+        run_lookup<handle_manager<int, aos_layout>>("aos", handle_count);
+        run_lookup<handle_manager<int, soa_layout>>("soa", handle_count);
+    }
+}
+
+TEST(handle_manager_benchmark, encoding_lookup)
+{
+    std::cout << "encoding     handles    is_valid [ns]     try_get [ns]" << std::endl;
+    for (size_t handle_count : { 10000, 1000000 })
+    {
+        run_lookup<handle_manager<int, aos_layout, network_handle_encoding>>("network", handle_count);
+        run_lookup<handle_manager<int, aos_layout, native_handle_encoding>> ("native",  handle_count);
+    }
+}
+
+TEST(handle_manager_benchmark, snapshot_restore)
+{
+    static constexpr size_t handle_count = 20000000;
+    using clock = std::chrono::steady_clock;
+
+    handle_manager<int> manager;
+    for (size_t i = 0; i < handle_count; ++i)
+        manager.insert(0, 0, static_cast<int>(i));
+
+    auto start = clock::now();
+    {
+        handle_manager<int> reinserted;
+        for (size_t i = 0; i < handle_count; ++i)
+            reinserted.insert(0, 0, static_cast<int>(i));
+    }
+    auto reinsert_ms = std::chrono::duration<double, std::milli>(clock::now() - start).count();
+
+    std::string filename = ::testing::TempDir() + "handle_manager_benchmark.bin";
+    {
+        std::ofstream os(filename, std::ios::binary);
+        manager.serialize(os);
+    }
+
+    /* copy the pages out of a read only mapping */
+    start = clock::now();
+    {
+        handle_manager<int> restored;
+        mapped_file file(filename);
+        restored.deserialize(file.data(), file.size());
+    }
+    auto copy_ms = std::chrono::duration<double, std::milli>(clock::now() - start).count();
+
+    /* use the pages of a copy-on-write mapping in place */
+    int64_t sum = 0;
+    double  first_get_ms;
+    start = clock::now();
+    {
+        handle_manager<int> restored;
+        restored.map_snapshot(filename);
+        first_get_ms = std::chrono::duration<double, std::milli>(clock::now() - start).count();
+        for (auto v : restored)
+            sum += v.second;
+    }
+    auto map_ms = std::chrono::duration<double, std::milli>(clock::now() - start).count();
+    std::remove(filename.c_str());
+
+    std::cout
+        << "handles: "                  << handle_count
+        << "    reinsert [ms]: "        << std::fixed << std::setprecision(2) << reinsert_ms
+        << "    deserialize [ms]: "     << std::fixed << std::setprecision(2) << copy_ms
+        << "    map_snapshot [ms]: "    << std::fixed << std::setprecision(2) << first_get_ms
+        << "    + iterate all [ms]: "   << std::fixed << std::setprecision(2) << map_ms
+        << "    (" << sum << ")"
+        << std::endl;
+}
+
+TEST(handle_manager_benchmark, string_round_trip)
+{
+    static constexpr size_t handle_count = 1000000;
+
+    handle_manager<int> manager;
+    std::vector<handle> handles;
+    handles.reserve(handle_count);
+    for (size_t i = 0; i < handle_count; ++i)
+        handles.push_back(manager.insert(static_cast<type_id_type>(i & 0xFF), 0, static_cast<int>(i)));
+
+    size_t check = 0;
+
+    /* before: original byte-by-byte implementation */
+    std::vector<std::string> legacy_strings;
+    legacy_strings.reserve(handle_count);
+    auto legacy_to_string_ns = measure_ns(handle_count, [&]{
+        for (auto& h : handles)
+            legacy_strings.push_back(legacy_to_string(h));
+    });
+
+    auto legacy_from_string_ns = measure_ns(handle_count, [&]{
+        handle h;
+        for (auto& s : legacy_strings)
+            check += legacy_from_string(s, h) ? static_cast<size_t>(h.value & 1) : 0;
+    });
+
+    /* after: table based implementation */
+    std::vector<std::string> strings;
+    strings.reserve(handle_count);
+    auto to_string_ns = measure_ns(handle_count, [&]{
+        for (auto& h : handles)
+            strings.push_back(h.to_string());
+    });
+    EXPECT_EQ(legacy_strings, strings);
+
+    auto from_string_ns = measure_ns(handle_count, [&]{
+        handle h;
+        for (auto& s : strings)
+            check += handle::from_string(s, h) ? static_cast<size_t>(h.value & 1) : 0;
+    });
+
+    std::string buffer(handle_count * (handle::string_size + 1), ' ');
+    auto to_chars_ns = measure_ns(handle_count, [&]{
+        auto first = &buffer[0];
+        auto last  = first + buffer.size();
+        for (auto& h : handles)
+            first = h.to_chars(first, last).ptr + 1;
+    });
+
+    auto from_chars_ns = measure_ns(handle_count, [&]{
+        handle h;
+        const char* first = buffer.data();
+        const char* last  = first + buffer.size();
+        for (size_t i = 0; i < handle_count; ++i)
+        {
+            first  = handle::from_chars(first, last, h).ptr + 1;
+            check += static_cast<size_t>(h.value & 1);
+        }
+    });
+
+    std::vector<handle> parsed(handle_count);
+    auto bulk_ns = measure_ns(handle_count, [&]{
+        auto first = &buffer[0];
+        auto last  = first + buffer.size();
+        handle::to_chars_n(handles.data(), handles.size(), first, last, '\n');
+        handle::from_chars_n(first, last, parsed.data(), parsed.size(), '\n');
+    });
+    check += parsed == handles ? 1 : 0;
+
+    std::cout
+        << "before    to_string [ns]: "     << std::fixed << std::setprecision(2) << legacy_to_string_ns
+        << "    from_string [ns]: "         << std::fixed << std::setprecision(2) << legacy_from_string_ns
+        << std::endl
+        << "after     to_string [ns]: "     << std::fixed << std::setprecision(2) << to_string_ns
+        << "    from_string [ns]: "         << std::fixed << std::setprecision(2) << from_string_ns
+        << "    to_chars [ns]: "            << std::fixed << std::setprecision(2) << to_chars_ns
+        << "    from_chars [ns]: "          << std::fixed << std::setprecision(2) << from_chars_ns
+        << "    bulk round trip [ns]: "     << std::fixed << std::setprecision(2) << bulk_ns
+        << "    (" << check << ")"
+        << std::endl;
+}
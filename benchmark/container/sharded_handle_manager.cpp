@@ -0,0 +1,99 @@
+#include <mutex>
+#include <chrono>
+#include <random>
+#include <thread>
+#include <vector>
+#include <iomanip>
+#include <iostream>
+#include <gtest/gtest.h>
+#include <cpputils/container/handle_manager.h>
+#include <cpputils/container/sharded_handle_manager.h>
+
+using namespace utl;
+
+namespace sharded_handle_manager_benchmark
+{
+    static constexpr size_t values_per_thread = 1000;
+    static constexpr size_t ops_per_thread    = 500000;
+    static constexpr size_t write_per_mille   = 500;
+
+    struct locked_handle_manager
+    {
+        std::mutex              mutex;
+        handle_manager<int>     manager;
+
+        inline bool try_get(const handle& h, int& value)
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            return manager.try_get(h, value);
+        }
+
+        inline handle insert(size_t, const type_id_type& tId, const system_id_type& sId, int value)
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            return manager.insert(tId, sId, value);
+        }
+
+        inline bool remove(const handle& h)
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            return manager.remove(h);
+        }
+    };
+
+    /* each thread replaces and reads its own values, returns the throughput in operations per second */
+    template<class T_manager>
+    inline double run(T_manager& manager, size_t thread_count)
+    {
+        std::vector<std::thread> threads;
+        auto start = std::chrono::steady_clock::now();
+        for (size_t t = 0; t < thread_count; ++t)
+        {
+            threads.emplace_back([&, t]{
+                std::mt19937 rng(static_cast<uint32_t>(t));
+                std::vector<handle> handles;
+                handles.reserve(values_per_thread);
+                for (size_t i = 0; i < values_per_thread; ++i)
+                    handles.push_back(manager.insert(t, 0, 0, static_cast<int>(i)));
+
+                int val = 0;
+                for (size_t i = 0; i < ops_per_thread; ++i)
+                {
+                    auto  r = rng();
+                    auto& h = handles[r % values_per_thread];
+                    if ((r >> 16) % 1000 < write_per_mille)
+                    {
+                        manager.remove(h);
+                        h = manager.insert(t, 0, 0, static_cast<int>(r));
+                    }
+                    else
+                        manager.try_get(h, val);
+                }
+            });
+        }
+        for (auto& t : threads)
+            t.join();
+        auto end     = std::chrono::steady_clock::now();
+        auto seconds = std::chrono::duration<double>(end - start).count();
+        return static_cast<double>(thread_count * ops_per_thread) / seconds;
+    }
+}
+
+using namespace ::sharded_handle_manager_benchmark;
+
+TEST(sharded_handle_manager_benchmark, insert_remove_scaling)
+{
+    std::cout << "threads    mutex [Mops/s]    sharded [Mops/s]" << std::endl;
+    for (size_t thread_count : { 1, 2, 4, 8, 16, 32 })
+    {
+        locked_handle_manager           locked;
+        sharded_handle_manager<int, 5>  sharded;
+        auto l = run(locked,  thread_count);
+        auto s = run(sharded, thread_count);
+        std::cout
+            << std::setw(7)  << thread_count
+            << std::setw(18) << std::fixed << std::setprecision(2) << l / 1e6
+            << std::setw(20) << std::fixed << std::setprecision(2) << s / 1e6
+            << std::endl;
+    }
+}
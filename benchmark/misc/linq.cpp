@@ -0,0 +1,628 @@
+#include <chrono>
+#include <random>
+#include <vector>
+#include <mutex>
+#include <numeric>
+#include <iomanip>
+#include <iostream>
+#include <gtest/gtest.h>
+#include <cpputils/misc/linq.h>
+#include <cpputils/misc/arena.h>
+#include "../../test/helper/counting_resource.h"
+
+using namespace utl;
+using namespace utl::linq;
+
+namespace linq_benchmark
+{
+    template<class T_func>
+    inline double measure_ms(T_func&& func)
+    {
+        auto start = std::chrono::steady_clock::now();
+        func();
+        auto end = std::chrono::steady_clock::now();
+        return std::chrono::duration<double, std::milli>(end - start).count();
+    }
+
+    struct op_is_odd
+    {
+        inline bool operator()(const int64_t& i) const
+            { return (i & 1) != 0; }
+    };
+
+    struct op_scale
+    {
+        inline int64_t operator()(const int64_t& i) const
+            { return i * 3 + 1; }
+    };
+
+    struct op_identity
+    {
+        template<class T>
+        inline T operator()(const T& t) const
+            { return t; }
+    };
+
+    /* sum, min and max of a contiguous range with each instruction set compared to a non contiguous range */
+    template<class T>
+    inline void run_reducers(const char* name)
+    {
+        static constexpr size_t value_count = 10000000;
+        static constexpr size_t repeat      = 10;
+
+        std::vector<T> data(value_count);
+        for (size_t i = 0; i < value_count; ++i)
+            data[i] = static_cast<T>(static_cast<int64_t>(i % 1000) - 500);
+
+        double check = 0;
+        auto run = [&](const char* mode, auto&& sum, auto&& min, auto&& max) {
+            auto sum_ms = measure_ms([&]{ for (size_t i = 0; i < repeat; ++i) check += static_cast<double>(sum()); }) / repeat;
+            auto min_ms = measure_ms([&]{ for (size_t i = 0; i < repeat; ++i) check += static_cast<double>(min()); }) / repeat;
+            auto max_ms = measure_ms([&]{ for (size_t i = 0; i < repeat; ++i) check += static_cast<double>(max()); }) / repeat;
+            std::cout
+                << std::setw(8)  << name
+                << std::setw(10) << mode
+                << std::setw(12) << std::fixed << std::setprecision(2) << sum_ms
+                << std::setw(12) << std::fixed << std::setprecision(2) << min_ms
+                << std::setw(12) << std::fixed << std::setprecision(2) << max_ms
+                << std::endl;
+        };
+
+        run("select",
+            [&]{ return from_container(data) >> select(op_identity()) >> linq::sum(); },
+            [&]{ return from_container(data) >> select(op_identity()) >> linq::min(); },
+            [&]{ return from_container(data) >> select(op_identity()) >> linq::max(); });
+
+        for (auto is : { simd::instruction_set::scalar, simd::instruction_set::sse42, simd::instruction_set::avx2 })
+        {
+            if (is > simd::supported_instruction_set())
+                continue;
+            run(is == simd::instruction_set::scalar ? "scalar"
+              : is == simd::instruction_set::sse42  ? "sse4.2"
+              :                                       "avx2",
+                [&]{ return simd::sum(data.data(), data.size(), is); },
+                [&]{ return simd::min(data.data(), data.size(), is); },
+                [&]{ return simd::max(data.data(), data.size(), is); });
+        }
+
+        run("linq",
+            [&]{ return from_container(data) >> linq::sum(); },
+            [&]{ return from_container(data) >> linq::min(); },
+            [&]{ return from_container(data) >> linq::max(); });
+
+        std::cout << "    (" << check << ")" << std::endl;
+    }
+}
+
+using namespace ::linq_benchmark;
+
+TEST(linq_benchmark, parallel_scaling)
+{
+    static constexpr size_t value_count = 20000000;
+
+    std::vector<int64_t> data(value_count);
+    for (size_t i = 0; i < value_count; ++i)
+        data[i] = static_cast<int64_t>(i);
+
+    int64_t expected = 0;
+    auto sequential_ms = measure_ms([&]{
+        expected = from_container(data)
+            >> where(op_is_odd())
+            >> select(op_scale())
+            >> linq::sum();
+    });
+    std::cout << " threads      time [ms]    speedup" << std::endl;
+    std::cout
+        << std::setw(8)  << "seq"
+        << std::setw(15) << std::fixed << std::setprecision(2) << sequential_ms
+        << std::setw(11) << std::fixed << std::setprecision(2) << 1.0
+        << std::endl;
+
+    for (size_t threads : { 1, 2, 4, 8 })
+    {
+        int64_t result = 0;
+        auto ms = measure_ms([&]{
+            result = from_container(data)
+                >> parallel(threads)
+                >> where(op_is_odd())
+                >> select(op_scale())
+                >> linq::sum();
+        });
+        EXPECT_EQ(expected, result);
+        std::cout
+            << std::setw(8)  << threads
+            << std::setw(15) << std::fixed << std::setprecision(2) << ms
+            << std::setw(11) << std::fixed << std::setprecision(2) << sequential_ms / ms
+            << std::endl;
+    }
+}
+
+TEST(linq_benchmark, random_access)
+{
+    static constexpr size_t value_count = 10000000;
+
+    std::vector<int64_t> data(value_count);
+    for (size_t i = 0; i < value_count; ++i)
+        data[i] = static_cast<int64_t>(i);
+
+    int64_t expected = 0;
+    auto loop_ms = measure_ms([&]{
+        for (auto& v : data)
+            expected += op_scale()(v);
+    });
+
+    int64_t result = 0;
+    auto sum_ms = measure_ms([&]{
+        result = from_container(data)
+            >> select(op_scale())
+            >> linq::sum();
+    });
+    EXPECT_EQ(expected, result);
+
+    size_t size = 0;
+    auto to_vector_ms = measure_ms([&]{
+        size = (from_container(data)
+            >> select(op_scale())
+            >> to_vector()).size();
+    });
+    EXPECT_EQ(value_count, size);
+
+    std::cout
+        << "loop [ms]: "                << std::fixed << std::setprecision(2) << loop_ms
+        << "    select >> sum [ms]: "       << std::fixed << std::setprecision(2) << sum_ms
+        << "    select >> to_vector [ms]: " << std::fixed << std::setprecision(2) << to_vector_ms
+        << std::endl;
+}
+
+TEST(linq_benchmark, simd_reducers)
+{
+    std::cout << "    type      mode    sum [ms]    min [ms]    max [ms]" << std::endl;
+    run_reducers<float>  ("float");
+    run_reducers<int64_t>("int64_t");
+}
+
+TEST(linq_benchmark, order_by_take)
+{
+    static constexpr size_t value_count = 10000000;
+    static constexpr size_t take_count  = 10;
+
+    std::mt19937 rng(42);
+    std::vector<int64_t> data(value_count);
+    for (auto& v : data)
+        v = static_cast<int64_t>(rng());
+
+    std::vector<int64_t> sorted;
+    auto sort_ms = measure_ms([&]{
+        sorted = from_container(data)
+            >> order_by()
+            >> to_vector();
+        sorted.resize(take_count);
+    });
+
+    std::vector<int64_t> top;
+    auto take_ms = measure_ms([&]{
+        top = from_container(data)
+            >> order_by()
+            >> take(take_count)
+            >> to_vector();
+    });
+    EXPECT_EQ(sorted, top);
+
+    int64_t smallest = 0;
+    auto first_ms = measure_ms([&]{
+        smallest = from_container(data)
+            >> order_by()
+            >> first();
+    });
+    EXPECT_EQ(sorted[0], smallest);
+
+    std::cout
+        << "values: "                   << value_count
+        << "    full sort [ms]: "       << std::fixed << std::setprecision(2) << sort_ms
+        << "    take(" << take_count << ") [ms]: " << std::fixed << std::setprecision(2) << take_ms
+        << "    first [ms]: "           << std::fixed << std::setprecision(2) << first_ms
+        << std::endl;
+}
+
+TEST(linq_benchmark, hash_grouping)
+{
+    static constexpr size_t value_count = 2000000;
+
+    std::cout << "    keys   distinct [ms]   distinct_hash [ms]   to_lookup [ms]   to_hash_lookup [ms]" << std::endl;
+    for (size_t key_count : { 100, 10000, 1000000 })
+    {
+        std::mt19937 rng(42);
+        std::vector<int64_t> data(value_count);
+        for (auto& v : data)
+            v = static_cast<int64_t>(rng() % key_count);
+
+        size_t check = 0;
+        auto distinct_ms = measure_ms([&]{
+            check += from_container(data) >> distinct() >> count();
+        });
+        auto distinct_hash_ms = measure_ms([&]{
+            check += from_container(data) >> distinct_hash() >> count();
+        });
+        auto lookup_ms = measure_ms([&]{
+            auto lookup = from_container(data) >> to_lookup(op_identity(), op_identity());
+            check += lookup[0] >> count();
+        });
+        auto hash_lookup_ms = measure_ms([&]{
+            auto lookup = from_container(data) >> to_hash_lookup(op_identity(), op_identity());
+            check += lookup[0] >> count();
+        });
+
+        std::cout
+            << std::setw(8)  << key_count
+            << std::setw(16) << std::fixed << std::setprecision(2) << distinct_ms
+            << std::setw(21) << std::fixed << std::setprecision(2) << distinct_hash_ms
+            << std::setw(17) << std::fixed << std::setprecision(2) << lookup_ms
+            << std::setw(22) << std::fixed << std::setprecision(2) << hash_lookup_ms
+            << "    (" << check << ")"
+            << std::endl;
+    }
+}
+
+namespace linq_benchmark
+{
+    struct record
+    {
+        int64_t key;
+        char    payload[1016];
+    };
+
+    struct op_record_key
+    {
+        inline int64_t operator()(const record& r) const
+            { return r.key; }
+    };
+
+    struct op_record_copy
+    {
+        inline record operator()(const record& r) const
+            { return r; }
+    };
+}
+
+TEST(linq_benchmark, reference_mode)
+{
+    static constexpr size_t record_count = 100000;
+
+    std::mt19937 rng(42);
+    std::vector<record> records(record_count);
+    for (auto& r : records)
+    {
+        r.key = static_cast<int64_t>(rng() % 1000);
+        std::fill(std::begin(r.payload), std::end(r.payload), static_cast<char>(r.key));
+    }
+
+    int64_t check = 0;
+    auto touch = [&](const record& r) { check += r.key + r.payload[512]; };
+
+    auto order_by_copy_ms = measure_ms([&]{
+        from_container(records)
+            >> select(op_record_copy())
+            >> order_by(op_record_key())
+            >> for_each(touch);
+    });
+    auto order_by_ms = measure_ms([&]{
+        from_container(records)
+            >> order_by(op_record_key())
+            >> for_each(touch);
+    });
+    auto order_by_ref_ms = measure_ms([&]{
+        from_container(records)
+            >> order_by_ref(op_record_key())
+            >> for_each(touch);
+    });
+
+    auto lookup_ms = measure_ms([&]{
+        auto lookup = from_container(records) >> to_lookup(op_record_key(), op_record_copy());
+        lookup[7] >> for_each(touch);
+    });
+    auto lookup_ref_ms = measure_ms([&]{
+        auto lookup = from_container(records) >> to_lookup_ref(op_record_key());
+        lookup[7] >> for_each(touch);
+    });
+    auto hash_lookup_ms = measure_ms([&]{
+        auto lookup = from_container(records) >> to_hash_lookup(op_record_key(), op_record_copy());
+        lookup[7] >> for_each(touch);
+    });
+    auto hash_lookup_ref_ms = measure_ms([&]{
+        auto lookup = from_container(records) >> to_hash_lookup_ref(op_record_key());
+        lookup[7] >> for_each(touch);
+    });
+
+    std::cout
+        << "records: " << record_count << " x " << sizeof(record) << " bytes" << std::endl
+        << "    order_by of copies [ms]: "      << std::fixed << std::setprecision(2) << order_by_copy_ms
+        << "    order_by [ms]: "                << std::fixed << std::setprecision(2) << order_by_ms
+        << "    order_by_ref [ms]: "            << std::fixed << std::setprecision(2) << order_by_ref_ms << std::endl
+        << "    to_lookup [ms]: "               << std::fixed << std::setprecision(2) << lookup_ms
+        << "    to_lookup_ref [ms]: "           << std::fixed << std::setprecision(2) << lookup_ref_ms << std::endl
+        << "    to_hash_lookup [ms]: "          << std::fixed << std::setprecision(2) << hash_lookup_ms
+        << "    to_hash_lookup_ref [ms]: "      << std::fixed << std::setprecision(2) << hash_lookup_ref_ms
+        << "    (" << check << ")"
+        << std::endl;
+}
+
+namespace linq_benchmark
+{
+    using ::test_helper::counting_resource;
+
+    struct op_mod_16
+    {
+        inline int64_t operator()(const int64_t& i) const
+            { return i % 16; }
+    };
+}
+
+TEST(linq_benchmark, arena_allocation)
+{
+    static constexpr size_t value_count = 1000;
+    static constexpr size_t query_count = 10000;
+
+    std::mt19937 rng(42);
+    std::vector<int64_t> data(value_count);
+    for (auto& v : data)
+        v = static_cast<int64_t>(rng() % 500);
+
+    /* the query shape of a request handler: ordering, duplicate removal and grouping */
+    int64_t check = 0;
+    auto query = [&]{
+        check += from_container(data) >> order_by() >> skip(10) >> first();
+        check += from_container(data) >> distinct() >> count();
+        check += from_container(data) >> distinct_hash() >> count();
+        auto lookup = from_container(data) >> to_hash_lookup(op_mod_16(), op_identity());
+        check += lookup[3] >> count();
+    };
+
+    counting_resource counter;
+    auto previous = std::pmr::set_default_resource(&counter);
+
+    auto default_ms = measure_ms([&]{
+        for (size_t i = 0; i < query_count; ++i)
+            query();
+    });
+    auto default_allocations = counter.allocations;
+
+    counting_resource upstream;
+    utl::arena arena(utl::arena::default_block_size, &upstream);
+    counter.allocations = 0;
+    auto arena_ms = measure_ms([&]{
+        for (size_t i = 0; i < query_count; ++i)
+        {
+            {
+                memory_scope scope(arena);
+                query();
+            }
+            arena.reset();
+        }
+    });
+    auto arena_allocations = counter.allocations + upstream.allocations;
+
+    std::pmr::set_default_resource(previous);
+
+    std::cout
+        << "queries: "                      << query_count
+        << "    default [ms]: "             << std::fixed << std::setprecision(2) << default_ms
+        << "    allocations: "              << default_allocations
+        << "    arena [ms]: "               << std::fixed << std::setprecision(2) << arena_ms
+        << "    allocations: "              << arena_allocations
+        << "    arena capacity [bytes]: "   << arena.capacity()
+        << "    (" << check << ")"
+        << std::endl;
+}
+
+namespace linq_benchmark
+{
+    struct op_greater_100
+    {
+        inline bool operator()(const int64_t& i) const
+            { return i > 100; }
+    };
+}
+
+TEST(linq_benchmark, push_evaluation)
+{
+    static constexpr size_t value_count = 10000000;
+    static constexpr size_t repeat      = 10;
+
+    std::vector<int64_t> data(value_count);
+    for (size_t i = 0; i < value_count; ++i)
+        data[i] = static_cast<int64_t>(i % 1000);
+
+    int64_t manual_sum = 0;
+    auto manual_ms = measure_ms([&]{
+        for (size_t i = 0; i < repeat; ++i)
+        {
+            manual_sum = 0;
+            for (auto& x : data)
+            {
+                if ((x & 1) == 0)
+                    continue;
+                auto y = x * 3 + 1;
+                if (y > 100)
+                    manual_sum += y;
+            }
+        }
+    }) / repeat;
+
+    int64_t linq_sum = 0;
+    auto linq_ms = measure_ms([&]{
+        for (size_t i = 0; i < repeat; ++i)
+        {
+            linq_sum = from_container(data)
+                >> where(op_is_odd())
+                >> select(op_scale())
+                >> where(op_greater_100())
+                >> linq::sum();
+        }
+    }) / repeat;
+    EXPECT_EQ(manual_sum, linq_sum);
+
+    size_t linq_count = 0;
+    auto count_ms = measure_ms([&]{
+        for (size_t i = 0; i < repeat; ++i)
+        {
+            linq_count = from_container(data)
+                >> where(op_is_odd())
+                >> count();
+        }
+    }) / repeat;
+    EXPECT_EQ(value_count / 2, linq_count);
+
+    std::vector<int64_t> v;
+    auto vector_ms = measure_ms([&]{
+        for (size_t i = 0; i < repeat; ++i)
+        {
+            v = from_container(data)
+                >> where(op_is_odd())
+                >> select(op_scale())
+                >> to_vector();
+        }
+    }) / repeat;
+
+    std::cout
+        << "values: "                               << value_count
+        << "    manual loop [ms]: "                 << std::fixed << std::setprecision(2) << manual_ms
+        << "    where/select/where/sum [ms]: "      << std::fixed << std::setprecision(2) << linq_ms
+        << "    where/count [ms]: "                 << std::fixed << std::setprecision(2) << count_ms
+        << "    where/select/to_vector [ms]: "      << std::fixed << std::setprecision(2) << vector_ms
+        << "    (" << v.size() << ")"
+        << std::endl;
+}
+
+namespace linq_benchmark
+{
+    struct op_first
+    {
+        template<class T>
+        inline int64_t operator()(const T& p) const
+            { return p.first; }
+    };
+
+    struct op_join_sum
+    {
+        template<class T, class U>
+        inline int64_t operator()(const T& l, const U& r) const
+            { return l.second + r.second; }
+    };
+}
+
+TEST(linq_benchmark, join)
+{
+    static constexpr size_t outer_count = 2000000;
+    static constexpr size_t inner_count = 100000;
+
+    using pair_type = std::pair<int64_t, int64_t>;
+    std::mt19937 rng(42);
+    std::vector<pair_type> outer(outer_count);
+    std::vector<pair_type> inner(inner_count);
+    for (size_t i = 0; i < outer_count; ++i)
+        outer[i] = pair_type(static_cast<int64_t>(rng() % (2 * inner_count)), static_cast<int64_t>(i));
+    for (size_t i = 0; i < inner_count; ++i)
+        inner[i] = pair_type(static_cast<int64_t>(i * 2), static_cast<int64_t>(i));
+    std::shuffle(inner.begin(), inner.end(), rng);
+
+    /* hand written: probe a lookup of the inner range for each element */
+    int64_t lookup_sum = 0;
+    auto lookup_ms = measure_ms([&]{
+        auto lookup = from_container(inner) >> to_lookup(op_first(), op_select_ref());
+        for (auto& o : outer)
+        {
+            auto matches = lookup[o.first];
+            while (matches.next())
+                lookup_sum += o.second + matches.front().second;
+        }
+    });
+
+    int64_t hash_sum = 0;
+    auto hash_ms = measure_ms([&]{
+        hash_sum = from_container(outer)
+            >> join(from_container(inner), op_first(), op_first(), op_join_sum())
+            >> linq::sum();
+    });
+    EXPECT_EQ(lookup_sum, hash_sum);
+
+    std::sort(outer.begin(), outer.end());
+    std::sort(inner.begin(), inner.end());
+    int64_t merge_sum = 0;
+    auto merge_ms = measure_ms([&]{
+        merge_sum = from_container(outer)
+            >> merge_join(from_container(inner), op_first(), op_first(), op_join_sum())
+            >> linq::sum();
+    });
+    EXPECT_EQ(lookup_sum, merge_sum);
+
+    std::cout
+        << "outer: "                    << outer_count
+        << "    inner: "                << inner_count
+        << "    to_lookup probe [ms]: " << std::fixed << std::setprecision(2) << lookup_ms
+        << "    join [ms]: "            << std::fixed << std::setprecision(2) << hash_ms
+        << "    merge_join [ms]: "      << std::fixed << std::setprecision(2) << merge_ms
+        << "    (" << hash_sum << ")"
+        << std::endl;
+}
+
+namespace linq_benchmark
+{
+    /* batched api with a fixed cost per call (e.g. a database or a simd kernel behind a lock) */
+    struct batched_scorer
+    {
+        std::mutex mutex;
+
+        inline int64_t score(const int64_t* data, size_t size)
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            return simd::sum(data, size);
+        }
+    };
+}
+
+TEST(linq_benchmark, batch)
+{
+    static constexpr size_t value_count = 10000000;
+    static constexpr size_t batch_size  = 1024;
+
+    std::vector<int64_t> values(value_count);
+    std::mt19937 rng(42);
+    for (auto& v : values)
+        v = static_cast<int64_t>(rng() % 1000);
+
+    batched_scorer scorer;
+    int64_t element_sum = 0;
+    auto element_ms = measure_ms([&]{
+        element_sum = from_container(values)
+            >> where(op_is_odd())
+            >> select([&scorer](const int64_t& i) { return scorer.score(&i, 1); })
+            >> linq::sum();
+    });
+
+    int64_t batch_sum = 0;
+    auto batch_ms = measure_ms([&]{
+        batch_sum = from_container(values)
+            >> where(op_is_odd())
+            >> batch(batch_size)
+            >> select([&scorer](span<int64_t> b) { return scorer.score(b.data(), b.size()); })
+            >> linq::sum();
+    });
+    EXPECT_EQ(element_sum, batch_sum);
+
+    int64_t contiguous_sum = 0;
+    auto contiguous_ms = measure_ms([&]{
+        contiguous_sum = from_container(values)
+            >> batch(batch_size)
+            >> select([&scorer](span<int64_t> b) { return scorer.score(b.data(), b.size()); })
+            >> linq::sum();
+    });
+    EXPECT_EQ(std::accumulate(values.begin(), values.end(), int64_t(0)), contiguous_sum);
+
+    std::cout
+        << "values: "                                   << value_count
+        << "    where >> select [ms]: "                 << std::fixed << std::setprecision(2) << element_ms
+        << "    where >> batch >> select [ms]: "        << std::fixed << std::setprecision(2) << batch_ms
+        << "    batch >> select (contiguous) [ms]: "    << std::fixed << std::setprecision(2) << contiguous_ms
+        << "    (" << batch_sum << ")"
+        << std::endl;
+}
@@ -0,0 +1,455 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <limits>
+#include <cstdint>
+#include <type_traits>
+
+#include <cpputils/misc/exception.h>
+#include <cpputils/container/handle_manager.h>
+
+namespace utl
+{
+
+    namespace __impl
+    {
+        using concurrent_index_type = uint32_t;
+
+        static constexpr concurrent_index_type concurrent_invalid_index(std::numeric_limits<concurrent_index_type>::max());
+
+        /* state of a concurrent entry:
+         *    0..15 reusage counter
+         *       16 used flag
+         *       17 locked flag (entry is updated at the moment) */
+        static constexpr uint32_t concurrent_state_counter_mask (0x0000FFFF);
+        static constexpr uint32_t concurrent_state_used         (0x00010000);
+        static constexpr uint32_t concurrent_state_locked       (0x00020000);
+
+        template<class T_value>
+        struct concurrent_entry
+        {
+        public:
+            using value_type = T_value;
+
+            std::atomic<uint32_t>               state;
+            std::atomic<concurrent_index_type>  next_free;
+            std::atomic<value_type>             data;
+
+            inline concurrent_entry();
+        };
+
+        /* stores entries in buckets of geometrically growing size (64, 128, 256, ...). Buckets are
+         * never moved or freed while the store is alive, so a pointer to an entry stays valid and
+         * readers can access it without any lock. */
+        template<class T_entry>
+        struct concurrent_entry_store
+        {
+        public:
+            using entry_type = T_entry;
+            using this_type  = concurrent_entry_store<entry_type>;
+
+            static constexpr size_t first_bucket_bits = 6;
+            static constexpr size_t bucket_count      = 8 * sizeof(concurrent_index_type) + 1 - first_bucket_bits;
+
+        private:
+            std::array<std::atomic<entry_type*>, bucket_count> _buckets;
+
+            static inline void locate(concurrent_index_type index, size_t& bucket, size_t& offset);
+
+        public:
+            inline entry_type* get   (concurrent_index_type index) const;
+            inline entry_type& ensure(concurrent_index_type index);
+
+            inline concurrent_entry_store();
+            inline ~concurrent_entry_store();
+
+            concurrent_entry_store(const this_type&) = delete;
+        };
+
+        template<class T_entry>
+        struct concurrent_system
+        {
+        public:
+            using entry_type = T_entry;
+            using this_type  = concurrent_system<entry_type>;
+            using store_type = concurrent_entry_store<entry_type>;
+
+        private:
+            std::atomic<uint64_t>   _free_head;     // 0..31 index of the first free entry, 32..63 ABA tag
+            std::atomic<uint64_t>   _size;          // number of entries handed out so far
+            store_type              _entries;
+
+            static inline uint64_t make_head(concurrent_index_type index, uint64_t tag);
+
+        public:
+            inline concurrent_index_type   pop_free ();
+            inline void                    push_free(concurrent_index_type index);
+            inline entry_type*             get      (concurrent_index_type index) const;
+
+            inline concurrent_system();
+
+            concurrent_system(const this_type&) = delete;
+        };
+    }
+
+    /** handle manager that can be used by multiple threads at the same time
+     *
+     *  Validation and lookup of handles are wait-free (they only check the reusage counter of the entry
+     *  and load the value atomically). insert and remove use a lock-free free list per system. The value
+     *  type must be trivially copyable and lock-free in a std::atomic (e.g. pointers or integers). */
+    template<class T>
+    class concurrent_handle_manager
+    {
+    public:
+        using value_type            = T;
+        using this_type             = concurrent_handle_manager<value_type>;
+        using entry_type            = __impl::concurrent_entry<value_type>;
+        using system_type           = __impl::concurrent_system<entry_type>;
+
+        static_assert(std::is_trivially_copyable<value_type>::value,    "value type of concurrent_handle_manager must be trivially copyable");
+        static_assert(std::atomic<value_type>::is_always_lock_free,     "value type of concurrent_handle_manager must be lock-free in std::atomic");
+
+    private:
+        std::array<std::atomic<system_type*>, std::numeric_limits<system_id_type>::max() + 1> _systems;
+
+        inline entry_type*  find_entry  (const __impl::handle_data& hd) const;
+        inline system_type& get_system  (const system_id_type& sId);
+
+    public:
+        /** check if an given handle is valid
+         *  @param handle   handle to check
+         *  @return         TRUE if handle is valid, FALSE otherwise */
+        inline bool is_valid(const handle& handle) const;
+
+        /** try to get the value for a given handle
+         *  @param handle   handle to get value for
+         *  @param value    parameter to store value at
+         *  @return         TRUE on success, FALSE otherwise */
+        inline bool try_get(const handle& handle, value_type& value) const;
+
+        /** get the value for a given handle
+         *  @param handle   handle to get value for
+         *  @return         valid stored for handle */
+        inline value_type get(const handle& handle) const;
+
+        /** update the value of a given handle (only valid handles are accepted)
+         *  @param handle   handle to update value for
+         *  @param value    new value to store
+         *  @return         TRUE on success, FALSE otherwise (invalid handle) */
+        inline bool update(const handle& handle, value_type value);
+
+        /** insert a new value to the manager
+         *  @param tId      type id of the value
+         *  @param sId      system id of the value
+         *  @param value    value to add
+         *  @return         handle of the stored value */
+        inline handle insert(const type_id_type& tId, const system_id_type& sId, value_type value);
+
+        /** remove the value of a given handle
+         *  @param handle   handle to remove value for
+         *  @return         TRUE on success, FALSE otherwise (handle is invalid) */
+        inline bool remove(const handle& handle);
+
+        inline concurrent_handle_manager();
+        inline ~concurrent_handle_manager();
+
+        concurrent_handle_manager(const this_type&) = delete;
+    };
+
+}
+
+/* CONCURRENT ENTRY ******************************************************************************/
+
+template<class T>
+inline utl::__impl::concurrent_entry<T>::concurrent_entry() :
+    state       (0),
+    next_free   (concurrent_invalid_index),
+    data        (value_type())
+    { }
+
+/* CONCURRENT ENTRY STORE ************************************************************************/
+
+template<class T>
+inline void
+utl::__impl::concurrent_entry_store<T>::locate(
+    concurrent_index_type index,
+    size_t& bucket,
+    size_t& offset)
+{
+    uint64_t v  = static_cast<uint64_t>(index) + (uint64_t(1) << first_bucket_bits);
+    size_t   hb = static_cast<size_t>(63 - __builtin_clzll(v));
+    bucket = hb - first_bucket_bits;
+    offset = static_cast<size_t>(v - (uint64_t(1) << hb));
+}
+
+template<class T>
+inline typename utl::__impl::concurrent_entry_store<T>::entry_type*
+utl::__impl::concurrent_entry_store<T>::get(
+    concurrent_index_type index) const
+{
+    size_t bucket, offset;
+    locate(index, bucket, offset);
+    auto entries = _buckets[bucket].load(std::memory_order_acquire);
+    return entries
+        ? entries + offset
+        : nullptr;
+}
+
+template<class T>
+inline typename utl::__impl::concurrent_entry_store<T>::entry_type&
+utl::__impl::concurrent_entry_store<T>::ensure(
+    concurrent_index_type index)
+{
+    size_t bucket, offset;
+    locate(index, bucket, offset);
+    auto entries = _buckets[bucket].load(std::memory_order_acquire);
+    if (!entries)
+    {
+        auto created = new entry_type[size_t(1) << (bucket + first_bucket_bits)];
+        if (_buckets[bucket].compare_exchange_strong(entries, created, std::memory_order_acq_rel, std::memory_order_acquire))
+            entries = created;
+        else
+            delete[] created;
+    }
+    return entries[offset];
+}
+
+template<class T>
+inline utl::__impl::concurrent_entry_store<T>::concurrent_entry_store()
+{
+    for (auto& b : _buckets)
+        b.store(nullptr, std::memory_order_relaxed);
+}
+
+template<class T>
+inline utl::__impl::concurrent_entry_store<T>::~concurrent_entry_store()
+{
+    for (auto& b : _buckets)
+        delete[] b.load(std::memory_order_relaxed);
+}
+
+/* CONCURRENT SYSTEM *****************************************************************************/
+
+template<class T>
+inline uint64_t
+utl::__impl::concurrent_system<T>::make_head(
+    concurrent_index_type index,
+    uint64_t tag)
+    { return (tag << 32) | index; }
+
+template<class T>
+inline utl::__impl::concurrent_index_type
+utl::__impl::concurrent_system<T>::pop_free()
+{
+    auto head = _free_head.load(std::memory_order_acquire);
+    while (true)
+    {
+        auto index = static_cast<concurrent_index_type>(head);
+        if (index == concurrent_invalid_index)
+            break;
+        auto next = _entries.get(index)->next_free.load(std::memory_order_relaxed);
+        if (_free_head.compare_exchange_weak(head, make_head(next, (head >> 32) + 1), std::memory_order_acq_rel, std::memory_order_acquire))
+            return index;
+    }
+
+    auto size = _size.fetch_add(1, std::memory_order_relaxed);
+    if (size >= concurrent_invalid_index)
+        throw exception("concurrent handle manager system is full");
+    auto index = static_cast<concurrent_index_type>(size);
+    _entries.ensure(index);
+    return index;
+}
+
+template<class T>
+inline void
+utl::__impl::concurrent_system<T>::push_free(
+    concurrent_index_type index)
+{
+    auto& entry = *_entries.get(index);
+    auto  head  = _free_head.load(std::memory_order_relaxed);
+    do
+    {
+        entry.next_free.store(static_cast<concurrent_index_type>(head), std::memory_order_relaxed);
+    }
+    while (!_free_head.compare_exchange_weak(head, make_head(index, (head >> 32) + 1), std::memory_order_release, std::memory_order_relaxed));
+}
+
+template<class T>
+inline typename utl::__impl::concurrent_system<T>::entry_type*
+utl::__impl::concurrent_system<T>::get(
+    concurrent_index_type index) const
+    { return _entries.get(index); }
+
+template<class T>
+inline utl::__impl::concurrent_system<T>::concurrent_system() :
+    _free_head  (make_head(concurrent_invalid_index, 0)),
+    _size       (0)
+    { }
+
+/* CONCURRENT HANDLE MANAGER *********************************************************************/
+
+template<class T>
+inline typename utl::concurrent_handle_manager<T>::entry_type*
+utl::concurrent_handle_manager<T>::find_entry(
+    const __impl::handle_data& hd) const
+{
+    auto system = _systems[hd.system_id].load(std::memory_order_acquire);
+    return system
+        ? system->get(hd.entry_index)
+        : nullptr;
+}
+
+template<class T>
+inline typename utl::concurrent_handle_manager<T>::system_type&
+utl::concurrent_handle_manager<T>::get_system(
+    const system_id_type& sId)
+{
+    auto system = _systems[sId].load(std::memory_order_acquire);
+    if (!system)
+    {
+        auto created = new system_type();
+        if (_systems[sId].compare_exchange_strong(system, created, std::memory_order_acq_rel, std::memory_order_acquire))
+            system = created;
+        else
+            delete created;
+    }
+    return *system;
+}
+
+template<class T>
+inline bool
+utl::concurrent_handle_manager<T>::is_valid(
+    const utl::handle& handle) const
+{
+    using namespace __impl;
+    auto hd    = make_handle_data(handle);
+    auto entry = find_entry(hd);
+    if (!entry)
+        return false;
+    auto state = entry->state.load(std::memory_order_acquire);
+    return (state & ~concurrent_state_locked) == (concurrent_state_used | hd.counter);
+}
+
+template<class T>
+inline bool
+utl::concurrent_handle_manager<T>::try_get(
+    const utl::handle& handle,
+    value_type& value) const
+{
+    using namespace __impl;
+    auto hd    = make_handle_data(handle);
+    auto entry = find_entry(hd);
+    if (!entry)
+        return false;
+    auto expected = concurrent_state_used | hd.counter;
+    auto state    = entry->state.load(std::memory_order_acquire);
+    if ((state & ~concurrent_state_locked) != expected)
+        return false;
+    auto v = entry->data.load(std::memory_order_acquire);
+    // the entry may have been removed (and reused) while we were reading the value, the fence keeps the
+    // second load of the state from being reordered before the load of the value
+    std::atomic_thread_fence(std::memory_order_acquire);
+    state = entry->state.load(std::memory_order_relaxed);
+    if ((state & ~concurrent_state_locked) != expected)
+        return false;
+    value = v;
+    return true;
+}
+
+template<class T>
+inline typename utl::concurrent_handle_manager<T>::value_type
+utl::concurrent_handle_manager<T>::get(
+    const utl::handle& handle) const
+{
+    value_type ret;
+    if (!try_get(handle, ret))
+        throw exception("invalid handle");
+    return ret;
+}
+
+template<class T>
+inline bool
+utl::concurrent_handle_manager<T>::update(
+    const utl::handle& handle,
+    value_type value)
+{
+    using namespace __impl;
+    auto hd    = make_handle_data(handle);
+    auto entry = find_entry(hd);
+    if (!entry)
+        return false;
+    auto valid    = concurrent_state_used | hd.counter;
+    auto expected = valid;
+    while (!entry->state.compare_exchange_weak(expected, valid | concurrent_state_locked, std::memory_order_acquire, std::memory_order_relaxed))
+    {
+        // entry is locked by an other update, wait until it is released
+        if ((expected & ~concurrent_state_locked) != valid)
+            return false;
+        expected = valid;
+    }
+    entry->data.store(value, std::memory_order_release);
+    entry->state.store(valid, std::memory_order_release);
+    return true;
+}
+
+template<class T>
+inline utl::handle
+utl::concurrent_handle_manager<T>::insert(
+    const type_id_type& tId,
+    const system_id_type& sId,
+    value_type value)
+{
+    using namespace __impl;
+    auto& system  = get_system(sId);
+    auto  index   = system.pop_free();
+    auto& entry   = *system.get(index);
+    auto  counter = static_cast<uint16_t>((entry.state.load(std::memory_order_relaxed) & concurrent_state_counter_mask) + 1);
+    if (counter == 0)
+        counter = 1;
+    entry.data.store(value, std::memory_order_release);
+    entry.state.store(concurrent_state_used | counter, std::memory_order_release);
+    handle_data hd;
+    hd.entry_index = index;
+    hd.counter     = counter;
+    hd.type_id     = tId;
+    hd.system_id   = sId;
+    return make_handle(hd);
+}
+
+template<class T>
+inline bool
+utl::concurrent_handle_manager<T>::remove(
+    const utl::handle& handle)
+{
+    using namespace __impl;
+    auto hd    = make_handle_data(handle);
+    auto entry = find_entry(hd);
+    if (!entry)
+        return false;
+    auto valid    = concurrent_state_used | hd.counter;
+    auto expected = valid;
+    while (!entry->state.compare_exchange_weak(expected, hd.counter, std::memory_order_acq_rel, std::memory_order_relaxed))
+    {
+        // entry is locked by an update, wait until it is released
+        if ((expected & ~concurrent_state_locked) != valid)
+            return false;
+        expected = valid;
+    }
+    _systems[hd.system_id].load(std::memory_order_relaxed)->push_free(hd.entry_index);
+    return true;
+}
+
+template<class T>
+inline utl::concurrent_handle_manager<T>::concurrent_handle_manager()
+{
+    for (auto& s : _systems)
+        s.store(nullptr, std::memory_order_relaxed);
+}
+
+template<class T>
+inline utl::concurrent_handle_manager<T>::~concurrent_handle_manager()
+{
+    for (auto& s : _systems)
+        delete s.load(std::memory_order_relaxed);
+}
@@ -0,0 +1,273 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+
+#include <cpputils/misc/exception.h>
+#include <cpputils/container/handle_manager.h>
+
+namespace utl
+{
+
+    /** stores the values of each type id in a densely packed array
+     *
+     *  A handle_manager maps the handles to the index of the value in the dense array of its type id
+     *  (sparse set), so lookups stay O(1) and iterating all values of one type id is a linear scan over
+     *  contiguous memory. Removing a value moves the last value of the type id into the free slot, so the
+     *  order of the values is not stable and pointers to values are invalidated by insert and remove. */
+    template<class T, class TLayout = aos_layout, class TEncoding = network_handle_encoding>
+    class dense_handle_pool
+    {
+    public:
+        using value_type            = T;
+        using layout_type           = TLayout;
+        using encoding_type         = TEncoding;
+        using this_type             = dense_handle_pool<value_type, layout_type, encoding_type>;
+        using index_manager_type    = handle_manager<size_t, layout_type, encoding_type>;
+
+        struct range
+        {
+            value_type* first;
+            value_type* last;
+
+            inline value_type* begin() const
+                { return first; }
+
+            inline value_type* end() const
+                { return last; }
+
+            inline size_t size() const
+                { return static_cast<size_t>(last - first); }
+        };
+
+    private:
+        struct pool
+        {
+            std::vector<value_type> values;
+            std::vector<handle>     handles;
+        };
+
+        index_manager_type  _indices;
+        std::vector<pool>   _pools;
+
+        inline pool&        get_pool(const type_id_type& tId);
+
+    public:
+        /** check if an given handle is valid
+         *  @param handle   handle to check
+         *  @return         TRUE if handle is valid, FALSE otherwise */
+        inline bool is_valid(const handle& handle) const;
+
+        /** get a pointer to the value of a given handle
+         *  @param handle   handle to get value for
+         *  @return         pointer to the stored value or nullptr if the handle is invalid */
+        inline value_type* try_get_ptr(const handle& handle);
+
+        /** get a pointer to the value of a given handle
+         *  @param handle   handle to get value for
+         *  @return         pointer to the stored value or nullptr if the handle is invalid */
+        inline const value_type* try_get_ptr(const handle& handle) const;
+
+        /** get a reference to the value of a given handle
+         *  @param handle   handle to get value for
+         *  @return         reference to the stored value (throws if the handle is invalid) */
+        inline value_type& get_ref(const handle& handle);
+
+        /** insert a new value to the dense array of the given type id
+         *  @param tId      type id of the value
+         *  @param sId      system id of the value
+         *  @param value    value to add
+         *  @return         handle of the stored value */
+        inline handle insert(const type_id_type& tId, const system_id_type& sId, value_type value);
+
+        /** insert a new value that is constructed in place at the end of the dense array of the given type id
+         *  @param tId      type id of the value
+         *  @param sId      system id of the value
+         *  @param args     arguments to pass to the constructor of the value
+         *  @return         handle of the stored value */
+        template<class... T_args>
+        inline handle emplace(const type_id_type& tId, const system_id_type& sId, T_args&&... args);
+
+        /** remove the value of a given handle (the last value of the same type id is moved to its slot)
+         *  @param handle   handle to remove value for
+         *  @return         TRUE on success, FALSE otherwise (handle is invalid) */
+        inline bool remove(const handle& handle);
+
+        /** get the number of values of the given type id
+         *  @param tId      type id to get number of values for
+         *  @return         number of values */
+        inline size_t size(const type_id_type& tId) const;
+
+        /** get the densely packed values of the given type id
+         *  @param tId      type id to get values for
+         *  @return         range of the values */
+        inline range values(const type_id_type& tId);
+
+        /** get the handles of the values of the given type id (in the same order as the values)
+         *  @param tId      type id to get handles for
+         *  @return         handles of the values */
+        inline const std::vector<handle>& handles(const type_id_type& tId);
+
+        /** call a function for each value of the given type id (in the order of the dense array)
+         *  @param tId      type id to get values for
+         *  @param func     function to call: func(const handle&, value_type&) */
+        template<class T_func>
+        inline void for_each(const type_id_type& tId, T_func&& func);
+
+        /** remove all stored values */
+        inline void clear();
+    };
+
+}
+
+/* DENSE HANDLE POOL *****************************************************************************/
+
+template<class T, class L, class E>
+inline typename utl::dense_handle_pool<T, L, E>::pool&
+utl::dense_handle_pool<T, L, E>::get_pool(
+    const type_id_type& tId)
+{
+    if (tId >= _pools.size())
+        _pools.resize(static_cast<size_t>(tId) + 1);
+    return _pools[tId];
+}
+
+template<class T, class L, class E>
+inline bool
+utl::dense_handle_pool<T, L, E>::is_valid(
+    const handle& handle) const
+    { return _indices.is_valid(handle); }
+
+template<class T, class L, class E>
+inline typename utl::dense_handle_pool<T, L, E>::value_type*
+utl::dense_handle_pool<T, L, E>::try_get_ptr(
+    const handle& handle)
+{
+    auto index = _indices.try_get_ptr(handle);
+    if (!index)
+        return nullptr;
+    return &_pools[encoding_type::decode(handle).type_id].values[*index];
+}
+
+template<class T, class L, class E>
+inline const typename utl::dense_handle_pool<T, L, E>::value_type*
+utl::dense_handle_pool<T, L, E>::try_get_ptr(
+    const handle& handle) const
+{
+    auto index = _indices.try_get_ptr(handle);
+    if (!index)
+        return nullptr;
+    return &_pools[encoding_type::decode(handle).type_id].values[*index];
+}
+
+template<class T, class L, class E>
+inline typename utl::dense_handle_pool<T, L, E>::value_type&
+utl::dense_handle_pool<T, L, E>::get_ref(
+    const handle& handle)
+{
+    auto ret = try_get_ptr(handle);
+    if (!ret)
+        throw exception("invalid handle");
+    return *ret;
+}
+
+template<class T, class L, class E>
+inline utl::handle
+utl::dense_handle_pool<T, L, E>::insert(
+    const type_id_type& tId,
+    const system_id_type& sId,
+    value_type value)
+    { return emplace(tId, sId, std::move(value)); }
+
+template<class T, class L, class E>
+template<class... T_args>
+inline utl::handle
+utl::dense_handle_pool<T, L, E>::emplace(
+    const type_id_type& tId,
+    const system_id_type& sId,
+    T_args&&... args)
+{
+    auto& pool = get_pool(tId);
+    pool.values.emplace_back(std::forward<T_args>(args)...);
+    try
+    {
+        auto ret = _indices.insert(tId, sId, pool.values.size() - 1);
+        pool.handles.push_back(ret);
+        return ret;
+    }
+    catch (...)
+    {
+        pool.values.pop_back();
+        throw;
+    }
+}
+
+template<class T, class L, class E>
+inline bool
+utl::dense_handle_pool<T, L, E>::remove(
+    const handle& handle)
+{
+    auto index = _indices.try_get_ptr(handle);
+    if (!index)
+        return false;
+    auto& pool = _pools[encoding_type::decode(handle).type_id];
+    auto  last = pool.values.size() - 1;
+    if (*index != last)
+    {
+        pool.values [*index] = std::move(pool.values [last]);
+        pool.handles[*index] = pool.handles[last];
+        _indices.get_ref(pool.handles[*index]) = *index;
+    }
+    pool.values.pop_back();
+    pool.handles.pop_back();
+    _indices.remove(handle);
+    return true;
+}
+
+template<class T, class L, class E>
+inline size_t
+utl::dense_handle_pool<T, L, E>::size(
+    const type_id_type& tId) const
+{
+    return tId < _pools.size()
+        ? _pools[tId].values.size()
+        : 0;
+}
+
+template<class T, class L, class E>
+inline typename utl::dense_handle_pool<T, L, E>::range
+utl::dense_handle_pool<T, L, E>::values(
+    const type_id_type& tId)
+{
+    auto& values = get_pool(tId).values;
+    return range {
+        values.data(),
+        values.data() + values.size(),
+    };
+}
+
+template<class T, class L, class E>
+inline const std::vector<utl::handle>&
+utl::dense_handle_pool<T, L, E>::handles(
+    const type_id_type& tId)
+    { return get_pool(tId).handles; }
+
+template<class T, class L, class E>
+template<class T_func>
+inline void
+utl::dense_handle_pool<T, L, E>::for_each(
+    const type_id_type& tId,
+    T_func&& func)
+{
+    auto& pool = get_pool(tId);
+    for (size_t i = 0; i < pool.values.size(); ++i)
+        func(pool.handles[i], pool.values[i]);
+}
+
+template<class T, class L, class E>
+inline void
+utl::dense_handle_pool<T, L, E>::clear()
+{
+    _indices.clear();
+    _pools.clear();
+}
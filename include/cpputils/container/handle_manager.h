@@ -1,12 +1,26 @@
 #pragma once
 
+#include <array>
 #include <limits>
+#include <memory>
+#include <iterator>
+#include <algorithm>
+#include <functional>
+#include <utility>
 #include <vector>
 #include <string>
 #include <cstdint>
+#include <cstring>
+#include <charconv>
+#include <exception>
+#include <system_error>
+#include <istream>
+#include <ostream>
+#include <type_traits>
 
 #include <cpputils/misc/convert.h>
 #include <cpputils/misc/exception.h>
+#include <cpputils/misc/mapped_file.h>
 #include <cpputils/container/wrapper.h>
 
 namespace utl
@@ -36,12 +50,47 @@ namespace utl
 
         inline std::string  to_string         () const;
 
+        /** number of characters of the string representation of a handle (e.g. "11-22-3344-55667788") */
+        static constexpr size_t string_size = 2 * sizeof(uint64_t) + 3;
+
+        /** write the string representation of the handle to a buffer (without allocation and null terminator)
+         *  @param first    begin of the buffer
+         *  @param last     end of the buffer (at least string_size characters are needed)
+         *  @return         end of the written characters (and std::errc::value_too_large if the buffer is too small) */
+        inline std::to_chars_result to_chars(char* first, char* last) const;
+
         inline handle();
         inline handle(const uint64_t&);
         inline handle(const handle&);
 
         static inline bool          from_string(const std::string& str, handle& handle);
         static inline const handle& empty();
+
+        /** parse a handle from a buffer (16 hex digits, dashes between the digits are ignored).
+         *  The handle is only assigned on success.
+         *  @param first    begin of the buffer
+         *  @param last     end of the buffer
+         *  @param handle   parameter to store the parsed handle at
+         *  @return         behind the last parsed character (and std::errc::invalid_argument on error) */
+        static inline std::from_chars_result from_chars(const char* first, const char* last, handle& handle);
+
+        /** write the string representation of multiple handles to a buffer
+         *  @param handles      handles to write
+         *  @param count        number of handles
+         *  @param first        begin of the buffer
+         *  @param last         end of the buffer (count * (string_size + 1) - 1 characters are needed)
+         *  @param separator    character to write between two handles
+         *  @return             end of the written characters (and std::errc::value_too_large if the buffer is too small) */
+        static inline std::to_chars_result to_chars_n(const handle* handles, size_t count, char* first, char* last, char separator = ' ');
+
+        /** parse multiple handles from a buffer
+         *  @param first        begin of the buffer
+         *  @param last         end of the buffer
+         *  @param handles      array to store parsed handles at (must have space for count handles)
+         *  @param count        number of handles to parse
+         *  @param separator    character between two handles
+         *  @return             behind the last parsed character (and std::errc::invalid_argument on error) */
+        static inline std::from_chars_result from_chars_n(const char* first, const char* last, handle* handles, size_t count, char separator = ' ');
     };
 
     using type_id_type    = uint8_t;
@@ -52,9 +101,9 @@ namespace utl
         using index_type = size_t;
 
         static constexpr index_type invalid_index(std::numeric_limits<index_type>::max());
-        static constexpr size_t     grow_size    (100);
+        static constexpr size_t     page_size    (1024);
 
-        enum class entry_status
+        enum class entry_status : uint8_t
         {
             unknown,
             used,
@@ -73,12 +122,93 @@ namespace utl
         static_assert(sizeof(handle) == sizeof(handle_data), "mismatching size of handle and handle_data");
         static_assert(sizeof(handle) == 8,                   "size of handle is not equal 64");
 
+        using counter_type = uint32_t;
+
+        /* decoded fields of a handle (independent of the encoding of the handle) */
+        struct handle_fields
+        {
+            system_id_type  system_id;
+            type_id_type    type_id;
+            counter_type    counter;
+            uint32_t        entry_index;
+        };
+
         inline handle_data make_handle_data(const handle& handle);
         inline handle      make_handle     (handle_data hd);
 
-        template<class T_entry>
+        /* reusage counter for the next value of an entry (zero is skipped, it marks entries that were never used) */
+        template<class T_encoding>
+        inline counter_type next_counter(counter_type counter);
+
+        /* encode the handle of an entry */
+        template<class T_encoding, class T_entry>
+        inline handle make_entry_handle(size_t sId, size_t index, const T_entry& entry);
+
+        /* lookup tables to convert handles to and from strings */
+        struct hex_table
+        {
+            char        digits[512];    // two upper case hex digits of each byte value
+            uint8_t     values[256];    // value of each hex digit (0xFF for all other characters)
+
+            static inline const hex_table& get();
+
+            inline constexpr hex_table();
+        };
+
+        /* binary snapshot of a handle manager:
+         *    snapshot_header
+         *    snapshot_system[system_count]
+         *    padding up to snapshot_data_offset(system_count)
+         *    for each system: the raw memory of its pages (size / page_size pages of page_bytes bytes)
+         * The pages are written as they are stored in memory, so a snapshot can only be read by a manager
+         * with the same value type, layout and byte order. The pages start at an offset that is aligned
+         * to snapshot_alignment, so they can be used in place from a mapped snapshot file. */
+        static constexpr uint64_t   snapshot_magic      (0x504E534D484C5455ull);   // "UTLHMSNP"
+        static constexpr uint32_t   snapshot_version    (2);
+        static constexpr uint32_t   snapshot_byte_order (0x01020304);
+        static constexpr size_t     snapshot_alignment  (4096);
+
+        #pragma pack(push, 1)
+        struct snapshot_header
+        {
+            uint64_t        magic;
+            uint32_t        version;
+            uint32_t        byte_order;     // snapshot_byte_order in the byte order of the writer
+            uint32_t        layout;         // snapshot_layout of the entry store
+            uint32_t        page_size;      // number of entries of a page
+            uint64_t        page_bytes;     // size of a page in bytes
+            uint32_t        value_size;
+            uint32_t        index_size;
+            uint64_t        system_count;
+        };
+
+        struct snapshot_system
+        {
+            uint64_t        size;
+            uint64_t        first_free;
+            uint64_t        last_free;
+            uint64_t        first_used;
+            uint64_t        last_used;
+            uint64_t        free_count;
+            uint64_t        used_count;
+        };
+
+        #pragma pack(pop)
+
+        /* offset of the first page of a snapshot with the given number of systems */
+        inline size_t snapshot_data_offset(size_t system_count);
+
+        template<class T_store, class T_recycling>
         struct system;
 
+        /* reusage counter, status and type id of an entry */
+        struct entry_meta
+        {
+            counter_type    counter;
+            entry_status    status;
+            type_id_type    type_id;
+        };
+
         template<class T_value>
         struct entry
         {
@@ -90,43 +220,235 @@ namespace utl
         private:
             index_type      _next;
             index_type      _prev;
-            uint16_t        _counter;
-            entry_status    _status;
-            type_id_type    _type_id;
+            entry_meta      _meta;
             wrapper_type    _data;
 
         public:
-            inline index_type   next    () const;
-            inline void         next    (index_type value);
-            inline index_type   prev    () const;
-            inline void         prev    (index_type value);
-            inline entry_status status  () const;
-            inline void         link    (index_type prev, index_type next, entry_status status);
-            inline void         unlink  ();
-            inline uint16_t     counter () const;
-            inline void         assign  (value_type value, const type_id_type& tId, const uint16_t cntr = 0);
-            inline value_type   data    ();
-            inline void         data    (value_type v);
+            inline index_type          next    () const;
+            inline void                next    (index_type value);
+            inline index_type          prev    () const;
+            inline void                prev    (index_type value);
+            inline entry_status        status  () const;
+            inline void                link    (index_type prev, index_type next, entry_status status);
+            inline void                unlink  ();
+            inline counter_type        counter () const;
+            inline type_id_type        type_id () const;
+            inline const entry_meta&   meta    () const;
+            inline void                assign  (value_type value, const type_id_type& tId, const counter_type cntr);
+            template<class... T_args>
+            inline void                emplace (const type_id_type& tId, const counter_type cntr, T_args&&... args);
+            inline value_type&         data    ();
+            inline const value_type&   data    () const;
+            inline void                data    (value_type v);
+            inline void                reset   ();
 
             inline entry();
             inline entry(entry&&);
             inline entry(const entry&);
         };
 
+        /* pointers to the pages of an entry store. A page is either owned by the vector or borrowed from
+         * external memory (e.g. a mapped snapshot), which has to outlive the vector. Copying the vector
+         * copies all pages, so the copy only has owned pages. */
+        template<class T_page>
+        struct page_vector
+        {
+        public:
+            using page_type = T_page;
+            using this_type = page_vector<page_type>;
+
+        private:
+            struct page_ref
+            {
+                page_type*  page;
+                bool        owned;
+            };
+
+            std::vector<page_ref> _pages;
+
+        public:
+            inline size_t           size            () const;
+            inline size_t           bytes           () const;
+            inline page_type&       emplace_back    ();
+            inline void             attach          (void* data);
+            inline void             pop_back        ();
+            inline void             shrink_to_fit   ();
+            inline const page_type& at              (size_t index) const;
+
+            inline page_type&       operator[]      (size_t index);
+            inline const page_type& operator[]      (size_t index) const;
+
+            inline page_vector();
+            inline page_vector(page_vector&&);
+            inline page_vector(const page_vector&);
+            inline ~page_vector();
+        };
+
+        /* stores entries in pages of page_size entries; pages are never resized, so growing
+         * never moves existing entries and references to them stay valid */
         template<class T_entry>
-        struct system
+        struct entry_pages
         {
         public:
             using entry_type        = T_entry;
-            using this_type         = system<entry_type>;
-            using entry_vector_type = std::vector<entry_type>;
+            using this_type         = entry_pages<entry_type>;
+            using reference         = entry_type&;
+            using const_reference   = const entry_type&;
+            using page_type         = std::array<entry_type, page_size>;
+            using page_vector_type  = page_vector<page_type>;
+
+            static constexpr uint32_t snapshot_layout = 1;
+            static constexpr size_t   page_bytes      = sizeof(page_type);
+
+        private:
+            page_vector_type _pages;
+
+        public:
+            inline size_t           size        () const;
+            inline void             resize      (size_t size);
+            inline void             shrink      (size_t size);
+            inline size_t           bytes       () const;
+            inline const_reference  at          (const index_type& index) const;
+
+            /* raw memory of a page (used to write snapshots) */
+            inline const void*      page_data   (size_t page) const;
+
+            /* append an owned page and return its raw memory (used to read snapshots) */
+            inline void*            append      ();
+
+            /* append a page that is stored in external memory (e.g. a mapped snapshot) */
+            inline void             attach      (void* data);
+
+            inline reference        operator[]  (const index_type& index);
+            inline const_reference  operator[]  (const index_type& index) const;
+
+            inline entry_pages();
+            inline entry_pages(entry_pages&&);
+            inline entry_pages(const entry_pages&);
+        };
+
+        /* page of the structure-of-arrays layout: counter, status and type id of all entries are
+         * stored in one dense array, separated from the list links and the values */
+        template<class T_value>
+        struct soa_entry_page
+        {
+        public:
+            using value_type   = T_value;
+            using this_type    = soa_entry_page<value_type>;
+            using wrapper_type = wrapper<value_type>;
+            using meta_type    = entry_meta;
+
+            struct link_type
+            {
+                index_type      next;
+                index_type      prev;
+            };
+
+            meta_type       meta    [page_size];
+            link_type       links   [page_size];
+            wrapper_type    values  [page_size];
+
+            inline soa_entry_page();
+        };
+
+        /* reference to a single entry inside a soa_entry_page (provides the same interface as entry) */
+        template<class T_page>
+        struct soa_entry_ref
+        {
+        public:
+            using page_type    = T_page;
+            using value_type   = typename std::remove_const<page_type>::type::value_type;
+            using this_type    = soa_entry_ref<page_type>;
+
+        private:
+            page_type*  _page;
+            size_t      _offset;
+
+        public:
+            inline index_type   next    () const;
+            inline void         next    (index_type value) const;
+            inline index_type   prev    () const;
+            inline void         prev    (index_type value) const;
+            inline entry_status status  () const;
+            inline void         link    (index_type prev, index_type next, entry_status status) const;
+            inline void         unlink  () const;
+            inline counter_type counter () const;
+            inline type_id_type type_id () const;
+            inline const auto&  meta    () const;
+            inline void         assign  (value_type value, const type_id_type& tId, const counter_type cntr) const;
+            template<class... T_args>
+            inline void         emplace (const type_id_type& tId, const counter_type cntr, T_args&&... args) const;
+            inline auto&        data    () const;
+            inline void         data    (value_type v) const;
+            inline void         reset   () const;
+
+            inline soa_entry_ref(page_type& page, size_t offset);
+        };
+
+        /* stores entries in pages of the structure-of-arrays layout */
+        template<class T_value>
+        struct soa_entry_pages
+        {
+        public:
+            using value_type        = T_value;
+            using this_type         = soa_entry_pages<value_type>;
+            using page_type         = soa_entry_page<value_type>;
+            using reference         = soa_entry_ref<page_type>;
+            using const_reference   = soa_entry_ref<const page_type>;
+            using page_vector_type  = page_vector<page_type>;
+
+            static constexpr uint32_t snapshot_layout = 2;
+            static constexpr size_t   page_bytes      = sizeof(page_type);
+
+        private:
+            page_vector_type _pages;
+
+        public:
+            inline size_t           size        () const;
+            inline void             resize      (size_t size);
+            inline void             shrink      (size_t size);
+            inline size_t           bytes       () const;
+            inline const_reference  at          (const index_type& index) const;
+
+            /* raw memory of a page (used to write snapshots) */
+            inline const void*      page_data   (size_t page) const;
+
+            /* append an owned page and return its raw memory (used to read snapshots) */
+            inline void*            append      ();
+
+            /* append a page that is stored in external memory (e.g. a mapped snapshot) */
+            inline void             attach      (void* data);
+
+            inline reference        operator[]  (const index_type& index);
+            inline const_reference  operator[]  (const index_type& index) const;
+
+            inline soa_entry_pages();
+            inline soa_entry_pages(soa_entry_pages&&);
+            inline soa_entry_pages(const soa_entry_pages&);
+        };
+
+        template<class T_store, class T_recycling>
+        struct system
+        {
+        public:
+            using store_type        = T_store;
+            using recycling_type    = T_recycling;
+            using this_type         = system<store_type, recycling_type>;
+            using entry_vector_type = store_type;
+            using reference         = typename store_type::reference;
+            using const_reference   = typename store_type::const_reference;
 
         private:
             index_type          _firstFree;
             index_type          _lastFree;
             index_type          _firstUsed;
             index_type          _lastUsed;
+            size_t              _freeCount;
+            size_t              _usedCount;
+            size_t              _limit;
+            double              _growthFactor;
             entry_vector_type   _entries;
+            recycling_type      _recycling;
 
             inline void         pushFront       (index_type index, index_type& first, index_type& last, entry_status status);
             inline void         pushBack        (index_type index, index_type& first, index_type& last, entry_status status);
@@ -146,33 +468,91 @@ namespace utl
             inline index_type   popBackUsed     ();
             inline void         removeFree      (index_type index);
             inline void         removeUsed      (index_type index);
+            inline void         takeFree        (index_type index);
+            inline void         reserveFree     (size_t count);
+            inline void         reserve         (size_t size);
+            inline void         shrinkToFit     ();
+            inline void         growthFactor    (double factor);
+            inline size_t       bytes           () const;
             inline size_t       size            () const;
+            inline size_t       freeCount       () const;
+            inline size_t       usedCount       () const;
+
+            /* move the first count entries of the free list to the end of the used list (as one run)
+             * and call func(index) for each of the moved entries */
+            template<class T_func>
+            inline void         moveFreeToUsed  (size_t count, T_func&& func);
+
+            /* take a free entry as selected by the recycling policy (the entry is removed from the free list) */
+            inline index_type   acquire         ();
 
-            inline entry_type&          operator[]  (const index_type& index);
-            inline const entry_type&    operator[]  (const index_type& index) const;
+            /* return an unlinked entry to the free list as selected by the recycling policy */
+            inline void         release         (index_type index);
 
-            inline system();
+            /* move count free entries as selected by the recycling policy to the end of the used list
+             * and call func(index) for each of the moved entries */
+            template<class T_func>
+            inline void         acquireN        (size_t count, T_func&& func);
+
+            /* call func(index) for each entry of the free list */
+            template<class T_func>
+            inline void         forEachFree     (T_func&& func) const;
+
+            /* rebuild the state of the recycling policy from the free list (after the lists were rebuilt) */
+            inline void         resetRecycling  ();
+
+            /* move all used entries to the lowest indices (calls func(from, to) for each moved entry after
+             * the target entry has been marked as used) and rebuild the free and the used list in index order */
+            template<class T_func>
+            inline void         compact         (T_func&& func);
+
+            /* list heads and counters of the system (used to write snapshots) */
+            inline snapshot_system  state       () const;
+
+            /* replace the list heads and counters of the (empty) system (the pages have to be appended,
+             * verified and the recycling policy has to be reset by the caller) */
+            inline void             restore     (const snapshot_system& state);
+
+            /* check that the list heads, the links and the counters of a restored system are consistent
+             * (throws if they are not, so a corrupt snapshot never indexes out of bounds) */
+            inline void             verify      () const;
+
+            /* entry store of the system (used to write and read snapshots) */
+            inline entry_vector_type&       entries ();
+            inline const entry_vector_type& entries () const;
+
+            inline reference            operator[]  (const index_type& index);
+            inline const_reference      operator[]  (const index_type& index) const;
+
+            inline system(size_t limit = invalid_index, double growthFactor = 1.0);
             inline system(system&&);
             inline system(const system&&);
         };
 
-        template<class T_entry>
+        template<class T_store, class T_recycling>
         struct systems
         {
         public:
-            using entry_type            = T_entry;
-            using this_type             = system<entry_type>;
-            using system_type           = system<entry_type>;
+            using store_type            = T_store;
+            using recycling_type        = T_recycling;
+            using this_type             = systems<store_type, recycling_type>;
+            using system_type           = system<store_type, recycling_type>;
             using system_vector_type    = std::vector<system_type>;
 
         private:
-            system_vector_type _systems;
+            system_vector_type  _systems;
+            size_t              _limit;
+            double              _growthFactor;
 
         public:
             inline system_type&         operator[]  (const index_type& index);
             inline const system_type&   operator[]  (const index_type& index) const;
-            inline size_t            size        () const;
+            inline size_t               size        () const;
             inline void                 clear       ();
+            inline void                 growthFactor(double factor);
+            inline double               growthFactor() const;
+
+            inline systems(size_t limit = invalid_index);
         };
     }
 
@@ -182,17 +562,237 @@ namespace utl
     inline system_id_type get_system_id(const handle& handle)
         { return __impl::make_handle_data(handle).system_id; }
 
-    template<class T>
+    /** handles store their fields in network byte order, so the in-memory representation of a handle is
+     *  the same on every platform (default encoding, compatible with get_type_id/get_system_id) */
+    struct network_handle_encoding
+    {
+        static constexpr __impl::counter_type counter_mask = std::numeric_limits<uint16_t>::max();
+        static constexpr size_t               max_index    = std::numeric_limits<uint32_t>::max();
+
+        static inline __impl::handle_fields decode          (const handle& handle);
+        static inline handle                encode          (const __impl::handle_fields& hf);
+        static inline handle                to_network      (const handle& handle);
+        static inline handle                from_network    (const handle& handle);
+        static inline std::string           to_string       (const handle& handle);
+        static inline bool                  from_string     (const std::string& str, handle& handle);
+    };
+
+    /** handles store their fields in native byte order with a configurable number of bits per field
+     *  (from the highest to the lowest bits: system id, type id, reusage counter, entry index), so decoding
+     *  a handle only needs shifts and masks. Handles of this encoding are only meaningful inside the process,
+     *  use to_network/from_network or to_string/from_string to serialize them.
+     *  @tparam SystemBits  number of bits of the system id (0..8)
+     *  @tparam TypeBits    number of bits of the type id (0..8)
+     *  @tparam CounterBits number of bits of the reusage counter (1..32)
+     *  @tparam IndexBits   number of bits of the entry index (1..32) */
+    template<size_t SystemBits, size_t TypeBits, size_t CounterBits, size_t IndexBits>
+    struct handle_layout
+    {
+        static_assert(SystemBits + TypeBits + CounterBits + IndexBits == 64, "handle layout must use exactly 64 bits");
+        static_assert(SystemBits <= 8 * sizeof(system_id_type),             "system id bits exceed system_id_type");
+        static_assert(TypeBits   <= 8 * sizeof(type_id_type),               "type id bits exceed type_id_type");
+        static_assert(CounterBits >= 1 && CounterBits <= 32,                "counter bits must be in range 1..32");
+        static_assert(IndexBits   >= 1 && IndexBits   <= 32,                "index bits must be in range 1..32");
+
+        static constexpr size_t index_shift   = 0;
+        static constexpr size_t counter_shift = index_shift   + IndexBits;
+        static constexpr size_t type_shift    = counter_shift + CounterBits;
+        static constexpr size_t system_shift  = type_shift    + TypeBits;
+
+        static constexpr uint64_t mask(size_t bits)
+            { return bits == 0 ? 0 : (~uint64_t(0) >> (64 - bits)); }
+
+        static constexpr __impl::counter_type counter_mask = static_cast<__impl::counter_type>(mask(CounterBits));
+        static constexpr size_t               max_index    = static_cast<size_t>(mask(IndexBits));
+
+        static inline __impl::handle_fields decode          (const handle& handle);
+        static inline handle                encode          (const __impl::handle_fields& hf);
+        static inline handle                to_network      (const handle& handle);
+        static inline handle                from_network    (const handle& handle);
+        static inline std::string           to_string       (const handle& handle);
+        static inline bool                  from_string     (const std::string& str, handle& handle);
+    };
+
+    /** native handle encoding with the same field sizes as the network encoding */
+    using native_handle_encoding = handle_layout<8, 8, 16, 32>;
+
+    /** store the entries of the handle manager as array of structures
+     *  (links, counter, status, type id and value of an entry are stored together) */
+    struct aos_layout
+    {
+        template<class T>
+        using store_type = __impl::entry_pages<__impl::entry<T>>;
+    };
+
+    /** store the entries of the handle manager as structure of arrays
+     *  (counter, status and type id are stored in a dense array, separated from the links and the values) */
+    struct soa_layout
+    {
+        template<class T>
+        using store_type = __impl::soa_entry_pages<T>;
+    };
+
+    /** reuse the most recently freed entry first (default, keeps the hot entries in the cache)
+     *
+     *  Recycling policies select the free entries that are reused by insert. Besides acquire and release
+     *  the system notifies the policy about all other changes of the free list: added(first, last) after
+     *  growing appended the free entries [first, last), taken(index) after set() used a free entry,
+     *  truncated(size) after shrink_to_fit removed all entries from size on and reset(system) after the
+     *  free list was rebuilt (compact, restore). */
+    struct lifo_recycling
+    {
+        template<class T_system>
+        inline __impl::index_type   acquire     (T_system& system);
+
+        template<class T_system>
+        inline void                 release     (T_system& system, __impl::index_type index);
+
+        template<class T_system, class T_func>
+        inline void                 acquire_n   (T_system& system, size_t count, T_func&& func);
+
+        inline void                 added       (__impl::index_type first, __impl::index_type last);
+
+        inline void                 taken       (__impl::index_type index);
+
+        inline void                 truncated   (size_t size);
+
+        template<class T_system>
+        inline void                 reset       (T_system& system);
+    };
+
+    /** reuse the least recently freed entry first. A freed entry is not reused before at least Quarantine
+     *  other entries have been freed (or allocated) after it, so the reusage counter of a single entry
+     *  wraps around much later if values are inserted and removed at a high rate.
+     *  @tparam Quarantine  minimum number of free entries queued in front of a freed entry */
+    template<size_t Quarantine = __impl::page_size>
+    struct fifo_recycling
+    {
+        static constexpr size_t quarantine = Quarantine;
+
+        template<class T_system>
+        inline __impl::index_type   acquire     (T_system& system);
+
+        template<class T_system>
+        inline void                 release     (T_system& system, __impl::index_type index);
+
+        template<class T_system, class T_func>
+        inline void                 acquire_n   (T_system& system, size_t count, T_func&& func);
+
+        inline void                 added       (__impl::index_type first, __impl::index_type last);
+
+        inline void                 taken       (__impl::index_type index);
+
+        inline void                 truncated   (size_t size);
+
+        template<class T_system>
+        inline void                 reset       (T_system& system);
+    };
+
+    /** reuse the free entry with the lowest index first, so the used entries stay packed at the
+     *  front of the storage. All free indices are kept in a min heap, set() on a free entry and
+     *  shrink_to_fit are linear in the number of free entries. */
+    struct lowest_index_recycling
+    {
+    private:
+        std::vector<__impl::index_type> _heap;
+
+    public:
+        template<class T_system>
+        inline __impl::index_type   acquire     (T_system& system);
+
+        template<class T_system>
+        inline void                 release     (T_system& system, __impl::index_type index);
+
+        template<class T_system, class T_func>
+        inline void                 acquire_n   (T_system& system, size_t count, T_func&& func);
+
+        inline void                 added       (__impl::index_type first, __impl::index_type last);
+
+        inline void                 taken       (__impl::index_type index);
+
+        inline void                 truncated   (size_t size);
+
+        template<class T_system>
+        inline void                 reset       (T_system& system);
+    };
+
+    template<class T, class TLayout = aos_layout, class TEncoding = network_handle_encoding, class TRecycling = lifo_recycling>
     class handle_manager
     {
     public:
         using value_type            = T;
-        using this_type             = handle_manager<value_type>;
-        using entry_type            = __impl::entry<value_type>;
-        using systems_type          = __impl::systems<entry_type>;
+        using layout_type           = TLayout;
+        using encoding_type         = TEncoding;
+        using recycling_type        = TRecycling;
+        using this_type             = handle_manager<value_type, layout_type, encoding_type, recycling_type>;
+        using store_type            = typename layout_type::template store_type<value_type>;
+        using systems_type          = __impl::systems<store_type, recycling_type>;
+        using remap_type            = std::vector<std::pair<handle, handle>>;
+
+        /** memory statistics of one system */
+        struct memory_stats_type
+        {
+            size_t capacity;    //!< number of allocated entries
+            size_t live;        //!< number of used entries
+            size_t free;        //!< number of free entries
+            size_t bytes;       //!< number of allocated bytes
+        };
+
+        /** iterates over all used entries of the manager (in memory order) */
+        class iterator
+        {
+        public:
+            using iterator_category = std::forward_iterator_tag;
+            using value_type        = std::pair<handle, typename handle_manager::value_type&>;
+            using difference_type   = std::ptrdiff_t;
+            using pointer           = void;
+            using reference         = value_type;
+
+        private:
+            systems_type*   _systems;
+            size_t          _system;
+            size_t          _system_end;
+            size_t          _index;
+            bool            _filter_type;
+            type_id_type    _type_id;
+
+            inline void skip();
+
+        public:
+            inline reference    operator*   () const;
+            inline iterator&    operator++  ();
+            inline iterator     operator++  (int);
+            inline bool         operator==  (const iterator& other) const;
+            inline bool         operator!=  (const iterator& other) const;
+
+            inline iterator(systems_type& systems, size_t system, size_t system_end, bool filter_type, type_id_type tId);
+        };
+
+        struct range
+        {
+            iterator first;
+            iterator last;
+
+            inline iterator begin() const
+                { return first; }
+
+            inline iterator end() const
+                { return last; }
+        };
 
     private:
-        systems_type _systems;
+        systems_type                    _systems;
+        std::shared_ptr<mapped_file>    _snapshot;      // mapped snapshot the pages of the systems may be stored in
+
+        template<class T_entry>
+        static inline handle make_entry_handle(size_t sId, size_t index, const T_entry& entry);
+
+        static inline __impl::counter_type next_counter(__impl::counter_type counter);
+
+        /* restore a snapshot using read(void* dst, size_t size) to read the header of the snapshot and
+         * read_page(store_type& entries) to append the next page of the snapshot to the given entries */
+        template<class T_read, class T_read_page>
+        inline void restore(T_read&& read, T_read_page&& read_page);
 
     public:
         /** check if an given handle is valid
@@ -211,9 +811,29 @@ namespace utl
          *  @return         valid stored for handle */
         inline value_type get(const handle& handle);
 
+        /** get a pointer to the value of a given handle (the value is not copied)
+         *  @param handle   handle to get value for
+         *  @return         pointer to the stored value or nullptr if the handle is invalid */
+        inline value_type* try_get_ptr(const handle& handle);
+
+        /** get a pointer to the value of a given handle (the value is not copied)
+         *  @param handle   handle to get value for
+         *  @return         pointer to the stored value or nullptr if the handle is invalid */
+        inline const value_type* try_get_ptr(const handle& handle) const;
+
+        /** get a reference to the value of a given handle (the value is not copied)
+         *  @param handle   handle to get value for
+         *  @return         reference to the stored value (throws if the handle is invalid) */
+        inline value_type& get_ref(const handle& handle);
+
+        /** get a reference to the value of a given handle (the value is not copied)
+         *  @param handle   handle to get value for
+         *  @return         reference to the stored value (throws if the handle is invalid) */
+        inline const value_type& get_ref(const handle& handle) const;
+
         /** update the value of a given handle (only valid handles are accepted)
          *  @param handle   handle to update value for
-         *  @param value    new value to store
+         *  @param value    new value to store (is moved into the manager)
          *  @return         TRUE on success, FALSE otherwise (invalid handle) */
         inline bool update(const handle& handle, value_type value);
 
@@ -230,11 +850,48 @@ namespace utl
          *  @return         handle of the stored value */
         inline handle insert(const type_id_type& tId, const system_id_type& sId, value_type value);
 
-        /** remove the value of a given handle
+        /** insert a new value to the manager that is constructed in place from the given arguments
+         *  (the value type does not need to be copyable or movable). If the constructor throws,
+         *  the manager is left unchanged
+         *  @param tId      type id of the value
+         *  @param sId      system id of the value
+         *  @param args     arguments to pass to the constructor of the value
+         *  @return         handle of the stored value */
+        template<class... T_args>
+        inline handle emplace(const type_id_type& tId, const system_id_type& sId, T_args&&... args);
+
+        /** remove the value of a given handle (the stored value is replaced by a default constructed one,
+         *  so the resources held by the value are released immediately)
          *  @param handle   handle to remove value for
          *  @return         TRUE on success, FALSE otherwise (handle is invalid) */
         inline bool remove(const handle& handle);
 
+        /** insert multiple values to the manager (the needed entries are reserved at once)
+         *  @param tId      type id of the values
+         *  @param sId      system id of the values
+         *  @param values   iterator to the values to add (the values are copied, pass a std::move_iterator to
+         *                  move them into the manager)
+         *  @param count    number of values to add
+         *  @param handles  array to store the handles of the added values at (must have space for count handles)
+         *  If copying a value throws, all entries reserved by this call are released again and the exception is
+         *  rethrown (no value is added to the manager). */
+        template<class T_iterator>
+        inline void insert_n(const type_id_type& tId, const system_id_type& sId, T_iterator values, size_t count, handle* handles);
+
+        /** remove the values of multiple handles
+         *  @param handles  handles to remove values for
+         *  @param count    number of handles
+         *  @return         number of removed values (invalid handles are skipped) */
+        inline size_t remove_n(const handle* handles, size_t count);
+
+        /** try to get the values for multiple handles
+         *  @param handles  handles to get values for
+         *  @param count    number of handles
+         *  @param values   array to store values at (values of invalid handles are not touched)
+         *  @param valid    optional array to store the validity of each handle at
+         *  @return         number of valid handles */
+        inline size_t try_get_n(const handle* handles, size_t count, value_type* values, bool* valid = nullptr) const;
+
         /** access values by a given handle
          *  @param handle   handle to get value for
          *  @return         reference to the value */
@@ -242,6 +899,84 @@ namespace utl
 
         /** remove all stored valus and reset the handle manager completely */
         inline void clear();
+
+        /** allocate the entries of a system in advance
+         *  @param sId      system id to allocate entries for
+         *  @param size     number of entries the system should be able to store without growing */
+        inline void reserve(const system_id_type& sId, size_t size);
+
+        /** set the factor the number of entries of a system is multiplied with when the system grows
+         *  (a system grows at least by one page, the default factor of 1.0 grows by exactly one page)
+         *  @param factor   growth factor to use for all systems */
+        inline void growth_factor(double factor);
+
+        /** release the pages at the end of each system that only contain free entries
+         *  (use compact() before to move all used entries to the front) */
+        inline void shrink_to_fit();
+
+        /** get the memory usage of each system
+         *  @return         memory statistics (indexed by system id) */
+        inline std::vector<memory_stats_type> memory_stats() const;
+
+        /** move all used entries of each system to the lowest indices of the system. The moved values get
+         *  new handles, the old handles become invalid.
+         *  @return         pairs of old and new handle of each moved value */
+        inline remap_type compact();
+
+        /** write a binary snapshot of the manager to the given stream: the list heads and counters of all
+         *  systems and the raw memory of their entry pages (value_type must be trivially copyable). The
+         *  snapshot can only be read by a manager with the same value type, layout and byte order.
+         *  @param os       stream to write snapshot to */
+        inline void serialize(std::ostream& os) const;
+
+        /** replace the content of the manager with a snapshot read from the given stream. All handles
+         *  that were valid when the snapshot was written are valid again. The snapshot is verified before
+         *  the content is replaced, so the manager is not changed if the snapshot is invalid.
+         *  @param is       stream to read snapshot from */
+        inline void deserialize(std::istream& is);
+
+        /** replace the content of the manager with a snapshot stored in memory (the pages are copied)
+         *  @param data     pointer to the snapshot data
+         *  @param size     size of the snapshot data in bytes */
+        inline void deserialize(const void* data, size_t size);
+
+        /** replace the content of the manager with a snapshot file that is mapped into memory. The pages of
+         *  the snapshot are used in place, so restoring only reads the file once to verify the lists. The
+         *  mapping is copy-on-write: modified pages are copied by the operating system and the file is never
+         *  changed. The mapping is released by clear() or when the next snapshot is restored.
+         *  @param filename name of the snapshot file */
+        inline void map_snapshot(const std::string& filename);
+
+        inline handle_manager();
+
+        /** get an iterator to the first used entry of all systems */
+        inline iterator begin();
+
+        /** get an iterator behind the last used entry of all systems */
+        inline iterator end();
+
+        /** get a range of all used entries of the given system
+         *  @param sId      system id to get entries for
+         *  @return         range of used entries */
+        inline range system_values(const system_id_type& sId);
+
+        /** get a range of all used entries with the given type id (of all systems)
+         *  @param tId      type id to get entries for
+         *  @return         range of used entries */
+        inline range type_values(const type_id_type& tId);
+
+        /** call a function for each used entry (in memory order)
+         *  @param func     function to call: func(const handle&, value_type&) */
+        template<class T_func>
+        inline void for_each(T_func&& func);
+
+        /** call a function for each used entry of one chunk of the manager (in memory order). The entries
+         *  are split into chunk_count chunks of equal size, so each chunk can be processed by a separate thread.
+         *  @param chunk_index  index of the chunk to process
+         *  @param chunk_count  number of chunks
+         *  @param func         function to call: func(const handle&, value_type&) */
+        template<class T_func>
+        inline void for_each(size_t chunk_index, size_t chunk_count, T_func&& func);
     };
 }
 
@@ -320,23 +1055,30 @@ utl::handle::operator >(const uint64_t& other) const
 inline std::string
 utl::handle::to_string() const
 {
-    char buffer[2*sizeof(*this)+3];
-    memset(&buffer[0], 0, sizeof(buffer));
-    const uint8_t *p = reinterpret_cast<const uint8_t*>(this);
-    size_t x = 0;
-    for (size_t i = 0; i < sizeof(*this); ++i)
-    {
-        if (i == 1 || i == 2 || i == 4)
-        {
-            buffer[2*i+x] = '-';
-            ++x;
-        }
-        buffer[2*i+x]   = static_cast<char>((p[i] >> 4) & 0x0F);
-        buffer[2*i+x+1] = static_cast<char>((p[i] >> 0) & 0x0F);
-        buffer[2*i+x]   = static_cast<char>(buffer[2*i+x]   + (buffer[2*i+x]   > 9 ? 'A' - 10 : '0'));
-        buffer[2*i+x+1] = static_cast<char>(buffer[2*i+x+1] + (buffer[2*i+x+1] > 9 ? 'A' - 10 : '0'));
-    }
-    return std::string(&buffer[0], sizeof(buffer));
+    char buffer[string_size];
+    to_chars(&buffer[0], &buffer[0] + string_size);
+    return std::string(&buffer[0], string_size);
+}
+
+inline std::to_chars_result
+utl::handle::to_chars(char* first, char* last) const
+{
+    if (last - first < static_cast<std::ptrdiff_t>(string_size))
+        return { last, std::errc::value_too_large };
+    auto&   table = __impl::hex_table::get();
+    auto    p     = reinterpret_cast<const uint8_t*>(this);
+    memcpy(first +  0, &table.digits[2*p[0]], 2);
+    first[2] = '-';
+    memcpy(first +  3, &table.digits[2*p[1]], 2);
+    first[5] = '-';
+    memcpy(first +  6, &table.digits[2*p[2]], 2);
+    memcpy(first +  8, &table.digits[2*p[3]], 2);
+    first[10] = '-';
+    memcpy(first + 11, &table.digits[2*p[4]], 2);
+    memcpy(first + 13, &table.digits[2*p[5]], 2);
+    memcpy(first + 15, &table.digits[2*p[6]], 2);
+    memcpy(first + 17, &table.digits[2*p[7]], 2);
+    return { first + string_size, std::errc() };
 }
 
 inline utl::handle::handle() :
@@ -354,32 +1096,105 @@ inline utl::handle::handle(const handle& other) :
 inline bool
 utl::handle::from_string(const std::string& str, handle& handle)
 {
-    handle = utl::handle();
-    const char *c = str.c_str();
-    const char *e = c + str.size();
-    uint8_t* p = reinterpret_cast<uint8_t*>(&handle);
+    auto first = str.data();
+    auto last  = first + str.size();
+    auto ret   = from_chars(first, last, handle);
+    if (ret.ec != std::errc() || ret.ptr != last)
+    {
+        handle = utl::handle();
+        return false;
+    }
+    return true;
+}
+
+inline std::from_chars_result
+utl::handle::from_chars(const char* first, const char* last, handle& handle)
+{
+    auto& table = __impl::hex_table::get();
+    uint8_t buffer[sizeof(uint64_t)];
+
+    /* fast path: canonical format "11-22-3344-55667788" */
+    if (    last - first >= static_cast<std::ptrdiff_t>(string_size)
+        &&  first[2]  == '-'
+        &&  first[5]  == '-'
+        &&  first[10] == '-')
+    {
+        static constexpr uint8_t offsets[sizeof(uint64_t)] = { 0, 3, 6, 8, 11, 13, 15, 17 };
+        uint8_t invalid = 0;
+        for (size_t i = 0; i < sizeof(uint64_t); ++i)
+        {
+            auto hi = table.values[static_cast<uint8_t>(first[offsets[i]])];
+            auto lo = table.values[static_cast<uint8_t>(first[offsets[i] + 1])];
+            invalid   = static_cast<uint8_t>(invalid | hi | lo);
+            buffer[i] = static_cast<uint8_t>((hi << 4) | lo);
+        }
+        if ((invalid & 0xF0) == 0)
+        {
+            memcpy(&handle.value, &buffer[0], sizeof(buffer));
+            return { first + string_size, std::errc() };
+        }
+    }
+
+    /* slow path: any number of dashes between the digits */
     size_t i = 0;
-    while(c < e && i < 2*sizeof(handle))
+    auto   c = first;
+    while (c < last && i < 2*sizeof(buffer))
     {
         if (*c != '-')
         {
-            uint8_t v;
-            if (*c >= '0' && *c <= '9')
-                v = static_cast<uint8_t>(*c - '0');
-            else if (*c >= 'a' && *c <= 'f')
-                v = static_cast<uint8_t>(*c - 'a');
-            else if (*c >= 'A' && *c <= 'F')
-                v = static_cast<uint8_t>(*c - 'A');
+            auto v = table.values[static_cast<uint8_t>(*c)];
+            if (v > 0x0F)
+                return { c, std::errc::invalid_argument };
+            if ((i & 1) == 0)
+                buffer[i >> 1] = static_cast<uint8_t>(v << 4);
             else
-                return false;
-            if (i & 1)
-                v = static_cast<uint8_t>(v << 4);
-            p[i >> 1] |= v;
+                buffer[i >> 1] = static_cast<uint8_t>(buffer[i >> 1] | v);
             ++i;
         }
         ++c;
     }
-    return (c == e && i == 2*sizeof(handle));
+    if (i != 2*sizeof(buffer))
+        return { c, std::errc::invalid_argument };
+    memcpy(&handle.value, &buffer[0], sizeof(buffer));
+    return { c, std::errc() };
+}
+
+inline std::to_chars_result
+utl::handle::to_chars_n(const handle* handles, size_t count, char* first, char* last, char separator)
+{
+    for (size_t i = 0; i < count; ++i)
+    {
+        if (i > 0)
+        {
+            if (first == last)
+                return { last, std::errc::value_too_large };
+            *first++ = separator;
+        }
+        auto ret = handles[i].to_chars(first, last);
+        if (ret.ec != std::errc())
+            return ret;
+        first = ret.ptr;
+    }
+    return { first, std::errc() };
+}
+
+inline std::from_chars_result
+utl::handle::from_chars_n(const char* first, const char* last, handle* handles, size_t count, char separator)
+{
+    for (size_t i = 0; i < count; ++i)
+    {
+        if (i > 0)
+        {
+            if (first == last || *first != separator)
+                return { first, std::errc::invalid_argument };
+            ++first;
+        }
+        auto ret = from_chars(first, last, handles[i]);
+        if (ret.ec != std::errc())
+            return ret;
+        first = ret.ptr;
+    }
+    return { first, std::errc() };
 }
 
 inline const utl::handle&
@@ -389,6 +1204,33 @@ utl::handle::empty()
     return value;
 }
 
+inline constexpr utl::__impl::hex_table::hex_table() :
+    digits  { },
+    values  { }
+{
+    constexpr char chars[] = "0123456789ABCDEF";
+    for (size_t i = 0; i < 256; ++i)
+    {
+        digits[2*i]   = chars[i >> 4];
+        digits[2*i+1] = chars[i & 0x0F];
+        values[i]     = 0xFF;
+    }
+    for (size_t i = 0; i < 10; ++i)
+        values['0' + i] = static_cast<uint8_t>(i);
+    for (size_t i = 0; i < 6; ++i)
+    {
+        values['a' + i] = static_cast<uint8_t>(10 + i);
+        values['A' + i] = static_cast<uint8_t>(10 + i);
+    }
+}
+
+inline const utl::__impl::hex_table&
+utl::__impl::hex_table::get()
+{
+    static constexpr hex_table value;
+    return value;
+}
+
 inline utl::__impl::handle_data utl::__impl::make_handle_data(const handle& handle)
 {
     handle_data hd = reinterpret_cast<const handle_data&>(handle);
@@ -408,43 +1250,176 @@ inline utl::handle utl::__impl::make_handle(handle_data hd)
     return reinterpret_cast<const handle&>(hd);
 }
 
-/* ENTRY *****************************************************************************************/
+inline size_t utl::__impl::snapshot_data_offset(size_t system_count)
+{
+    auto size = sizeof(snapshot_header) + system_count * sizeof(snapshot_system);
+    return (size + snapshot_alignment - 1) / snapshot_alignment * snapshot_alignment;
+}
 
-template<class T>
-inline utl::__impl::index_type
-utl::__impl::entry<T>::next() const
+template<class T_encoding>
+inline utl::__impl::counter_type utl::__impl::next_counter(counter_type counter)
 {
-    return _next;
+    counter = (counter + 1) & T_encoding::counter_mask;
+    return counter != 0
+        ? counter
+        : 1;
 }
 
-template<class T>
-inline void
-utl::__impl::entry<T>::next(
-    index_type value)
+template<class T_encoding, class T_entry>
+inline utl::handle utl::__impl::make_entry_handle(size_t sId, size_t index, const T_entry& entry)
 {
-    _next = value;
+    handle_fields hf;
+    hf.entry_index = static_cast<uint32_t>(index);
+    hf.counter     = entry.counter();
+    hf.type_id     = entry.type_id();
+    hf.system_id   = static_cast<system_id_type>(sId);
+    return T_encoding::encode(hf);
 }
 
-template<class T>
-inline utl::__impl::index_type
-utl::__impl::entry<T>::prev() const
+/* HANDLE ENCODING *******************************************************************************/
+
+inline utl::__impl::handle_fields
+utl::network_handle_encoding::decode(
+    const handle& handle)
 {
-    return _prev;
+    auto hd = __impl::make_handle_data(handle);
+    __impl::handle_fields hf;
+    hf.system_id   = hd.system_id;
+    hf.type_id     = hd.type_id;
+    hf.counter     = hd.counter;
+    hf.entry_index = hd.entry_index;
+    return hf;
 }
 
-template<class T>
-inline void
-utl::__impl::entry<T>::prev(
-    index_type value)
+inline utl::handle
+utl::network_handle_encoding::encode(
+    const __impl::handle_fields& hf)
 {
-    _prev = value;
+    __impl::handle_data hd;
+    hd.system_id   = hf.system_id;
+    hd.type_id     = hf.type_id;
+    hd.counter     = static_cast<uint16_t>(hf.counter);
+    hd.entry_index = hf.entry_index;
+    return __impl::make_handle(hd);
+}
+
+inline utl::handle
+utl::network_handle_encoding::to_network(
+    const handle& handle)
+    { return handle; }
+
+inline utl::handle
+utl::network_handle_encoding::from_network(
+    const handle& handle)
+    { return handle; }
+
+inline std::string
+utl::network_handle_encoding::to_string(
+    const handle& handle)
+    { return handle.to_string(); }
+
+inline bool
+utl::network_handle_encoding::from_string(
+    const std::string& str,
+    handle& handle)
+    { return handle::from_string(str, handle); }
+
+template<size_t S, size_t T, size_t C, size_t I>
+inline utl::__impl::handle_fields
+utl::handle_layout<S, T, C, I>::decode(
+    const handle& handle)
+{
+    __impl::handle_fields hf;
+    hf.system_id   = static_cast<system_id_type>      ((handle.value >> system_shift)  & mask(S));
+    hf.type_id     = static_cast<type_id_type>        ((handle.value >> type_shift)    & mask(T));
+    hf.counter     = static_cast<__impl::counter_type>((handle.value >> counter_shift) & mask(C));
+    hf.entry_index = static_cast<uint32_t>            ((handle.value >> index_shift)   & mask(I));
+    return hf;
+}
+
+template<size_t S, size_t T, size_t C, size_t I>
+inline utl::handle
+utl::handle_layout<S, T, C, I>::encode(
+    const __impl::handle_fields& hf)
+{
+    assert((hf.system_id   & mask(S)) == hf.system_id);
+    assert((hf.type_id     & mask(T)) == hf.type_id);
+    assert((hf.counter     & mask(C)) == hf.counter);
+    assert((hf.entry_index & mask(I)) == hf.entry_index);
+    return handle(
+          ((static_cast<uint64_t>(hf.system_id)   & mask(S)) << system_shift)
+        | ((static_cast<uint64_t>(hf.type_id)     & mask(T)) << type_shift)
+        | ((static_cast<uint64_t>(hf.counter)     & mask(C)) << counter_shift)
+        | ((static_cast<uint64_t>(hf.entry_index) & mask(I)) << index_shift));
+}
+
+template<size_t S, size_t T, size_t C, size_t I>
+inline utl::handle
+utl::handle_layout<S, T, C, I>::to_network(
+    const handle& handle)
+    { return utl::handle(hton(handle.value)); }
+
+template<size_t S, size_t T, size_t C, size_t I>
+inline utl::handle
+utl::handle_layout<S, T, C, I>::from_network(
+    const handle& handle)
+    { return utl::handle(ntoh(handle.value)); }
+
+template<size_t S, size_t T, size_t C, size_t I>
+inline std::string
+utl::handle_layout<S, T, C, I>::to_string(
+    const handle& handle)
+    { return to_network(handle).to_string(); }
+
+template<size_t S, size_t T, size_t C, size_t I>
+inline bool
+utl::handle_layout<S, T, C, I>::from_string(
+    const std::string& str,
+    handle& handle)
+{
+    if (!handle::from_string(str, handle))
+        return false;
+    handle = from_network(handle);
+    return true;
+}
+
+/* ENTRY *****************************************************************************************/
+
+template<class T>
+inline utl::__impl::index_type
+utl::__impl::entry<T>::next() const
+{
+    return _next;
+}
+
+template<class T>
+inline void
+utl::__impl::entry<T>::next(
+    index_type value)
+{
+    _next = value;
+}
+
+template<class T>
+inline utl::__impl::index_type
+utl::__impl::entry<T>::prev() const
+{
+    return _prev;
+}
+
+template<class T>
+inline void
+utl::__impl::entry<T>::prev(
+    index_type value)
+{
+    _prev = value;
 }
 
 template<class T>
 inline utl::__impl::entry_status
 utl::__impl::entry<T>::status() const
 {
-    return _status;
+    return _meta.status;
 }
 
 template<class T>
@@ -452,74 +1427,104 @@ inline void
 utl::__impl::entry<T>::link(index_type prev, index_type next, entry_status status)
 {
     assert(status != entry_status::unknown);
-    _prev   = prev;
-    _next   = next;
-    _status = status;
+    _prev        = prev;
+    _next        = next;
+    _meta.status = status;
 }
 
 template<class T>
 inline void
 utl::__impl::entry<T>::unlink()
 {
-    _prev   = invalid_index;
-    _next   = invalid_index;
-    _status = entry_status::unknown;
+    _prev        = invalid_index;
+    _next        = invalid_index;
+    _meta.status = entry_status::unknown;
 }
 
 template<class T>
-inline uint16_t
+inline utl::__impl::counter_type
 utl::__impl::entry<T>::counter() const
-    { return _counter; }
+    { return _meta.counter; }
+
+template<class T>
+inline utl::type_id_type
+utl::__impl::entry<T>::type_id() const
+    { return _meta.type_id; }
+
+template<class T>
+inline const utl::__impl::entry_meta&
+utl::__impl::entry<T>::meta() const
+    { return _meta; }
 
 template<class T>
 inline void
 utl::__impl::entry<T>::assign(
     value_type value,
     const type_id_type& tId,
-    const uint16_t cntr)
+    const counter_type cntr)
 {
     using namespace ::utl;
     using namespace ::utl::__impl;
-    assert(_status == entry_status::used);
-    _type_id = tId;
-    _data   = value;
-    if (cntr != 0)
-        _counter = cntr;
-    else if (++_counter == 0)
-        _counter = 1;
+    assert(_meta.status == entry_status::used);
+    _meta.type_id = tId;
+    _meta.counter = cntr;
+    _data         = std::move(value);
+}
+
+template<class T>
+template<class... T_args>
+inline void
+utl::__impl::entry<T>::emplace(
+    const type_id_type& tId,
+    const counter_type cntr,
+    T_args&&... args)
+{
+    _data.emplace(std::forward<T_args>(args)...);
+    _meta.type_id = tId;
+    _meta.counter = cntr;
 }
 
 template<class T>
-inline typename utl::__impl::entry<T>::value_type
+inline typename utl::__impl::entry<T>::value_type&
 utl::__impl::entry<T>::data()
 {
     return *_data;
 }
 
+template<class T>
+inline const typename utl::__impl::entry<T>::value_type&
+utl::__impl::entry<T>::data() const
+{
+    return *_data;
+}
+
 template<class T>
 inline void
 utl::__impl::entry<T>::data(
     value_type v)
 {
-    _data = v;
+    _data = std::move(v);
+}
+
+template<class T>
+inline void
+utl::__impl::entry<T>::reset()
+{
+    _data.emplace();
 }
 
 template<class T>
 inline utl::__impl::entry<T>::entry() :
     _next   (invalid_index),
     _prev   (invalid_index),
-    _counter(0),
-    _status (entry_status::unknown),
-    _type_id (0)
+    _meta   ({ 0, entry_status::unknown, 0 })
     { }
 
 template<class T>
 inline utl::__impl::entry<T>::entry(entry&& other) :
     _next   (std::move(other)._next),
     _prev   (std::move(other)._prev),
-    _counter(std::move(other)._counter),
-    _status (std::move(other)._status),
-    _type_id (std::move(other)._type_id),
+    _meta   (std::move(other)._meta),
     _data   (std::move(other)._data)
     { }
 
@@ -527,377 +1532,1277 @@ template<class T>
 inline utl::__impl::entry<T>::entry(const entry& other) :
     _next   (other._next),
     _prev   (other._prev),
-    _counter(other._counter),
-    _status (other._status),
-    _type_id (other._type_id),
+    _meta   (other._meta),
     _data   (other._data)
     { }
 
-/* SYSTEM ****************************************************************************************/
+/* PAGE VECTOR ***********************************************************************************/
 
 template<class T>
-inline void
-utl::__impl::system<T>::pushFront(
-    index_type index,
-    index_type& first,
-    index_type& last,
-    entry_status status)
-{
-    assert(index < _entries.size());
-    auto& entry = _entries[index];
-    assert(entry.status() == entry_status::unknown);
-    if (first != invalid_index)
-    {
-        assert(first >= 0);
-        assert(first < _entries.size());
-        auto& firstEntry = _entries[first];
-        assert(firstEntry.status() == status);
-        firstEntry.prev(index);
-    }
-    entry.link(invalid_index, first, status);
-    first = index;
-    if (last == invalid_index)
-        last = index;
-}
+inline size_t
+utl::__impl::page_vector<T>::size() const
+    { return _pages.size(); }
 
 template<class T>
-inline void
-utl::__impl::system<T>::pushBack(
-    index_type index,
-    index_type& first,
-    index_type& last,
-    entry_status status)
+inline size_t
+utl::__impl::page_vector<T>::bytes() const
 {
-    assert(index < _entries.size());
-    auto& entry = _entries[index];
-    assert(entry.status() == entry_status::unknown);
-    if (last != invalid_index)
-    {
-        assert(last >= 0);
-        assert(last < _entries.size());
-        auto& lastEntry = _entries[last];
-        assert(lastEntry.status() == status);
-        lastEntry.next(index);
-    }
-    entry.link(last, invalid_index, status);
-    last = index;
-    if (first == invalid_index)
-        first = index;
+    return _pages.capacity() * sizeof(page_ref)
+         + _pages.size()     * sizeof(page_type);
 }
 
 template<class T>
-inline utl::__impl::index_type
-utl::__impl::system<T>::popFront(
-    bool canGrow,
-    index_type& first,
-    index_type& last,
-    entry_status status)
+inline typename utl::__impl::page_vector<T>::page_type&
+utl::__impl::page_vector<T>::emplace_back()
 {
-    if (    canGrow
-        && (    first >= _entries.size()
-            ||  first == invalid_index))
-        grow((first != invalid_index ? first : 0) + grow_size);
-    assert(first >= 0);
-    assert(first < _entries.size());
-    auto& entry = _entries[first];
-    assert(entry.status() == status);
-    index_type ret = first;
-    if (last == first)
-        last = entry.next();
-    first = entry.next();
-    entry.unlink();
-    if (first != invalid_index)
-    {
-        assert(first >= 0);
-        assert(first < _entries.size());
-        auto& firstEntry = _entries[first];
-        assert(firstEntry.status() == status);
-        firstEntry.prev(invalid_index);
-    }
-    return ret;
+    std::unique_ptr<page_type> page(new page_type());
+    _pages.push_back(page_ref { page.get(), true });
+    return *page.release();
 }
 
 template<class T>
-inline utl::__impl::index_type
-utl::__impl::system<T>::popBack(
-    bool canGrow,
-    index_type& first,
-    index_type& last,
-    entry_status status)
-{
-    if (    canGrow
-        && (    last >= _entries.size()
-            ||  last == invalid_index))
-        grow((last != invalid_index ? last : 0) + grow_size);
-    assert(last >= 0);
-    assert(last < _entries.size());
-    auto& entry = _entries[last];
-    assert(entry.status() == status);
-    index_type ret = last;
-    if (first == last)
-        first = entry._prev;
-    last = entry._prev;
-    entry.unlink();
-    if (last != invalid_index)
-    {
-        assert(last >= 0);
-        assert(last < _entries.size());
-        auto& lastEntry = _entries[last];
-        assert(lastEntry.status() == status);
-        lastEntry.next(invalid_index);
-    }
-    return ret;
-}
+inline void
+utl::__impl::page_vector<T>::attach(
+    void* data)
+    { _pages.push_back(page_ref { static_cast<page_type*>(data), false }); }
 
 template<class T>
 inline void
-utl::__impl::system<T>::remove(
-    index_type index,
-    index_type& first,
-    index_type& last,
-    entry_status status)
+utl::__impl::page_vector<T>::pop_back()
 {
-    assert(index >= 0);
-    assert(index < _entries.size());
-    auto& entry = _entries[index];
-    assert(entry.status() == status);
-    if (entry.prev() != invalid_index)
-    {
-        assert(entry.prev() >= 0);
-        assert(entry.prev() < _entries.size());
-        _entries[entry.prev()].next(entry.next());
-    }
-    if (entry.next() != invalid_index)
-    {
-        assert(entry.next() >= 0);
-        assert(entry.next() < _entries.size());
-        _entries[entry.next()].prev(entry.prev());
-    }
-    if (first == index)
-        first = entry.next();
-    if (last == index)
-        last = entry.prev();
-    entry.unlink();
+    if (_pages.back().owned)
+        delete _pages.back().page;
+    _pages.pop_back();
 }
 
 template<class T>
 inline void
-utl::__impl::system<T>::grow(
-    size_t size)
-{
-    if (size == 0)
-        size = _entries.size() + grow_size;
-    if (size < _entries.size())
-        return;
-    size_t idx = _entries.size();
-    _entries.resize(size);
-    while (idx < _entries.size())
-    {
-        pushBackFree(idx);
-        ++idx;
-    }
-}
+utl::__impl::page_vector<T>::shrink_to_fit()
+    { _pages.shrink_to_fit(); }
 
 template<class T>
-inline void
-utl::__impl::system<T>::pushFrontFree(
-    index_type index)
-{
-    pushFront(index, _firstFree, _lastFree, entry_status::free);
-}
+inline const typename utl::__impl::page_vector<T>::page_type&
+utl::__impl::page_vector<T>::at(
+    size_t index) const
+    { return *_pages.at(index).page; }
 
 template<class T>
-inline void
-utl::__impl::system<T>::pushFrontUsed(
-    index_type index)
-{
-    pushFront(index, _firstUsed, _lastUsed, entry_status::used);
-}
+inline typename utl::__impl::page_vector<T>::page_type&
+utl::__impl::page_vector<T>::operator[](
+    size_t index)
+    { return *_pages[index].page; }
 
 template<class T>
-inline void
-utl::__impl::system<T>::pushBackFree(
-    index_type index)
-{
-    pushBack(index, _firstFree, _lastFree, entry_status::free);
-}
+inline const typename utl::__impl::page_vector<T>::page_type&
+utl::__impl::page_vector<T>::operator[](
+    size_t index) const
+    { return *_pages[index].page; }
 
 template<class T>
-inline void
-utl::__impl::system<T>::pushBackUsed(
-    index_type index)
-{
-    pushBack(index, _firstUsed, _lastUsed, entry_status::used);
-}
+inline utl::__impl::page_vector<T>::page_vector()
+    { }
 
 template<class T>
-inline utl::__impl::index_type
-utl::__impl::system<T>::popFrontFree()
-{
-    return popFront(true, _firstFree, _lastFree, entry_status::free);
-}
+inline utl::__impl::page_vector<T>::page_vector(page_vector&& other) :
+    _pages(std::move(other._pages))
+    { other._pages.clear(); }
 
 template<class T>
-inline utl::__impl::index_type
-utl::__impl::system<T>::popFrontUsed()
+inline utl::__impl::page_vector<T>::page_vector(const page_vector& other)
 {
-    return popFront(false, _firstUsed, _lastUsed, entry_status::used);
+    _pages.reserve(other._pages.size());
+    for (auto& ref : other._pages)
+    {
+        std::unique_ptr<page_type> page(new page_type(*ref.page));
+        _pages.push_back(page_ref { page.get(), true });
+        page.release();
+    }
 }
 
 template<class T>
-inline utl::__impl::index_type
-utl::__impl::system<T>::popBackFree()
+inline utl::__impl::page_vector<T>::~page_vector()
 {
-    return popBack(true, _firstFree, _lastFree, entry_status::free);
+    while (!_pages.empty())
+        pop_back();
 }
 
+/* ENTRY PAGES ***********************************************************************************/
+
 template<class T>
-inline utl::__impl::index_type
-utl::__impl::system<T>::popBackUsed()
-{
-    return popBack(false, _firstUsed, _lastUsed, entry_status::used);
-}
+inline size_t
+utl::__impl::entry_pages<T>::size() const
+    { return _pages.size() * page_size; }
 
 template<class T>
 inline void
-utl::__impl::system<T>::removeFree(
-    index_type index)
+utl::__impl::entry_pages<T>::resize(
+    size_t size)
 {
-    remove(index, _firstFree, _lastFree, entry_status::free);
+    while (this->size() < size)
+        _pages.emplace_back();
 }
 
 template<class T>
 inline void
-utl::__impl::system<T>::removeUsed(
-    index_type index)
+utl::__impl::entry_pages<T>::shrink(
+    size_t size)
 {
-    remove(index, _firstUsed, _lastUsed, entry_status::used);
+    while (this->size() >= size + page_size)
+        _pages.pop_back();
+    _pages.shrink_to_fit();
 }
 
 template<class T>
 inline size_t
-utl::__impl::system<T>::size() const
-{
-    return _entries.size();
-}
-
+utl::__impl::entry_pages<T>::bytes() const
+    { return _pages.bytes(); }
 
 template<class T>
-inline typename utl::__impl::system<T>::entry_type&
-utl::__impl::system<T>::operator[](
-    const index_type& index)
-{
-    if (index >= _entries.size())
-        grow(index + grow_size);
-    return _entries[index];
-}
+inline typename utl::__impl::entry_pages<T>::const_reference
+utl::__impl::entry_pages<T>::at(
+    const index_type& index) const
+    { return _pages.at(index / page_size)[index % page_size]; }
 
 template<class T>
-inline const typename utl::__impl::system<T>::entry_type&
-utl::__impl::system<T>::operator[](
-    const index_type& index) const
-{
-    return _entries.at(index);
-}
+inline const void*
+utl::__impl::entry_pages<T>::page_data(
+    size_t page) const
+    { return &_pages[page]; }
 
 template<class T>
-inline utl::__impl::system<T>::system() :
-    _firstFree  (invalid_index),
-    _lastFree   (invalid_index),
-    _firstUsed  (invalid_index),
-    _lastUsed   (invalid_index)
-    { }
+inline void*
+utl::__impl::entry_pages<T>::append()
+    { return &_pages.emplace_back(); }
 
 template<class T>
-inline utl::__impl::system<T>::system(system&& other) :
-    _firstFree  (std::move(other)._firstFree),
-    _lastFree   (std::move(other)._lastFree),
-    _firstUsed  (std::move(other)._firstUsed),
-    _lastUsed   (std::move(other)._lastUsed),
-    _entries    (std::move(other)._entries)
+inline void
+utl::__impl::entry_pages<T>::attach(
+    void* data)
+    { _pages.attach(data); }
+
+template<class T>
+inline typename utl::__impl::entry_pages<T>::reference
+utl::__impl::entry_pages<T>::operator[](
+    const index_type& index)
+    { return _pages[index / page_size][index % page_size]; }
+
+template<class T>
+inline typename utl::__impl::entry_pages<T>::const_reference
+utl::__impl::entry_pages<T>::operator[](
+    const index_type& index) const
+    { return _pages[index / page_size][index % page_size]; }
+
+template<class T>
+inline utl::__impl::entry_pages<T>::entry_pages()
+    { }
+
+template<class T>
+inline utl::__impl::entry_pages<T>::entry_pages(entry_pages&& other) :
+    _pages(std::move(other)._pages)
+    { }
+
+template<class T>
+inline utl::__impl::entry_pages<T>::entry_pages(const entry_pages& other) :
+    _pages(other._pages)
+    { }
+
+/* SOA ENTRY PAGES *******************************************************************************/
+
+template<class T>
+inline utl::__impl::soa_entry_page<T>::soa_entry_page()
+{
+    for (size_t i = 0; i < page_size; ++i)
+    {
+        meta[i].counter = 0;
+        meta[i].status  = entry_status::unknown;
+        meta[i].type_id = 0;
+        links[i].next   = invalid_index;
+        links[i].prev   = invalid_index;
+    }
+}
+
+template<class T>
+inline utl::__impl::index_type
+utl::__impl::soa_entry_ref<T>::next() const
+    { return _page->links[_offset].next; }
+
+template<class T>
+inline void
+utl::__impl::soa_entry_ref<T>::next(
+    index_type value) const
+    { _page->links[_offset].next = value; }
+
+template<class T>
+inline utl::__impl::index_type
+utl::__impl::soa_entry_ref<T>::prev() const
+    { return _page->links[_offset].prev; }
+
+template<class T>
+inline void
+utl::__impl::soa_entry_ref<T>::prev(
+    index_type value) const
+    { _page->links[_offset].prev = value; }
+
+template<class T>
+inline utl::__impl::entry_status
+utl::__impl::soa_entry_ref<T>::status() const
+    { return _page->meta[_offset].status; }
+
+template<class T>
+inline void
+utl::__impl::soa_entry_ref<T>::link(index_type prev, index_type next, entry_status status) const
+{
+    assert(status != entry_status::unknown);
+    _page->links[_offset].prev  = prev;
+    _page->links[_offset].next  = next;
+    _page->meta[_offset].status = status;
+}
+
+template<class T>
+inline void
+utl::__impl::soa_entry_ref<T>::unlink() const
+{
+    _page->links[_offset].prev  = invalid_index;
+    _page->links[_offset].next  = invalid_index;
+    _page->meta[_offset].status = entry_status::unknown;
+}
+
+template<class T>
+inline utl::__impl::counter_type
+utl::__impl::soa_entry_ref<T>::counter() const
+    { return _page->meta[_offset].counter; }
+
+template<class T>
+inline utl::type_id_type
+utl::__impl::soa_entry_ref<T>::type_id() const
+    { return _page->meta[_offset].type_id; }
+
+template<class T>
+inline const auto&
+utl::__impl::soa_entry_ref<T>::meta() const
+    { return _page->meta[_offset]; }
+
+template<class T>
+inline void
+utl::__impl::soa_entry_ref<T>::assign(
+    value_type value,
+    const type_id_type& tId,
+    const counter_type cntr) const
+{
+    auto& meta = _page->meta[_offset];
+    assert(meta.status == entry_status::used);
+    meta.type_id           = tId;
+    meta.counter           = cntr;
+    _page->values[_offset] = std::move(value);
+}
+
+template<class T>
+template<class... T_args>
+inline void
+utl::__impl::soa_entry_ref<T>::emplace(
+    const type_id_type& tId,
+    const counter_type cntr,
+    T_args&&... args) const
+{
+    _page->values[_offset].emplace(std::forward<T_args>(args)...);
+    auto& meta = _page->meta[_offset];
+    meta.type_id = tId;
+    meta.counter = cntr;
+}
+
+template<class T>
+inline auto&
+utl::__impl::soa_entry_ref<T>::data() const
+    { return *_page->values[_offset]; }
+
+template<class T>
+inline void
+utl::__impl::soa_entry_ref<T>::data(
+    value_type v) const
+    { _page->values[_offset] = std::move(v); }
+
+template<class T>
+inline void
+utl::__impl::soa_entry_ref<T>::reset() const
+    { _page->values[_offset].emplace(); }
+
+template<class T>
+inline utl::__impl::soa_entry_ref<T>::soa_entry_ref(page_type& page, size_t offset) :
+    _page   (&page),
+    _offset (offset)
+    { }
+
+template<class T>
+inline size_t
+utl::__impl::soa_entry_pages<T>::size() const
+    { return _pages.size() * page_size; }
+
+template<class T>
+inline void
+utl::__impl::soa_entry_pages<T>::resize(
+    size_t size)
+{
+    while (this->size() < size)
+        _pages.emplace_back();
+}
+
+template<class T>
+inline void
+utl::__impl::soa_entry_pages<T>::shrink(
+    size_t size)
+{
+    while (this->size() >= size + page_size)
+        _pages.pop_back();
+    _pages.shrink_to_fit();
+}
+
+template<class T>
+inline size_t
+utl::__impl::soa_entry_pages<T>::bytes() const
+    { return _pages.bytes(); }
+
+template<class T>
+inline typename utl::__impl::soa_entry_pages<T>::const_reference
+utl::__impl::soa_entry_pages<T>::at(
+    const index_type& index) const
+    { return const_reference(_pages.at(index / page_size), index % page_size); }
+
+template<class T>
+inline const void*
+utl::__impl::soa_entry_pages<T>::page_data(
+    size_t page) const
+    { return &_pages[page]; }
+
+template<class T>
+inline void*
+utl::__impl::soa_entry_pages<T>::append()
+    { return &_pages.emplace_back(); }
+
+template<class T>
+inline void
+utl::__impl::soa_entry_pages<T>::attach(
+    void* data)
+    { _pages.attach(data); }
+
+template<class T>
+inline typename utl::__impl::soa_entry_pages<T>::reference
+utl::__impl::soa_entry_pages<T>::operator[](
+    const index_type& index)
+    { return reference(_pages[index / page_size], index % page_size); }
+
+template<class T>
+inline typename utl::__impl::soa_entry_pages<T>::const_reference
+utl::__impl::soa_entry_pages<T>::operator[](
+    const index_type& index) const
+    { return const_reference(_pages[index / page_size], index % page_size); }
+
+template<class T>
+inline utl::__impl::soa_entry_pages<T>::soa_entry_pages()
+    { }
+
+template<class T>
+inline utl::__impl::soa_entry_pages<T>::soa_entry_pages(soa_entry_pages&& other) :
+    _pages(std::move(other)._pages)
+    { }
+
+template<class T>
+inline utl::__impl::soa_entry_pages<T>::soa_entry_pages(const soa_entry_pages& other) :
+    _pages(other._pages)
+    { }
+
+/* SYSTEM ****************************************************************************************/
+
+template<class T, class R>
+inline void
+utl::__impl::system<T, R>::pushFront(
+    index_type index,
+    index_type& first,
+    index_type& last,
+    entry_status status)
+{
+    assert(index < _entries.size());
+    auto&& entry = _entries[index];
+    assert(entry.status() == entry_status::unknown);
+    if (first != invalid_index)
+    {
+        assert(first >= 0);
+        assert(first < _entries.size());
+        auto&& firstEntry = _entries[first];
+        assert(firstEntry.status() == status);
+        firstEntry.prev(index);
+    }
+    entry.link(invalid_index, first, status);
+    first = index;
+    if (last == invalid_index)
+        last = index;
+}
+
+template<class T, class R>
+inline void
+utl::__impl::system<T, R>::pushBack(
+    index_type index,
+    index_type& first,
+    index_type& last,
+    entry_status status)
+{
+    assert(index < _entries.size());
+    auto&& entry = _entries[index];
+    assert(entry.status() == entry_status::unknown);
+    if (last != invalid_index)
+    {
+        assert(last >= 0);
+        assert(last < _entries.size());
+        auto&& lastEntry = _entries[last];
+        assert(lastEntry.status() == status);
+        lastEntry.next(index);
+    }
+    entry.link(last, invalid_index, status);
+    last = index;
+    if (first == invalid_index)
+        first = index;
+}
+
+template<class T, class R>
+inline utl::__impl::index_type
+utl::__impl::system<T, R>::popFront(
+    bool canGrow,
+    index_type& first,
+    index_type& last,
+    entry_status status)
+{
+    if (    canGrow
+        && (    first >= _entries.size()
+            ||  first == invalid_index))
+        grow(first != invalid_index ? first + 1 : 0);
+    if (canGrow && first == invalid_index)
+        throw exception("handle manager system is full");
+    assert(first >= 0);
+    assert(first < _entries.size());
+    auto&& entry = _entries[first];
+    assert(entry.status() == status);
+    index_type ret = first;
+    if (last == first)
+        last = entry.next();
+    first = entry.next();
+    entry.unlink();
+    if (first != invalid_index)
+    {
+        assert(first >= 0);
+        assert(first < _entries.size());
+        auto&& firstEntry = _entries[first];
+        assert(firstEntry.status() == status);
+        firstEntry.prev(invalid_index);
+    }
+    return ret;
+}
+
+template<class T, class R>
+inline utl::__impl::index_type
+utl::__impl::system<T, R>::popBack(
+    bool canGrow,
+    index_type& first,
+    index_type& last,
+    entry_status status)
+{
+    if (    canGrow
+        && (    last >= _entries.size()
+            ||  last == invalid_index))
+        grow(last != invalid_index ? last + 1 : 0);
+    if (canGrow && last == invalid_index)
+        throw exception("handle manager system is full");
+    assert(last >= 0);
+    assert(last < _entries.size());
+    auto&& entry = _entries[last];
+    assert(entry.status() == status);
+    index_type ret = last;
+    if (first == last)
+        first = entry.prev();
+    last = entry.prev();
+    entry.unlink();
+    if (last != invalid_index)
+    {
+        assert(last >= 0);
+        assert(last < _entries.size());
+        auto&& lastEntry = _entries[last];
+        assert(lastEntry.status() == status);
+        lastEntry.next(invalid_index);
+    }
+    return ret;
+}
+
+template<class T, class R>
+inline void
+utl::__impl::system<T, R>::remove(
+    index_type index,
+    index_type& first,
+    index_type& last,
+    entry_status status)
+{
+    assert(index >= 0);
+    assert(index < _entries.size());
+    auto&& entry = _entries[index];
+    assert(entry.status() == status);
+    if (entry.prev() != invalid_index)
+    {
+        assert(entry.prev() >= 0);
+        assert(entry.prev() < _entries.size());
+        _entries[entry.prev()].next(entry.next());
+    }
+    if (entry.next() != invalid_index)
+    {
+        assert(entry.next() >= 0);
+        assert(entry.next() < _entries.size());
+        _entries[entry.next()].prev(entry.prev());
+    }
+    if (first == index)
+        first = entry.next();
+    if (last == index)
+        last = entry.prev();
+    entry.unlink();
+}
+
+template<class T, class R>
+inline void
+utl::__impl::system<T, R>::grow(
+    size_t size)
+{
+    if (size == 0)
+    {
+        auto current = _entries.size();
+        size = std::max(current + page_size, static_cast<size_t>(static_cast<double>(current) * _growthFactor));
+        size = (size + page_size - 1) / page_size * page_size;
+    }
+    size = std::min(size, _limit);
+    if (size <= _entries.size())
+        return;
+    size_t first = _entries.size();
+    size_t idx   = first;
+    _entries.resize(size);
+    while (idx < std::min(_entries.size(), _limit))
+    {
+        pushBackFree(idx);
+        ++idx;
+    }
+    if (idx > first)
+        _recycling.added(static_cast<index_type>(first), static_cast<index_type>(idx));
+}
+
+template<class T, class R>
+inline void
+utl::__impl::system<T, R>::pushFrontFree(
+    index_type index)
+{
+    pushFront(index, _firstFree, _lastFree, entry_status::free);
+    ++_freeCount;
+}
+
+template<class T, class R>
+inline void
+utl::__impl::system<T, R>::pushFrontUsed(
+    index_type index)
+{
+    pushFront(index, _firstUsed, _lastUsed, entry_status::used);
+    ++_usedCount;
+}
+
+template<class T, class R>
+inline void
+utl::__impl::system<T, R>::pushBackFree(
+    index_type index)
+{
+    pushBack(index, _firstFree, _lastFree, entry_status::free);
+    ++_freeCount;
+}
+
+template<class T, class R>
+inline void
+utl::__impl::system<T, R>::pushBackUsed(
+    index_type index)
+{
+    pushBack(index, _firstUsed, _lastUsed, entry_status::used);
+    ++_usedCount;
+}
+
+template<class T, class R>
+inline utl::__impl::index_type
+utl::__impl::system<T, R>::popFrontFree()
+{
+    auto index = popFront(true, _firstFree, _lastFree, entry_status::free);
+    --_freeCount;
+    return index;
+}
+
+template<class T, class R>
+inline utl::__impl::index_type
+utl::__impl::system<T, R>::popFrontUsed()
+{
+    auto index = popFront(false, _firstUsed, _lastUsed, entry_status::used);
+    --_usedCount;
+    return index;
+}
+
+template<class T, class R>
+inline utl::__impl::index_type
+utl::__impl::system<T, R>::popBackFree()
+{
+    auto index = popBack(true, _firstFree, _lastFree, entry_status::free);
+    --_freeCount;
+    return index;
+}
+
+template<class T, class R>
+inline utl::__impl::index_type
+utl::__impl::system<T, R>::popBackUsed()
+{
+    auto index = popBack(false, _firstUsed, _lastUsed, entry_status::used);
+    --_usedCount;
+    return index;
+}
+
+template<class T, class R>
+inline void
+utl::__impl::system<T, R>::removeFree(
+    index_type index)
+{
+    remove(index, _firstFree, _lastFree, entry_status::free);
+    --_freeCount;
+}
+
+template<class T, class R>
+inline void
+utl::__impl::system<T, R>::removeUsed(
+    index_type index)
+{
+    remove(index, _firstUsed, _lastUsed, entry_status::used);
+    --_usedCount;
+}
+
+template<class T, class R>
+inline void
+utl::__impl::system<T, R>::takeFree(
+    index_type index)
+{
+    removeFree(index);
+    _recycling.taken(index);
+}
+
+template<class T, class R>
+inline void
+utl::__impl::system<T, R>::reserveFree(
+    size_t count)
+{
+    if (_freeCount < count)
+        grow(_entries.size() + count - _freeCount);
+}
+
+template<class T, class R>
+inline void
+utl::__impl::system<T, R>::reserve(
+    size_t size)
+    { grow(size); }
+
+template<class T, class R>
+inline void
+utl::__impl::system<T, R>::shrinkToFit()
+{
+    size_t count = std::min(_entries.size(), _limit);
+    size_t used  = count;
+    while (used > 0 && _entries[used - 1].status() != entry_status::used)
+        --used;
+    size_t size = (used + page_size - 1) / page_size * page_size;
+    if (size >= _entries.size())
+        return;
+    for (index_type index = size; index < count; ++index)
+        removeFree(index);
+    _recycling.truncated(size);
+    _entries.shrink(size);
+}
+
+template<class T, class R>
+inline void
+utl::__impl::system<T, R>::growthFactor(
+    double factor)
+    { _growthFactor = factor; }
+
+template<class T, class R>
+inline size_t
+utl::__impl::system<T, R>::bytes() const
+    { return sizeof(*this) + _entries.bytes(); }
+
+template<class T, class R>
+inline size_t
+utl::__impl::system<T, R>::size() const
+{
+    return _entries.size();
+}
+
+template<class T, class R>
+inline size_t
+utl::__impl::system<T, R>::freeCount() const
+    { return _freeCount; }
+
+template<class T, class R>
+inline size_t
+utl::__impl::system<T, R>::usedCount() const
+    { return _usedCount; }
+
+template<class T, class R>
+template<class T_func>
+inline void
+utl::__impl::system<T, R>::moveFreeToUsed(
+    size_t count,
+    T_func&& func)
+{
+    if (count == 0)
+        return;
+    reserveFree(count);
+    if (_freeCount < count)
+        throw exception("handle manager system is full");
+
+    index_type first = _firstFree;
+    index_type last  = first;
+    for (size_t i = 1; ; ++i)
+    {
+        auto&& entry = _entries[last];
+        assert(entry.status() == entry_status::free);
+        entry.link(entry.prev(), entry.next(), entry_status::used);
+        func(last);
+        if (i == count)
+            break;
+        last = entry.next();
+    }
+
+    auto&& lastEntry = _entries[last];
+    _firstFree = lastEntry.next();
+    if (_firstFree != invalid_index)
+        _entries[_firstFree].prev(invalid_index);
+    else
+        _lastFree = invalid_index;
+
+    _entries[first].prev(_lastUsed);
+    if (_lastUsed != invalid_index)
+        _entries[_lastUsed].next(first);
+    else
+        _firstUsed = first;
+    lastEntry.next(invalid_index);
+    _lastUsed = last;
+
+    _freeCount -= count;
+    _usedCount += count;
+}
+
+template<class T, class R>
+inline utl::__impl::index_type
+utl::__impl::system<T, R>::acquire()
+    { return _recycling.acquire(*this); }
+
+template<class T, class R>
+inline void
+utl::__impl::system<T, R>::release(
+    index_type index)
+    { _recycling.release(*this, index); }
+
+template<class T, class R>
+template<class T_func>
+inline void
+utl::__impl::system<T, R>::acquireN(
+    size_t count,
+    T_func&& func)
+    { _recycling.acquire_n(*this, count, std::forward<T_func>(func)); }
+
+template<class T, class R>
+template<class T_func>
+inline void
+utl::__impl::system<T, R>::forEachFree(
+    T_func&& func) const
+{
+    for (auto index = _firstFree; index != invalid_index; index = _entries[index].next())
+        func(index);
+}
+
+template<class T, class R>
+inline void
+utl::__impl::system<T, R>::resetRecycling()
+    { _recycling.reset(*this); }
+
+template<class T, class R>
+template<class T_func>
+inline void
+utl::__impl::system<T, R>::compact(
+    T_func&& func)
+{
+    index_type count = std::min(_entries.size(), _limit);
+    index_type lo    = 0;
+    index_type hi    = count;
+    while (true)
+    {
+        while (lo < hi && _entries[lo].status() == entry_status::used)
+            ++lo;
+        while (hi > lo && _entries[hi - 1].status() != entry_status::used)
+            --hi;
+        if (lo + 1 >= hi)
+            break;
+        --hi;
+        _entries[lo].link(invalid_index, invalid_index, entry_status::used);
+        func(hi, lo);
+        _entries[hi].link(invalid_index, invalid_index, entry_status::free);
+        ++lo;
+    }
+
+    _firstFree = invalid_index;
+    _lastFree  = invalid_index;
+    _firstUsed = invalid_index;
+    _lastUsed  = invalid_index;
+    _freeCount = 0;
+    _usedCount = 0;
+    for (index_type index = 0; index < count; ++index)
+    {
+        auto&& entry  = _entries[index];
+        auto   status = entry.status();
+        entry.unlink();
+        if (status == entry_status::used)
+            pushBackUsed(index);
+        else
+            pushBackFree(index);
+    }
+    resetRecycling();
+}
+
+template<class T, class R>
+inline utl::__impl::snapshot_system
+utl::__impl::system<T, R>::state() const
+{
+    snapshot_system ret;
+    ret.size       = _entries.size();
+    ret.first_free = _firstFree;
+    ret.last_free  = _lastFree;
+    ret.first_used = _firstUsed;
+    ret.last_used  = _lastUsed;
+    ret.free_count = _freeCount;
+    ret.used_count = _usedCount;
+    return ret;
+}
+
+template<class T, class R>
+inline void
+utl::__impl::system<T, R>::restore(
+    const snapshot_system& state)
+{
+    assert(_entries.size() == 0);
+    _firstFree = static_cast<index_type>(state.first_free);
+    _lastFree  = static_cast<index_type>(state.last_free);
+    _firstUsed = static_cast<index_type>(state.first_used);
+    _lastUsed  = static_cast<index_type>(state.last_used);
+    _freeCount = static_cast<size_t>(state.free_count);
+    _usedCount = static_cast<size_t>(state.used_count);
+}
+
+template<class T, class R>
+inline void
+utl::__impl::system<T, R>::verify() const
+{
+    auto fail = [](const char* msg) {
+        throw exception(std::string("invalid handle manager snapshot: ") + msg);
+    };
+
+    size_t count = std::min(_entries.size(), _limit);
+    for (auto head : { _firstFree, _lastFree, _firstUsed, _lastUsed })
+    {
+        if (head != invalid_index && head >= count)
+            fail("list head out of range");
+    }
+    if (_freeCount > count || _usedCount != count - _freeCount)
+        fail("invalid entry count");
+
+    /* a walk over size entries of a list with matching status and back links visits each of these entries
+     * exactly once, so the list can not contain cycles. Both lists together visit count entries, so each
+     * entry below the limit is part of exactly one list. */
+    auto verifyList = [&](index_type first, index_type last, size_t size, entry_status status) {
+        index_type prev  = invalid_index;
+        index_type index = first;
+        for (size_t i = 0; i < size; ++i)
+        {
+            if (index == invalid_index || index >= count)
+                fail("list link out of range");
+            auto&& entry = _entries[index];
+            if (entry.status() != status || entry.prev() != prev)
+                fail("broken list");
+            prev  = index;
+            index = entry.next();
+        }
+        if (index != invalid_index || prev != last)
+            fail("broken list");
+    };
+    verifyList(_firstFree, _lastFree, _freeCount, entry_status::free);
+    verifyList(_firstUsed, _lastUsed, _usedCount, entry_status::used);
+
+    /* entries of the last page behind the limit are never used */
+    for (index_type index = count; index < _entries.size(); ++index)
+    {
+        if (_entries[index].status() != entry_status::unknown)
+            fail("invalid entry status");
+    }
+}
+
+template<class T, class R>
+inline typename utl::__impl::system<T, R>::entry_vector_type&
+utl::__impl::system<T, R>::entries()
+    { return _entries; }
+
+template<class T, class R>
+inline const typename utl::__impl::system<T, R>::entry_vector_type&
+utl::__impl::system<T, R>::entries() const
+    { return _entries; }
+
+template<class T, class R>
+inline typename utl::__impl::system<T, R>::reference
+utl::__impl::system<T, R>::operator[](
+    const index_type& index)
+{
+    if (index >= _entries.size())
+        grow(index + 1);
+    return _entries[index];
+}
+
+template<class T, class R>
+inline typename utl::__impl::system<T, R>::const_reference
+utl::__impl::system<T, R>::operator[](
+    const index_type& index) const
+{
+    return _entries.at(index);
+}
+
+template<class T, class R>
+inline utl::__impl::system<T, R>::system(size_t limit, double growthFactor) :
+    _firstFree      (invalid_index),
+    _lastFree       (invalid_index),
+    _firstUsed      (invalid_index),
+    _lastUsed       (invalid_index),
+    _freeCount      (0),
+    _usedCount      (0),
+    _limit          (limit),
+    _growthFactor   (growthFactor)
+    { }
+
+template<class T, class R>
+inline utl::__impl::system<T, R>::system(system&& other) :
+    _firstFree      (std::move(other)._firstFree),
+    _lastFree       (std::move(other)._lastFree),
+    _firstUsed      (std::move(other)._firstUsed),
+    _lastUsed       (std::move(other)._lastUsed),
+    _freeCount      (std::move(other)._freeCount),
+    _usedCount      (std::move(other)._usedCount),
+    _limit          (std::move(other)._limit),
+    _growthFactor   (std::move(other)._growthFactor),
+    _entries        (std::move(other)._entries),
+    _recycling      (std::move(other)._recycling)
+    { }
+
+template<class T, class R>
+inline utl::__impl::system<T, R>::system(const system&& other) :
+    _firstFree      (other._firstFree),
+    _lastFree       (other._lastFree),
+    _firstUsed      (other._firstUsed),
+    _lastUsed       (other._lastUsed),
+    _freeCount      (other._freeCount),
+    _usedCount      (other._usedCount),
+    _limit          (other._limit),
+    _growthFactor   (other._growthFactor),
+    _entries        (other._entries),
+    _recycling      (other._recycling)
+    { }
+
+/* SYSTEMS ***************************************************************************************/
+
+template<class T, class R>
+inline typename utl::__impl::systems<T, R>::system_type&
+utl::__impl::systems<T, R>::operator[](
+    const index_type& index)
+{
+    while (index >= _systems.size())
+        _systems.emplace_back(_limit, _growthFactor);
+    return _systems[index];
+}
+
+template<class T, class R>
+inline const typename utl::__impl::systems<T, R>::system_type&
+utl::__impl::systems<T, R>::operator[](
+    const index_type& index) const
+{
+    return _systems[index];
+}
+
+template<class T, class R>
+inline size_t
+utl::__impl::systems<T, R>::size() const
+{
+    return _systems.size();
+}
+
+template<class T, class R>
+inline void
+utl::__impl::systems<T, R>::clear()
+{
+    _systems.clear();
+}
+
+template<class T, class R>
+inline void
+utl::__impl::systems<T, R>::growthFactor(
+    double factor)
+{
+    _growthFactor = factor;
+    for (auto& system : _systems)
+        system.growthFactor(factor);
+}
+
+template<class T, class R>
+inline double
+utl::__impl::systems<T, R>::growthFactor() const
+    { return _growthFactor; }
+
+template<class T, class R>
+inline utl::__impl::systems<T, R>::systems(size_t limit) :
+    _limit          (limit),
+    _growthFactor   (1.0)
+    { }
+
+/* RECYCLING *************************************************************************************/
+
+template<class T_system>
+inline utl::__impl::index_type
+utl::lifo_recycling::acquire(
+    T_system& system)
+    { return system.popFrontFree(); }
+
+template<class T_system>
+inline void
+utl::lifo_recycling::release(
+    T_system& system,
+    __impl::index_type index)
+    { system.pushFrontFree(index); }
+
+template<class T_system, class T_func>
+inline void
+utl::lifo_recycling::acquire_n(
+    T_system& system,
+    size_t count,
+    T_func&& func)
+    { system.moveFreeToUsed(count, std::forward<T_func>(func)); }
+
+inline void
+utl::lifo_recycling::added(
+    __impl::index_type,
+    __impl::index_type)
+    { }
+
+inline void
+utl::lifo_recycling::taken(
+    __impl::index_type)
+    { }
+
+inline void
+utl::lifo_recycling::truncated(
+    size_t)
+    { }
+
+template<class T_system>
+inline void
+utl::lifo_recycling::reset(
+    T_system&)
+    { }
+
+template<size_t Q>
+template<class T_system>
+inline utl::__impl::index_type
+utl::fifo_recycling<Q>::acquire(
+    T_system& system)
+{
+    system.reserveFree(quarantine + 1);
+    return system.popFrontFree();
+}
+
+template<size_t Q>
+template<class T_system>
+inline void
+utl::fifo_recycling<Q>::release(
+    T_system& system,
+    __impl::index_type index)
+    { system.pushBackFree(index); }
+
+template<size_t Q>
+template<class T_system, class T_func>
+inline void
+utl::fifo_recycling<Q>::acquire_n(
+    T_system& system,
+    size_t count,
+    T_func&& func)
+{
+    if (count == 0)
+        return;
+    system.reserveFree(count + quarantine);
+    system.moveFreeToUsed(count, std::forward<T_func>(func));
+}
+
+template<size_t Q>
+inline void
+utl::fifo_recycling<Q>::added(
+    __impl::index_type,
+    __impl::index_type)
     { }
 
-template<class T>
-inline utl::__impl::system<T>::system(const system&& other) :
-    _firstFree  (other._firstFree),
-    _lastFree   (other._lastFree),
-    _firstUsed  (other._firstUsed),
-    _lastUsed   (other._lastUsed),
-    _entries    (other._entries)
+template<size_t Q>
+inline void
+utl::fifo_recycling<Q>::taken(
+    __impl::index_type)
     { }
 
-/* SYSTEMS ***************************************************************************************/
+template<size_t Q>
+inline void
+utl::fifo_recycling<Q>::truncated(
+    size_t)
+    { }
 
-template<class T>
-inline typename utl::__impl::systems<T>::system_type&
-utl::__impl::systems<T>::operator[](
-    const index_type& index)
+template<size_t Q>
+template<class T_system>
+inline void
+utl::fifo_recycling<Q>::reset(
+    T_system&)
+    { }
+
+template<class T_system>
+inline utl::__impl::index_type
+utl::lowest_index_recycling::acquire(
+    T_system& system)
 {
-    if (index >= _systems.size())
-        _systems.resize(index + 1);
-    return _systems[index];
+    using namespace __impl;
+    if (_heap.empty())
+        system.grow();
+    if (_heap.empty())
+        throw exception("handle manager system is full");
+    auto index = _heap.front();
+    std::pop_heap(_heap.begin(), _heap.end(), std::greater<index_type>());
+    _heap.pop_back();
+    assert(system[index].status() == entry_status::free);
+    system.removeFree(index);
+    return index;
 }
 
-template<class T>
-inline const typename utl::__impl::systems<T>::system_type&
-utl::__impl::systems<T>::operator[](
-    const index_type& index) const
+template<class T_system>
+inline void
+utl::lowest_index_recycling::release(
+    T_system& system,
+    __impl::index_type index)
 {
-    return _systems[index];
+    using namespace __impl;
+    system.pushFrontFree(index);
+    _heap.push_back(index);
+    std::push_heap(_heap.begin(), _heap.end(), std::greater<index_type>());
 }
 
-template<class T>
-inline size_t
-utl::__impl::systems<T>::size() const
+template<class T_system, class T_func>
+inline void
+utl::lowest_index_recycling::acquire_n(
+    T_system& system,
+    size_t count,
+    T_func&& func)
 {
-    return _systems.size();
+    system.reserveFree(count);
+    if (system.freeCount() < count)
+        throw exception("handle manager system is full");
+    for (size_t i = 0; i < count; ++i)
+    {
+        auto index = acquire(system);
+        system.pushBackUsed(index);
+        func(index);
+    }
 }
 
-template<class T>
 inline void
-utl::__impl::systems<T>::clear()
+utl::lowest_index_recycling::added(
+    __impl::index_type first,
+    __impl::index_type last)
 {
-    _systems.clear();
+    using namespace __impl;
+    for (auto index = first; index < last; ++index)
+    {
+        _heap.push_back(index);
+        std::push_heap(_heap.begin(), _heap.end(), std::greater<index_type>());
+    }
+}
+
+inline void
+utl::lowest_index_recycling::taken(
+    __impl::index_type index)
+{
+    using namespace __impl;
+    auto it = std::find(_heap.begin(), _heap.end(), index);
+    assert(it != _heap.end());
+    *it = _heap.back();
+    _heap.pop_back();
+    std::make_heap(_heap.begin(), _heap.end(), std::greater<index_type>());
+}
+
+inline void
+utl::lowest_index_recycling::truncated(
+    size_t size)
+{
+    using namespace __impl;
+    _heap.erase(
+        std::remove_if(_heap.begin(), _heap.end(), [size](index_type index) { return index >= size; }),
+        _heap.end());
+    std::make_heap(_heap.begin(), _heap.end(), std::greater<index_type>());
+}
+
+template<class T_system>
+inline void
+utl::lowest_index_recycling::reset(
+    T_system& system)
+{
+    using namespace __impl;
+    _heap.clear();
+    system.forEachFree([this](index_type index) { _heap.push_back(index); });
+    std::make_heap(_heap.begin(), _heap.end(), std::greater<index_type>());
 }
 
 /* handleMANAGER *********************************************************************************/
 
-template<class T>
+template<class T, class L, class E, class R>
 inline bool
-utl::handle_manager<T>::is_valid(
+utl::handle_manager<T, L, E, R>::is_valid(
     const utl::handle& handle) const
 {
     using namespace __impl;
-    auto hd = make_handle_data(handle);
+    auto hd = encoding_type::decode(handle);
     if (hd.system_id >= _systems.size())
         return false;
     auto& system = _systems[hd.system_id];
     if (hd.entry_index >= system.size())
         return false;
-    auto& entry = system[hd.entry_index];
+    auto&& entry = system[hd.entry_index];
     return entry.status() == entry_status::used
         && entry.counter() == hd.counter;
 }
 
-template<class T>
+template<class T, class L, class E, class R>
 inline bool
-utl::handle_manager<T>::try_get(
+utl::handle_manager<T, L, E, R>::try_get(
     const utl::handle& handle,
-    typename utl::handle_manager<T>::value_type& value)
+    typename utl::handle_manager<T, L, E, R>::value_type& value)
 {
     using namespace __impl;
     auto ret = is_valid(handle);
     if (ret)
     {
-        auto hd = make_handle_data(handle);
+        auto hd = encoding_type::decode(handle);
         value = _systems[hd.system_id][hd.entry_index].data();
     }
     return ret;
 }
 
-template<class T>
-inline typename utl::handle_manager<T>::value_type
-utl::handle_manager<T>::get(
+template<class T, class L, class E, class R>
+inline typename utl::handle_manager<T, L, E, R>::value_type
+utl::handle_manager<T, L, E, R>::get(
     const utl::handle& handle)
 {
     value_type ret;
@@ -906,100 +2811,671 @@ utl::handle_manager<T>::get(
     return ret;
 }
 
-template<class T>
+template<class T, class L, class E, class R>
+inline typename utl::handle_manager<T, L, E, R>::value_type*
+utl::handle_manager<T, L, E, R>::try_get_ptr(
+    const utl::handle& handle)
+{
+    if (!is_valid(handle))
+        return nullptr;
+    auto hd = encoding_type::decode(handle);
+    return &_systems[hd.system_id][hd.entry_index].data();
+}
+
+template<class T, class L, class E, class R>
+inline const typename utl::handle_manager<T, L, E, R>::value_type*
+utl::handle_manager<T, L, E, R>::try_get_ptr(
+    const utl::handle& handle) const
+{
+    if (!is_valid(handle))
+        return nullptr;
+    auto hd = encoding_type::decode(handle);
+    return &_systems[hd.system_id][hd.entry_index].data();
+}
+
+template<class T, class L, class E, class R>
+inline typename utl::handle_manager<T, L, E, R>::value_type&
+utl::handle_manager<T, L, E, R>::get_ref(
+    const utl::handle& handle)
+{
+    auto ret = try_get_ptr(handle);
+    if (!ret)
+        throw exception("invalid handle");
+    return *ret;
+}
+
+template<class T, class L, class E, class R>
+inline const typename utl::handle_manager<T, L, E, R>::value_type&
+utl::handle_manager<T, L, E, R>::get_ref(
+    const utl::handle& handle) const
+{
+    auto ret = try_get_ptr(handle);
+    if (!ret)
+        throw exception("invalid handle");
+    return *ret;
+}
+
+template<class T, class L, class E, class R>
 inline bool
-utl::handle_manager<T>::update(
+utl::handle_manager<T, L, E, R>::update(
     const utl::handle& handle,
-    typename utl::handle_manager<T>::value_type value)
+    typename utl::handle_manager<T, L, E, R>::value_type value)
 {
     using namespace __impl;
     if (is_valid(handle))
     {
-        auto hd = make_handle_data(handle);
-        _systems[hd.system_id][hd.entry_index].data(value);
+        auto hd = encoding_type::decode(handle);
+        _systems[hd.system_id][hd.entry_index].data(std::move(value));
         return true;
     }
     return false;
 }
 
-template<class T>
+template<class T, class L, class E, class R>
 inline bool
-utl::handle_manager<T>::set(
+utl::handle_manager<T, L, E, R>::set(
     const utl::handle& handle,
-    typename utl::handle_manager<T>::value_type value)
+    typename utl::handle_manager<T, L, E, R>::value_type value)
 {
     using namespace __impl;
     if (!is_valid(handle))
     {
-        auto  hd     = make_handle_data(handle);
-        auto& system = _systems[hd.system_id];
-        auto& entry  = system[hd.entry_index];
-        bool  ret    = entry.status() == entry_status::free;
+        auto   hd     = encoding_type::decode(handle);
+        auto&  system = _systems[hd.system_id];
+        auto&& entry  = system[hd.entry_index];
+        bool   ret    = entry.status() == entry_status::free;
         if (ret)
         {
-            system.removeFree  (hd.entry_index);
+            system.takeFree    (hd.entry_index);
             system.pushBackUsed(hd.entry_index);
-            entry.assign(value, hd.type_id, hd.counter);
+            entry.assign(std::move(value), hd.type_id, hd.counter != 0 ? hd.counter : next_counter(entry.counter()));
         }
         return ret;
     }
     else
     {
-        return update(handle, value);
+        return update(handle, std::move(value));
     }
 }
 
-template<class T>
+template<class T, class L, class E, class R>
 inline utl::handle
-utl::handle_manager<T>::insert(
+utl::handle_manager<T, L, E, R>::insert(
     const type_id_type& tId,
     const system_id_type& sId,
-    typename utl::handle_manager<T>::value_type value)
+    typename utl::handle_manager<T, L, E, R>::value_type value)
 {
     using namespace __impl;
     auto& system = _systems[sId];
-    auto  index  = system.popFrontFree();
+    auto  index  = system.acquire();
     system.pushBackUsed(index);
-    auto& entry = system[index];
-    entry.assign(value, tId);
-    handle_data hd;
-    hd.entry_index = static_cast<uint32_t>(index);
-    hd.counter    = entry.counter();
-    hd.type_id     = tId,
-    hd.system_id   = sId;
-    return make_handle(hd);
+    auto&& entry = system[index];
+    entry.assign(std::move(value), tId, next_counter(entry.counter()));
+    return make_entry_handle(sId, index, entry);
 }
 
-template<class T>
+template<class T, class L, class E, class R>
+template<class... T_args>
+inline utl::handle
+utl::handle_manager<T, L, E, R>::emplace(
+    const type_id_type& tId,
+    const system_id_type& sId,
+    T_args&&... args)
+{
+    using namespace __impl;
+    auto& system = _systems[sId];
+    auto  index  = system.acquire();
+    auto&& entry = system[index];
+    /* the slot is linked into the used list only after the value was constructed,
+     * a throwing constructor returns it to the free list */
+    try
+    {
+        entry.emplace(tId, next_counter(entry.counter()), std::forward<T_args>(args)...);
+    }
+    catch (...)
+    {
+        system.release(index);
+        throw;
+    }
+    system.pushBackUsed(index);
+    return make_entry_handle(sId, index, entry);
+}
+
+template<class T, class L, class E, class R>
 inline bool
-utl::handle_manager<T>::remove(
+utl::handle_manager<T, L, E, R>::remove(
     const utl::handle& handle)
 {
     using namespace __impl;
     if (!is_valid(handle))
         return false;
-    auto  hd     = make_handle_data(handle);
+    auto  hd     = encoding_type::decode(handle);
     auto& system = _systems[hd.system_id];
+    system[hd.entry_index].reset();
     system.removeUsed(hd.entry_index);
-    system.pushFrontFree(hd.entry_index);
+    system.release(hd.entry_index);
     return true;
 }
 
-template<class T>
-inline typename utl::handle_manager<T>::value_type&
-utl::handle_manager<T>::operator[](
+template<class T, class L, class E, class R>
+template<class T_iterator>
+inline void
+utl::handle_manager<T, L, E, R>::insert_n(
+    const type_id_type& tId,
+    const system_id_type& sId,
+    T_iterator values,
+    size_t count,
+    handle* handles)
+{
+    using namespace __impl;
+    auto& system = _systems[sId];
+    size_t i = 0;
+    std::exception_ptr error;
+
+    /* the system links all entries while they are assigned, so a failed copy must not leave the callback:
+     * the remaining entries are only recorded and everything is released once the entries are linked */
+    system.acquireN(count, [&](index_type index) {
+        auto&& entry = system[index];
+        if (!error)
+        {
+            try
+            {
+                entry.assign(*values, tId, next_counter(entry.counter()));
+                ++values;
+            }
+            catch (...)
+            {
+                error = std::current_exception();
+            }
+        }
+        handles[i] = make_entry_handle(sId, index, entry);
+        ++i;
+    });
+
+    /* release in reverse order, so the free list ends up in its former order */
+    if (error)
+    {
+        for (i = count; i-- > 0; )
+        {
+            auto index = encoding_type::decode(handles[i]).entry_index;
+            system[index].reset();
+            system.removeUsed(index);
+            system.release(index);
+        }
+        std::rethrow_exception(error);
+    }
+}
+
+template<class T, class L, class E, class R>
+inline size_t
+utl::handle_manager<T, L, E, R>::remove_n(
+    const handle* handles,
+    size_t count)
+{
+    using namespace __impl;
+    size_t ret = 0;
+    for (size_t i = 0; i < count; ++i)
+    {
+        auto hd = encoding_type::decode(handles[i]);
+        if (hd.system_id >= _systems.size())
+            continue;
+        auto& system = _systems[hd.system_id];
+        if (hd.entry_index >= system.size())
+            continue;
+        auto&& entry = system[hd.entry_index];
+        if (    entry.status()  != entry_status::used
+            ||  entry.counter() != hd.counter)
+            continue;
+        entry.reset();
+        system.removeUsed(hd.entry_index);
+        system.release(hd.entry_index);
+        ++ret;
+    }
+    return ret;
+}
+
+template<class T, class L, class E, class R>
+inline size_t
+utl::handle_manager<T, L, E, R>::try_get_n(
+    const handle* handles,
+    size_t count,
+    value_type* values,
+    bool* valid) const
+{
+    using namespace __impl;
+    size_t ret     = 0;
+    size_t systems = _systems.size();
+    for (size_t i = 0; i < count; ++i)
+    {
+        auto hd = encoding_type::decode(handles[i]);
+        bool ok = false;
+        if (hd.system_id < systems)
+        {
+            auto& system = _systems[hd.system_id];
+            if (hd.entry_index < system.size())
+            {
+                auto&& entry = system[hd.entry_index];
+                ok = entry.status()  == entry_status::used
+                  && entry.counter() == hd.counter;
+                if (ok)
+                    values[i] = entry.data();
+            }
+        }
+        if (valid)
+            valid[i] = ok;
+        ret += ok ? 1 : 0;
+    }
+    return ret;
+}
+
+template<class T, class L, class E, class R>
+inline typename utl::handle_manager<T, L, E, R>::value_type&
+utl::handle_manager<T, L, E, R>::operator[](
     const utl::handle& handle)
 {
     using namespace __impl;
     if (!is_valid(handle))
         throw exception("invalid handle");
-    auto  hd     = make_handle_data(handle);
-    auto& system = _systems[hd.system_id];
-    auto& entry  = system[hd.entry_index];
-    return entry.data;
+    auto   hd     = encoding_type::decode(handle);
+    auto&  system = _systems[hd.system_id];
+    auto&& entry  = system[hd.entry_index];
+    return entry.data();
 }
 
-template<class T>
+template<class T, class L, class E, class R>
+inline utl::handle_manager<T, L, E, R>::handle_manager() :
+    _systems    (encoding_type::max_index + 1)
+    { }
+
+template<class T, class L, class E, class R>
+inline void
+utl::handle_manager<T, L, E, R>::clear()
+{
+    _systems.clear();
+    _snapshot.reset();
+}
+
+template<class T, class L, class E, class R>
+inline void
+utl::handle_manager<T, L, E, R>::reserve(
+    const system_id_type& sId,
+    size_t size)
+    { _systems[sId].reserve(size); }
+
+template<class T, class L, class E, class R>
+inline void
+utl::handle_manager<T, L, E, R>::growth_factor(
+    double factor)
+{
+    if (factor < 1.0)
+        throw exception("growth factor must not be less than 1.0");
+    _systems.growthFactor(factor);
+}
+
+template<class T, class L, class E, class R>
+inline void
+utl::handle_manager<T, L, E, R>::shrink_to_fit()
+{
+    for (size_t sId = 0; sId < _systems.size(); ++sId)
+        _systems[sId].shrinkToFit();
+}
+
+template<class T, class L, class E, class R>
+inline std::vector<typename utl::handle_manager<T, L, E, R>::memory_stats_type>
+utl::handle_manager<T, L, E, R>::memory_stats() const
+{
+    std::vector<memory_stats_type> ret;
+    ret.reserve(_systems.size());
+    for (size_t sId = 0; sId < _systems.size(); ++sId)
+    {
+        auto& system = _systems[sId];
+        ret.push_back(memory_stats_type {
+            system.size(),
+            system.usedCount(),
+            system.freeCount(),
+            system.bytes(),
+        });
+    }
+    return ret;
+}
+
+template<class T, class L, class E, class R>
+inline typename utl::handle_manager<T, L, E, R>::remap_type
+utl::handle_manager<T, L, E, R>::compact()
+{
+    using namespace __impl;
+    remap_type ret;
+    for (size_t sId = 0; sId < _systems.size(); ++sId)
+    {
+        auto& system = _systems[sId];
+        system.compact([&](index_type from, index_type to) {
+            auto&& src = system[from];
+            auto&& dst = system[to];
+            dst.assign(std::move(src.data()), src.type_id(), next_counter(dst.counter()));
+            ret.emplace_back(make_entry_handle(sId, from, src), make_entry_handle(sId, to, dst));
+            src.reset();
+        });
+    }
+    return ret;
+}
+
+template<class T, class L, class E, class R>
+inline void
+utl::handle_manager<T, L, E, R>::serialize(
+    std::ostream& os) const
+{
+    using namespace __impl;
+    static_assert(std::is_trivially_copyable<value_type>::value, "value type must be trivially copyable to write snapshots");
+
+    auto write = [&os](const void* data, size_t size) {
+        os.write(static_cast<const char*>(data), static_cast<std::streamsize>(size));
+        if (!os)
+            throw exception("unable to write handle manager snapshot: stream error");
+    };
+
+    snapshot_header header;
+    header.magic        = snapshot_magic;
+    header.version      = snapshot_version;
+    header.byte_order   = snapshot_byte_order;
+    header.layout       = store_type::snapshot_layout;
+    header.page_size    = static_cast<uint32_t>(page_size);
+    header.page_bytes   = store_type::page_bytes;
+    header.value_size   = static_cast<uint32_t>(sizeof(value_type));
+    header.index_size   = static_cast<uint32_t>(sizeof(index_type));
+    header.system_count = _systems.size();
+    write(&header, sizeof(header));
+
+    for (size_t sId = 0; sId < _systems.size(); ++sId)
+    {
+        auto state = _systems[sId].state();
+        write(&state, sizeof(state));
+    }
+    std::vector<char> padding(snapshot_data_offset(_systems.size()) - sizeof(header) - _systems.size() * sizeof(snapshot_system));
+    write(padding.data(), padding.size());
+
+    for (size_t sId = 0; sId < _systems.size(); ++sId)
+    {
+        auto& entries = _systems[sId].entries();
+        for (size_t page = 0; page < entries.size() / page_size; ++page)
+            write(entries.page_data(page), store_type::page_bytes);
+    }
+}
+
+template<class T, class L, class E, class R>
+inline void
+utl::handle_manager<T, L, E, R>::deserialize(
+    std::istream& is)
+{
+    auto read = [&is](void* data, size_t size) {
+        if (is.read(static_cast<char*>(data), static_cast<std::streamsize>(size)).gcount() != static_cast<std::streamsize>(size))
+            throw exception("unable to read handle manager snapshot: EOF");
+    };
+    restore(read, [&read](store_type& entries) {
+        read(entries.append(), store_type::page_bytes);
+    });
+    _snapshot.reset();
+}
+
+template<class T, class L, class E, class R>
+inline void
+utl::handle_manager<T, L, E, R>::deserialize(
+    const void* data,
+    size_t size)
+{
+    auto pos  = static_cast<const char*>(data);
+    auto end  = pos + size;
+    auto read = [&pos, end](void* dst, size_t sz) {
+        if (static_cast<size_t>(end - pos) < sz)
+            throw exception("unable to read handle manager snapshot: EOF");
+        memcpy(dst, pos, sz);
+        pos += sz;
+    };
+    restore(read, [&read](store_type& entries) {
+        read(entries.append(), store_type::page_bytes);
+    });
+    _snapshot.reset();
+}
+
+template<class T, class L, class E, class R>
+inline void
+utl::handle_manager<T, L, E, R>::map_snapshot(
+    const std::string& filename)
+{
+    auto file = std::make_shared<mapped_file>(filename, mapped_file::mode::copy_on_write);
+    auto pos  = static_cast<char*>(file->data());
+    auto end  = pos + file->size();
+    auto read = [&pos, end](void* dst, size_t sz) {
+        if (static_cast<size_t>(end - pos) < sz)
+            throw exception("unable to read handle manager snapshot: EOF");
+        memcpy(dst, pos, sz);
+        pos += sz;
+    };
+    restore(read, [&pos, end](store_type& entries) {
+        if (static_cast<size_t>(end - pos) < store_type::page_bytes)
+            throw exception("unable to read handle manager snapshot: EOF");
+        entries.attach(pos);
+        pos += store_type::page_bytes;
+    });
+    _snapshot = std::move(file);
+}
+
+template<class T, class L, class E, class R>
+template<class T_read, class T_read_page>
+inline void
+utl::handle_manager<T, L, E, R>::restore(
+    T_read&& read,
+    T_read_page&& read_page)
+{
+    using namespace __impl;
+    static_assert(std::is_trivially_copyable<value_type>::value, "value type must be trivially copyable to read snapshots");
+    static_assert(alignof(typename store_type::page_type) <= snapshot_alignment, "pages of a snapshot are not aligned");
+
+    snapshot_header header;
+    read(&header, sizeof(header));
+    if (    header.magic        != snapshot_magic
+        ||  header.version      != snapshot_version
+        ||  header.system_count >  static_cast<uint64_t>(std::numeric_limits<system_id_type>::max()) + 1)
+        throw exception("invalid handle manager snapshot");
+    if (    header.byte_order   != snapshot_byte_order
+        ||  header.layout       != store_type::snapshot_layout
+        ||  header.page_size    != page_size
+        ||  header.page_bytes   != store_type::page_bytes
+        ||  header.value_size   != sizeof(value_type)
+        ||  header.index_size   != sizeof(index_type))
+        throw exception("invalid handle manager snapshot: snapshot was written by a manager with a different value type, layout or byte order");
+
+    auto systemCount = static_cast<size_t>(header.system_count);
+    std::vector<snapshot_system> states(systemCount);
+    read(states.data(), systemCount * sizeof(snapshot_system));
+    std::vector<char> padding(snapshot_data_offset(systemCount) - sizeof(header) - systemCount * sizeof(snapshot_system));
+    read(padding.data(), padding.size());
+
+    /* the snapshot is restored into new systems, the manager is only changed if the whole snapshot is valid */
+    size_t       limit = encoding_type::max_index + 1;
+    systems_type systems(limit);
+    systems.growthFactor(_systems.growthFactor());
+    for (size_t sId = 0; sId < systemCount; ++sId)
+    {
+        auto& state = states[sId];
+        if (    state.size % page_size != 0
+            ||  state.size / page_size > (limit + page_size - 1) / page_size)
+            throw exception("invalid handle manager snapshot: invalid system size");
+        auto& system = systems[static_cast<index_type>(sId)];
+        system.restore(state);
+        for (size_t page = 0; page < state.size / page_size; ++page)
+            read_page(system.entries());
+        system.verify();
+        system.resetRecycling();
+    }
+
+    _systems = std::move(systems);
+}
+
+template<class T, class L, class E, class R>
+inline typename utl::handle_manager<T, L, E, R>::iterator
+utl::handle_manager<T, L, E, R>::begin()
+    { return iterator(_systems, 0, _systems.size(), false, 0); }
+
+template<class T, class L, class E, class R>
+inline typename utl::handle_manager<T, L, E, R>::iterator
+utl::handle_manager<T, L, E, R>::end()
+    { return iterator(_systems, _systems.size(), _systems.size(), false, 0); }
+
+template<class T, class L, class E, class R>
+inline typename utl::handle_manager<T, L, E, R>::range
+utl::handle_manager<T, L, E, R>::system_values(
+    const system_id_type& sId)
+{
+    size_t end = std::min<size_t>(static_cast<size_t>(sId) + 1, _systems.size());
+    return range {
+        iterator(_systems, std::min<size_t>(sId, end), end, false, 0),
+        iterator(_systems, end, end, false, 0),
+    };
+}
+
+template<class T, class L, class E, class R>
+inline typename utl::handle_manager<T, L, E, R>::range
+utl::handle_manager<T, L, E, R>::type_values(
+    const type_id_type& tId)
+{
+    return range {
+        iterator(_systems, 0, _systems.size(), true, tId),
+        iterator(_systems, _systems.size(), _systems.size(), true, tId),
+    };
+}
+
+template<class T, class L, class E, class R>
+template<class T_func>
+inline void
+utl::handle_manager<T, L, E, R>::for_each(
+    T_func&& func)
+    { for_each(0, 1, std::forward<T_func>(func)); }
+
+template<class T, class L, class E, class R>
+template<class T_func>
+inline void
+utl::handle_manager<T, L, E, R>::for_each(
+    size_t chunk_index,
+    size_t chunk_count,
+    T_func&& func)
+{
+    using namespace __impl;
+    assert(chunk_index < chunk_count);
+    size_t total = 0;
+    for (size_t sId = 0; sId < _systems.size(); ++sId)
+        total += _systems[sId].size();
+    size_t begin  = total *  chunk_index      / chunk_count;
+    size_t end    = total * (chunk_index + 1) / chunk_count;
+    size_t offset = 0;
+    for (size_t sId = 0; sId < _systems.size() && offset < end; ++sId)
+    {
+        auto& system = _systems[sId];
+        auto  size   = system.size();
+        if (offset + size > begin)
+        {
+            auto first = std::max(begin, offset) - offset;
+            auto last  = std::min(end, offset + size) - offset;
+            for (auto index = first; index < last; ++index)
+            {
+                auto&& entry = system[index];
+                if (entry.status() == entry_status::used)
+                    func(make_entry_handle(sId, index, entry), entry.data());
+            }
+        }
+        offset += size;
+    }
+}
+
+template<class T, class L, class E, class R>
+template<class T_entry>
+inline utl::handle
+utl::handle_manager<T, L, E, R>::make_entry_handle(
+    size_t sId,
+    size_t index,
+    const T_entry& entry)
+    { return __impl::make_entry_handle<encoding_type>(sId, index, entry); }
+
+template<class T, class L, class E, class R>
+inline utl::__impl::counter_type
+utl::handle_manager<T, L, E, R>::next_counter(
+    __impl::counter_type counter)
+    { return __impl::next_counter<encoding_type>(counter); }
+
+/* handleMANAGER ITERATOR ************************************************************************/
+
+template<class T, class L, class E, class R>
 inline void
-utl::handle_manager<T>::clear()
-    { _systems.clear(); }
+utl::handle_manager<T, L, E, R>::iterator::skip()
+{
+    using namespace __impl;
+    while (_system < _system_end)
+    {
+        auto& system = (*_systems)[_system];
+        while (_index < system.size())
+        {
+            auto&& entry = system[_index];
+            if (    entry.status() == entry_status::used
+                && (!_filter_type || entry.type_id() == _type_id))
+                return;
+            ++_index;
+        }
+        ++_system;
+        _index = 0;
+    }
+}
+
+template<class T, class L, class E, class R>
+inline typename utl::handle_manager<T, L, E, R>::iterator::reference
+utl::handle_manager<T, L, E, R>::iterator::operator*() const
+{
+    auto&& entry = (*_systems)[_system][_index];
+    return reference(make_entry_handle(_system, _index, entry), entry.data());
+}
+
+template<class T, class L, class E, class R>
+inline typename utl::handle_manager<T, L, E, R>::iterator&
+utl::handle_manager<T, L, E, R>::iterator::operator++()
+{
+    ++_index;
+    skip();
+    return *this;
+}
+
+template<class T, class L, class E, class R>
+inline typename utl::handle_manager<T, L, E, R>::iterator
+utl::handle_manager<T, L, E, R>::iterator::operator++(int)
+{
+    auto ret = *this;
+    ++*this;
+    return ret;
+}
+
+template<class T, class L, class E, class R>
+inline bool
+utl::handle_manager<T, L, E, R>::iterator::operator==(
+    const iterator& other) const
+{
+    return _system == other._system
+        && _index  == other._index;
+}
+
+template<class T, class L, class E, class R>
+inline bool
+utl::handle_manager<T, L, E, R>::iterator::operator!=(
+    const iterator& other) const
+    { return !(*this == other); }
+
+template<class T, class L, class E, class R>
+inline utl::handle_manager<T, L, E, R>::iterator::iterator(
+    systems_type& systems,
+    size_t system,
+    size_t system_end,
+    bool filter_type,
+    type_id_type tId) :
+    _systems    (&systems),
+    _system     (system),
+    _system_end (system_end),
+    _index      (0),
+    _filter_type(filter_type),
+    _type_id    (tId)
+    { skip(); }
@@ -0,0 +1,754 @@
+#pragma once
+
+#include <array>
+#include <mutex>
+#include <atomic>
+#include <memory>
+#include <vector>
+#include <limits>
+#include <cstdint>
+#include <type_traits>
+
+#include <cpputils/misc/exception.h>
+#include <cpputils/container/handle_manager.h>
+
+namespace utl
+{
+
+    namespace __impl
+    {
+        /* number of bits needed to store the given value */
+        constexpr size_t bit_count(size_t value)
+            { return value == 0 ? 0 : 1 + bit_count(value >> 1); }
+
+        /* free shards of a sharded_handle_manager (shared with the leases of the threads, so a thread can
+         * return its shard after the manager was destroyed) */
+        struct shard_pool
+        {
+            std::mutex          mutex;
+            std::vector<size_t> free;
+        };
+
+        /* shards leased by the calling thread (one per manager), they are returned when the thread exits */
+        struct shard_leases
+        {
+            using pool_ptr_type = std::shared_ptr<shard_pool>;
+
+            std::vector<std::pair<pool_ptr_type, size_t>> leases;
+
+            /* get the shard leased from the given pool (leases a free shard on the first call) */
+            inline size_t get(const pool_ptr_type& pool);
+
+            inline ~shard_leases();
+        };
+
+        inline shard_leases& thread_shard_leases();
+
+        /* page of a shared_entry_pages store. The published state (counter, status and type id) and the values
+         * are atomic, so any thread can resolve handles while the owning thread modifies the page. The list
+         * links and the status of the lists are only accessed by the owning thread. */
+        template<class T_value>
+        struct shared_entry_page
+        {
+        public:
+            using value_type = T_value;
+            using this_type  = shared_entry_page<value_type>;
+
+            struct link_type
+            {
+                index_type      next;
+                index_type      prev;
+                entry_status    status;
+            };
+
+            std::atomic<entry_meta>     meta    [page_size];
+            link_type                   links   [page_size];
+            std::atomic<value_type>     values  [page_size];
+
+            inline shared_entry_page();
+        };
+
+        /* reference to a single entry of a shared_entry_page (provides the same interface as entry). An entry
+         * is only published as used by assign (after its value and its new counter are stored), unlink and
+         * link to the free list publish that the entry is not used anymore. */
+        template<class T_page>
+        struct shared_entry_ref
+        {
+        public:
+            using page_type  = T_page;
+            using value_type = typename std::remove_const<page_type>::type::value_type;
+            using this_type  = shared_entry_ref<page_type>;
+
+        private:
+            page_type*  _page;
+            size_t      _offset;
+
+            inline void publish(entry_status status) const;
+
+        public:
+            inline index_type   next    () const;
+            inline void         next    (index_type value) const;
+            inline index_type   prev    () const;
+            inline void         prev    (index_type value) const;
+            inline entry_status status  () const;
+            inline void         link    (index_type prev, index_type next, entry_status status) const;
+            inline void         unlink  () const;
+            inline counter_type counter () const;
+            inline type_id_type type_id () const;
+            inline entry_meta   meta    () const;
+            inline void         assign  (value_type value, const type_id_type& tId, const counter_type cntr) const;
+            inline value_type   data    () const;
+            inline void         data    (value_type v) const;
+            inline void         reset   () const;
+
+            inline shared_entry_ref(page_type& page, size_t offset);
+        };
+
+        /* entry store of a shard of a sharded_handle_manager. The pages are registered in a page directory that
+         * is sized for Limit entries in advance (blocks of atomic page pointers), so the directory is never
+         * reallocated and readers of other threads can find a page without any lock. Pages are only freed by
+         * the destructor. */
+        template<class T_value, size_t Limit>
+        struct shared_entry_pages
+        {
+        public:
+            using value_type        = T_value;
+            using this_type         = shared_entry_pages<value_type, Limit>;
+            using page_type         = shared_entry_page<value_type>;
+            using reference         = shared_entry_ref<page_type>;
+            using const_reference   = shared_entry_ref<const page_type>;
+
+            static constexpr size_t block_size  = 512;   // number of pages of a block of the page directory
+            static constexpr size_t block_count = (Limit + page_size * block_size - 1) / (page_size * block_size);
+
+        private:
+            struct page_block
+            {
+                std::atomic<page_type*> pages[block_size];
+
+                inline page_block();
+            };
+
+            size_t                                          _size;
+            std::array<std::atomic<page_block*>, block_count> _blocks;
+
+        public:
+            inline size_t           size        () const;
+            inline void             resize      (size_t size);
+            inline size_t           bytes       () const;
+            inline const_reference  at          (const index_type& index) const;
+
+            /* get the page of a given entry (can be called by any thread, nullptr if the page does not exist) */
+            inline const page_type* find        (size_t index) const;
+
+            inline reference        operator[]  (const index_type& index);
+            inline const_reference  operator[]  (const index_type& index) const;
+
+            inline shared_entry_pages();
+            inline ~shared_entry_pages();
+
+            shared_entry_pages(const this_type&) = delete;
+        };
+    }
+
+    /** handle manager that splits the index space of each system into 2^ShardBits shards
+     *
+     *  Each shard has its own systems and is owned by one thread, which inserts and removes the values of
+     *  its shard without any atomic read-modify-write operation or lock (there is no shared free list). A
+     *  thread that inserts without an explicit shard leases a free shard on its first insert and returns it
+     *  when it exits, so two running threads never share a shard. If more threads than shards use the manager
+     *  at the same time, insert throws for the threads that did not get a shard.
+     *
+     *  A shard must only be modified (insert, remove, update) by its owning thread. The shard is stored in
+     *  the highest bits of the entry index, so any thread can resolve any handle (is_valid, try_get, get)
+     *  while the owning threads insert and remove values: the systems and the pages of a shard are never
+     *  moved, and the value, the status and the counter of an entry are published with release stores and
+     *  read with acquire loads (like in concurrent_handle_manager). A handle that is removed while it is
+     *  resolved is either resolved to its value or reported as invalid. Only clear() must not be called
+     *  concurrently to any other method.
+     *
+     *  The value type must be trivially copyable and lock-free in a std::atomic (e.g. pointers or integers).
+     *
+     *  @tparam ShardBits   number of bits of the entry index that are used for the shard */
+    template<class T, size_t ShardBits = 5, class TEncoding = network_handle_encoding, class TRecycling = lifo_recycling>
+    class sharded_handle_manager
+    {
+    public:
+        using value_type            = T;
+        using encoding_type         = TEncoding;
+        using recycling_type        = TRecycling;
+        using this_type             = sharded_handle_manager<value_type, ShardBits, encoding_type, recycling_type>;
+
+        static constexpr size_t shard_bits   = ShardBits;
+        static constexpr size_t shard_count  = size_t(1) << shard_bits;
+        static constexpr size_t index_bits   = __impl::bit_count(encoding_type::max_index);
+        static constexpr size_t shard_shift  = index_bits - shard_bits;
+        static constexpr size_t shard_limit  = size_t(1) << shard_shift;
+        static constexpr size_t system_count = size_t(std::numeric_limits<system_id_type>::max()) + 1;
+
+        using store_type            = __impl::shared_entry_pages<value_type, shard_limit>;
+        using system_type           = __impl::system<store_type, recycling_type>;
+
+        static_assert(shard_bits > 0 && shard_bits < index_bits,    "shard bits must be smaller than the index bits of the encoding");
+        static_assert(std::is_trivially_copyable<value_type>::value, "value type of sharded_handle_manager must be trivially copyable");
+        static_assert(std::atomic<value_type>::is_always_lock_free,  "value type of sharded_handle_manager must be lock-free in std::atomic");
+
+    private:
+        /* the systems are created by the owning thread of the shard on the first insert */
+        struct alignas(64) shard
+        {
+            std::array<std::atomic<system_type*>, system_count> systems;
+
+            inline shard();
+        };
+
+        std::vector<shard>                  _shards;
+        std::shared_ptr<__impl::shard_pool> _pool;
+
+        inline system_type*             find_system (size_t shardId, const system_id_type& sId) const;
+        inline system_type&             get_system  (size_t shardId, const system_id_type& sId);
+        inline const typename store_type::page_type*
+                                        find_page   (const __impl::handle_fields& hd, size_t& offset) const;
+
+    public:
+        /** get the shard of the calling thread (a free shard is leased on the first call of a thread and returned
+         *  when the thread exits, throws if all shards are leased by other threads) */
+        inline size_t current_shard() const;
+
+        /** get the shard a given handle belongs to
+         *  @param handle   handle to get shard for
+         *  @return         shard of the handle */
+        static inline size_t shard_of(const handle& handle);
+
+        /** check if an given handle is valid
+         *  @param handle   handle to check
+         *  @return         TRUE if handle is valid, FALSE otherwise */
+        inline bool is_valid(const handle& handle) const;
+
+        /** try to get the value for a given handle
+         *  @param handle   handle to get value for
+         *  @param value    parameter to store value at
+         *  @return         TRUE on success, FALSE otherwise */
+        inline bool try_get(const handle& handle, value_type& value) const;
+
+        /** get the value for a given handle
+         *  @param handle   handle to get value for
+         *  @return         valid stored for handle */
+        inline value_type get(const handle& handle) const;
+
+        /** update the value of a given handle (only valid handles are accepted, must be called by the owning thread)
+         *  @param handle   handle to update value for
+         *  @param value    new value to store
+         *  @return         TRUE on success, FALSE otherwise (invalid handle) */
+        inline bool update(const handle& handle, value_type value);
+
+        /** insert a new value to the shard of the calling thread
+         *  @param tId      type id of the value
+         *  @param sId      system id of the value
+         *  @param value    value to add
+         *  @return         handle of the stored value */
+        inline handle insert(const type_id_type& tId, const system_id_type& sId, value_type value);
+
+        /** insert a new value to the given shard (must be called by the owning thread of the shard)
+         *  @param shardId  shard to insert value to
+         *  @param tId      type id of the value
+         *  @param sId      system id of the value
+         *  @param value    value to add
+         *  @return         handle of the stored value */
+        inline handle insert(size_t shardId, const type_id_type& tId, const system_id_type& sId, value_type value);
+
+        /** remove the value of a given handle (must be called by the owning thread of the handle's shard)
+         *  @param handle   handle to remove value for
+         *  @return         TRUE on success, FALSE otherwise (handle is invalid) */
+        inline bool remove(const handle& handle);
+
+        /** remove all stored valus and reset the handle manager completely (must not be called concurrently to
+         *  any other method) */
+        inline void clear();
+
+        inline sharded_handle_manager();
+        inline ~sharded_handle_manager();
+
+        sharded_handle_manager(const this_type&) = delete;
+    };
+
+}
+
+/* HELPER ****************************************************************************************/
+
+inline size_t
+utl::__impl::shard_leases::get(
+    const pool_ptr_type& pool)
+{
+    for (auto it = leases.begin(); it != leases.end(); )
+    {
+        if (it->first == pool)
+            return it->second;
+        /* the lease is the last reference to the pool, so the manager was destroyed */
+        if (it->first.use_count() == 1)
+            it = leases.erase(it);
+        else
+            ++it;
+    }
+
+    size_t shard;
+    {
+        std::lock_guard<std::mutex> lock(pool->mutex);
+        if (pool->free.empty())
+            throw exception("all shards of the sharded handle manager are leased by other threads");
+        shard = pool->free.back();
+        pool->free.pop_back();
+    }
+    leases.emplace_back(pool, shard);
+    return shard;
+}
+
+inline utl::__impl::shard_leases::~shard_leases()
+{
+    for (auto& lease : leases)
+    {
+        std::lock_guard<std::mutex> lock(lease.first->mutex);
+        lease.first->free.push_back(lease.second);
+    }
+}
+
+inline utl::__impl::shard_leases&
+utl::__impl::thread_shard_leases()
+{
+    static thread_local shard_leases value;
+    return value;
+}
+
+/* SHARED ENTRY PAGES ****************************************************************************/
+
+template<class T>
+inline utl::__impl::shared_entry_page<T>::shared_entry_page()
+{
+    for (size_t i = 0; i < page_size; ++i)
+    {
+        meta[i].store(entry_meta { 0, entry_status::unknown, 0 }, std::memory_order_relaxed);
+        links[i] = link_type { invalid_index, invalid_index, entry_status::unknown };
+        values[i].store(value_type(), std::memory_order_relaxed);
+    }
+}
+
+template<class T>
+inline void
+utl::__impl::shared_entry_ref<T>::publish(
+    entry_status status) const
+{
+    auto& meta = _page->meta[_offset];
+    auto  m    = meta.load(std::memory_order_relaxed);
+    m.status = status;
+    meta.store(m, std::memory_order_release);
+}
+
+template<class T>
+inline utl::__impl::index_type
+utl::__impl::shared_entry_ref<T>::next() const
+    { return _page->links[_offset].next; }
+
+template<class T>
+inline void
+utl::__impl::shared_entry_ref<T>::next(
+    index_type value) const
+    { _page->links[_offset].next = value; }
+
+template<class T>
+inline utl::__impl::index_type
+utl::__impl::shared_entry_ref<T>::prev() const
+    { return _page->links[_offset].prev; }
+
+template<class T>
+inline void
+utl::__impl::shared_entry_ref<T>::prev(
+    index_type value) const
+    { _page->links[_offset].prev = value; }
+
+template<class T>
+inline utl::__impl::entry_status
+utl::__impl::shared_entry_ref<T>::status() const
+    { return _page->links[_offset].status; }
+
+template<class T>
+inline void
+utl::__impl::shared_entry_ref<T>::link(index_type prev, index_type next, entry_status status) const
+{
+    assert(status != entry_status::unknown);
+    _page->links[_offset] = { next, prev, status };
+    /* a used entry is published by assign, after its counter was incremented */
+    if (status != entry_status::used)
+        publish(status);
+}
+
+template<class T>
+inline void
+utl::__impl::shared_entry_ref<T>::unlink() const
+{
+    _page->links[_offset] = { invalid_index, invalid_index, entry_status::unknown };
+    publish(entry_status::unknown);
+}
+
+template<class T>
+inline utl::__impl::counter_type
+utl::__impl::shared_entry_ref<T>::counter() const
+    { return _page->meta[_offset].load(std::memory_order_relaxed).counter; }
+
+template<class T>
+inline utl::type_id_type
+utl::__impl::shared_entry_ref<T>::type_id() const
+    { return _page->meta[_offset].load(std::memory_order_relaxed).type_id; }
+
+template<class T>
+inline utl::__impl::entry_meta
+utl::__impl::shared_entry_ref<T>::meta() const
+    { return _page->meta[_offset].load(std::memory_order_relaxed); }
+
+template<class T>
+inline void
+utl::__impl::shared_entry_ref<T>::assign(
+    value_type value,
+    const type_id_type& tId,
+    const counter_type cntr) const
+{
+    assert(status() == entry_status::used);
+    _page->values[_offset].store(value, std::memory_order_release);
+    _page->meta[_offset].store(entry_meta { cntr, entry_status::used, tId }, std::memory_order_release);
+}
+
+template<class T>
+inline typename utl::__impl::shared_entry_ref<T>::value_type
+utl::__impl::shared_entry_ref<T>::data() const
+    { return _page->values[_offset].load(std::memory_order_acquire); }
+
+template<class T>
+inline void
+utl::__impl::shared_entry_ref<T>::data(
+    value_type v) const
+    { _page->values[_offset].store(v, std::memory_order_release); }
+
+template<class T>
+inline void
+utl::__impl::shared_entry_ref<T>::reset() const
+    { _page->values[_offset].store(value_type(), std::memory_order_release); }
+
+template<class T>
+inline utl::__impl::shared_entry_ref<T>::shared_entry_ref(page_type& page, size_t offset) :
+    _page   (&page),
+    _offset (offset)
+    { }
+
+template<class T, size_t L>
+inline utl::__impl::shared_entry_pages<T, L>::page_block::page_block()
+{
+    for (auto& page : pages)
+        page.store(nullptr, std::memory_order_relaxed);
+}
+
+template<class T, size_t L>
+inline size_t
+utl::__impl::shared_entry_pages<T, L>::size() const
+    { return _size; }
+
+template<class T, size_t L>
+inline void
+utl::__impl::shared_entry_pages<T, L>::resize(
+    size_t size)
+{
+    assert(size <= block_count * block_size * page_size);
+    while (_size < size)
+    {
+        auto  pageId = _size / page_size;
+        auto& slot   = _blocks[pageId / block_size];
+        auto  block  = slot.load(std::memory_order_relaxed);
+        if (!block)
+        {
+            block = new page_block();
+            slot.store(block, std::memory_order_release);
+        }
+        block->pages[pageId % block_size].store(new page_type(), std::memory_order_release);
+        _size += page_size;
+    }
+}
+
+template<class T, size_t L>
+inline size_t
+utl::__impl::shared_entry_pages<T, L>::bytes() const
+{
+    size_t ret = sizeof(*this) + _size / page_size * sizeof(page_type);
+    for (auto& slot : _blocks)
+    {
+        if (slot.load(std::memory_order_relaxed))
+            ret += sizeof(page_block);
+    }
+    return ret;
+}
+
+template<class T, size_t L>
+inline typename utl::__impl::shared_entry_pages<T, L>::const_reference
+utl::__impl::shared_entry_pages<T, L>::at(
+    const index_type& index) const
+{
+    if (index >= _size)
+        throw exception("index out of range");
+    return (*this)[index];
+}
+
+template<class T, size_t L>
+inline const typename utl::__impl::shared_entry_pages<T, L>::page_type*
+utl::__impl::shared_entry_pages<T, L>::find(
+    size_t index) const
+{
+    auto pageId = index / page_size;
+    if (pageId >= block_count * block_size)
+        return nullptr;
+    auto block = _blocks[pageId / block_size].load(std::memory_order_acquire);
+    return block
+        ? block->pages[pageId % block_size].load(std::memory_order_acquire)
+        : nullptr;
+}
+
+template<class T, size_t L>
+inline typename utl::__impl::shared_entry_pages<T, L>::reference
+utl::__impl::shared_entry_pages<T, L>::operator[](
+    const index_type& index)
+{
+    assert(index < _size);
+    auto pageId = index / page_size;
+    auto block  = _blocks[pageId / block_size].load(std::memory_order_relaxed);
+    return reference(*block->pages[pageId % block_size].load(std::memory_order_relaxed), index % page_size);
+}
+
+template<class T, size_t L>
+inline typename utl::__impl::shared_entry_pages<T, L>::const_reference
+utl::__impl::shared_entry_pages<T, L>::operator[](
+    const index_type& index) const
+{
+    assert(index < _size);
+    return const_reference(*find(index), index % page_size);
+}
+
+template<class T, size_t L>
+inline utl::__impl::shared_entry_pages<T, L>::shared_entry_pages() :
+    _size(0)
+{
+    for (auto& slot : _blocks)
+        slot.store(nullptr, std::memory_order_relaxed);
+}
+
+template<class T, size_t L>
+inline utl::__impl::shared_entry_pages<T, L>::~shared_entry_pages()
+{
+    for (auto& slot : _blocks)
+    {
+        auto block = slot.load(std::memory_order_relaxed);
+        if (!block)
+            continue;
+        for (auto& page : block->pages)
+            delete page.load(std::memory_order_relaxed);
+        delete block;
+    }
+}
+
+/* SHARDED HANDLE MANAGER ************************************************************************/
+
+template<class T, size_t B, class E, class R>
+inline utl::sharded_handle_manager<T, B, E, R>::shard::shard()
+{
+    for (auto& system : systems)
+        system.store(nullptr, std::memory_order_relaxed);
+}
+
+template<class T, size_t B, class E, class R>
+inline typename utl::sharded_handle_manager<T, B, E, R>::system_type*
+utl::sharded_handle_manager<T, B, E, R>::find_system(
+    size_t shardId,
+    const system_id_type& sId) const
+{
+    return shardId < shard_count
+        ? _shards[shardId].systems[sId].load(std::memory_order_acquire)
+        : nullptr;
+}
+
+template<class T, size_t B, class E, class R>
+inline typename utl::sharded_handle_manager<T, B, E, R>::system_type&
+utl::sharded_handle_manager<T, B, E, R>::get_system(
+    size_t shardId,
+    const system_id_type& sId)
+{
+    auto& slot   = _shards[shardId].systems[sId];
+    auto  system = slot.load(std::memory_order_relaxed);
+    if (!system)
+    {
+        system = new system_type(shard_limit);
+        slot.store(system, std::memory_order_release);
+    }
+    return *system;
+}
+
+template<class T, size_t B, class E, class R>
+inline const typename utl::sharded_handle_manager<T, B, E, R>::store_type::page_type*
+utl::sharded_handle_manager<T, B, E, R>::find_page(
+    const __impl::handle_fields& hd,
+    size_t& offset) const
+{
+    auto shardId = static_cast<size_t>(hd.entry_index) >> shard_shift;
+    auto index   = static_cast<size_t>(hd.entry_index) & (shard_limit - 1);
+    auto system  = find_system(shardId, hd.system_id);
+    if (!system)
+        return nullptr;
+    offset = index % __impl::page_size;
+    return system->entries().find(index);
+}
+
+template<class T, size_t B, class E, class R>
+inline size_t
+utl::sharded_handle_manager<T, B, E, R>::current_shard() const
+    { return __impl::thread_shard_leases().get(_pool); }
+
+template<class T, size_t B, class E, class R>
+inline size_t
+utl::sharded_handle_manager<T, B, E, R>::shard_of(
+    const handle& handle)
+    { return static_cast<size_t>(encoding_type::decode(handle).entry_index) >> shard_shift; }
+
+template<class T, size_t B, class E, class R>
+inline bool
+utl::sharded_handle_manager<T, B, E, R>::is_valid(
+    const handle& handle) const
+{
+    using namespace __impl;
+    auto   hd     = encoding_type::decode(handle);
+    size_t offset = 0;
+    auto   page   = find_page(hd, offset);
+    if (!page)
+        return false;
+    auto meta = page->meta[offset].load(std::memory_order_acquire);
+    return meta.status  == entry_status::used
+        && meta.counter == hd.counter;
+}
+
+template<class T, size_t B, class E, class R>
+inline bool
+utl::sharded_handle_manager<T, B, E, R>::try_get(
+    const handle& handle,
+    value_type& value) const
+{
+    using namespace __impl;
+    auto   hd     = encoding_type::decode(handle);
+    size_t offset = 0;
+    auto   page   = find_page(hd, offset);
+    if (!page)
+        return false;
+    auto& meta = page->meta[offset];
+    auto  m    = meta.load(std::memory_order_acquire);
+    if (m.status != entry_status::used || m.counter != hd.counter)
+        return false;
+    auto v = page->values[offset].load(std::memory_order_acquire);
+    // the entry may have been removed (and reused) by the owning thread while we were reading the value,
+    // the fence keeps the second load of the state from being reordered before the load of the value
+    std::atomic_thread_fence(std::memory_order_acquire);
+    m = meta.load(std::memory_order_relaxed);
+    if (m.status != entry_status::used || m.counter != hd.counter)
+        return false;
+    value = v;
+    return true;
+}
+
+template<class T, size_t B, class E, class R>
+inline typename utl::sharded_handle_manager<T, B, E, R>::value_type
+utl::sharded_handle_manager<T, B, E, R>::get(
+    const handle& handle) const
+{
+    value_type ret;
+    if (!try_get(handle, ret))
+        throw exception("invalid handle");
+    return ret;
+}
+
+template<class T, size_t B, class E, class R>
+inline bool
+utl::sharded_handle_manager<T, B, E, R>::update(
+    const handle& handle,
+    value_type value)
+{
+    using namespace __impl;
+    if (!is_valid(handle))
+        return false;
+    auto hd      = encoding_type::decode(handle);
+    auto shardId = static_cast<size_t>(hd.entry_index) >> shard_shift;
+    auto index   = static_cast<size_t>(hd.entry_index) & (shard_limit - 1);
+    (*find_system(shardId, hd.system_id))[index].data(value);
+    return true;
+}
+
+template<class T, size_t B, class E, class R>
+inline utl::handle
+utl::sharded_handle_manager<T, B, E, R>::insert(
+    const type_id_type& tId,
+    const system_id_type& sId,
+    value_type value)
+    { return insert(current_shard(), tId, sId, value); }
+
+template<class T, size_t B, class E, class R>
+inline utl::handle
+utl::sharded_handle_manager<T, B, E, R>::insert(
+    size_t shardId,
+    const type_id_type& tId,
+    const system_id_type& sId,
+    value_type value)
+{
+    using namespace __impl;
+    if (shardId >= shard_count)
+        throw exception("invalid shard");
+    auto& system = get_system(shardId, sId);
+    auto  index  = system.acquire();
+    system.pushBackUsed(index);
+    auto&& entry = system[index];
+    entry.assign(value, tId, next_counter<encoding_type>(entry.counter()));
+    return make_entry_handle<encoding_type>(sId, (shardId << shard_shift) | index, entry);
+}
+
+template<class T, size_t B, class E, class R>
+inline bool
+utl::sharded_handle_manager<T, B, E, R>::remove(
+    const handle& handle)
+{
+    using namespace __impl;
+    if (!is_valid(handle))
+        return false;
+    auto  hd      = encoding_type::decode(handle);
+    auto  shardId = static_cast<size_t>(hd.entry_index) >> shard_shift;
+    auto  index   = static_cast<size_t>(hd.entry_index) & (shard_limit - 1);
+    auto& system  = *find_system(shardId, hd.system_id);
+    /* the entry is published as unused before the value is reset, so readers never see the reset value */
+    system.removeUsed(index);
+    system.release(index);
+    system[index].reset();
+    return true;
+}
+
+template<class T, size_t B, class E, class R>
+inline void
+utl::sharded_handle_manager<T, B, E, R>::clear()
+{
+    for (auto& shard : _shards)
+    {
+        for (auto& system : shard.systems)
+            delete system.exchange(nullptr, std::memory_order_relaxed);
+    }
+}
+
+template<class T, size_t B, class E, class R>
+inline utl::sharded_handle_manager<T, B, E, R>::sharded_handle_manager() :
+    _shards (shard_count),
+    _pool   (std::make_shared<__impl::shard_pool>())
+{
+    /* the shards are leased in ascending order */
+    for (size_t i = shard_count; i > 0; --i)
+        _pool->free.push_back(i - 1);
+}
+
+template<class T, size_t B, class E, class R>
+inline utl::sharded_handle_manager<T, B, E, R>::~sharded_handle_manager()
+    { clear(); }
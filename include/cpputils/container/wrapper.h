@@ -1,5 +1,8 @@
 #pragma once
 
+#include <new>
+#include <utility>
+
 namespace utl
 {
 
@@ -19,7 +22,7 @@ namespace utl
 
         inline wrapper& operator=(value_type v)
         {
-            value = v;
+            value = std::move(v);
             return *this;
         }
 
@@ -35,6 +38,24 @@ namespace utl
             return *this;
         }
 
+        /* destroy the stored value and construct a new one in place; if the constructor throws,
+         * a default constructed value is stored instead */
+        template<class... T_args>
+        inline value_type& emplace(T_args&&... args)
+        {
+            value.~value_type();
+            try
+            {
+                new (&value) value_type(std::forward<T_args>(args)...);
+            }
+            catch (...)
+            {
+                new (&value) value_type();
+                throw;
+            }
+            return value;
+        }
+
         inline wrapper() :
             value(value_type())
             { }
@@ -84,6 +105,12 @@ namespace utl
             return *this;
         }
 
+        inline value_type emplace(value_type v)
+        {
+            value = &v;
+            return v;
+        }
+
         inline wrapper() :
             value(nullptr)
             { }
@@ -0,0 +1,161 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <algorithm>
+#include <memory_resource>
+
+namespace utl
+{
+
+    /** monotonic memory resource that allocates from big blocks of its upstream resource
+     *
+     *  Deallocation is a no-op, the memory is only reused after reset(). Other than
+     *  std::pmr::monotonic_buffer_resource::release() a reset keeps the allocated blocks, so an arena that is
+     *  reset between the evaluations of a recurring task stops allocating from the upstream resource once
+     *  its blocks are big enough. The arena is not thread safe. */
+    class arena
+        : public std::pmr::memory_resource
+    {
+    public:
+        static constexpr size_t default_block_size = 64 * 1024;
+
+    private:
+        struct block
+        {
+            uint8_t*    data;
+            size_t      size;
+        };
+
+        std::pmr::memory_resource*  _upstream;
+        std::vector<block>          _blocks;
+        size_t                      _block_size;
+        size_t                      _current;
+        size_t                      _offset;
+        size_t                      _used;
+
+    protected:
+        void* do_allocate(size_t bytes, size_t alignment) override;
+
+        void do_deallocate(void* p, size_t bytes, size_t alignment) override;
+
+        bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override;
+
+    public:
+        /** number of bytes that were allocated since the last reset */
+        inline size_t used() const;
+
+        /** number of bytes of all blocks that were allocated from the upstream resource */
+        inline size_t capacity() const;
+
+        /** number of blocks that were allocated from the upstream resource */
+        inline size_t block_count() const;
+
+        /** make the memory of all blocks available again (all allocated memory is invalidated) */
+        inline void reset();
+
+        /** return all blocks to the upstream resource (all allocated memory is invalidated) */
+        inline void release();
+
+        inline arena(
+            size_t block_size = default_block_size,
+            std::pmr::memory_resource* upstream = std::pmr::get_default_resource());
+
+        arena(const arena&) = delete;
+
+        arena& operator=(const arena&) = delete;
+
+        inline ~arena();
+    };
+
+}
+
+/* ARENA *****************************************************************************************/
+
+inline void*
+utl::arena::do_allocate(
+    size_t bytes,
+    size_t alignment)
+{
+    while (_current < _blocks.size())
+    {
+        auto& b     = _blocks[_current];
+        auto  addr  = reinterpret_cast<uintptr_t>(b.data) + _offset;
+        auto  pad   = (alignment - (addr & (alignment - 1))) & (alignment - 1);
+        if (_offset + pad + bytes <= b.size)
+        {
+            _offset += pad + bytes;
+            _used   += bytes;
+            return b.data + (_offset - bytes);
+        }
+        ++_current;
+        _offset = 0;
+    }
+
+    /* the size of new blocks grows with the total capacity, so the number of blocks stays logarithmic */
+    auto size = std::max(std::max(_block_size, capacity()), bytes + alignment);
+    auto data = static_cast<uint8_t*>(_upstream->allocate(size, alignof(std::max_align_t)));
+    _blocks.push_back(block { data, size });
+    _current = _blocks.size() - 1;
+    _offset  = 0;
+    return do_allocate(bytes, alignment);
+}
+
+inline void
+utl::arena::do_deallocate(
+    void*,
+    size_t,
+    size_t)
+    { }
+
+inline bool
+utl::arena::do_is_equal(
+    const std::pmr::memory_resource& other) const noexcept
+    { return this == &other; }
+
+inline size_t
+utl::arena::used() const
+    { return _used; }
+
+inline size_t
+utl::arena::capacity() const
+{
+    size_t ret = 0;
+    for (auto& b : _blocks)
+        ret += b.size;
+    return ret;
+}
+
+inline size_t
+utl::arena::block_count() const
+    { return _blocks.size(); }
+
+inline void
+utl::arena::reset()
+{
+    _current = 0;
+    _offset  = 0;
+    _used    = 0;
+}
+
+inline void
+utl::arena::release()
+{
+    for (auto& b : _blocks)
+        _upstream->deallocate(b.data, b.size, alignof(std::max_align_t));
+    _blocks.clear();
+    reset();
+}
+
+inline utl::arena::arena(
+    size_t block_size,
+    std::pmr::memory_resource* upstream) :
+    _upstream   (upstream),
+    _block_size (block_size),
+    _current    (0),
+    _offset     (0),
+    _used       (0)
+    { }
+
+inline utl::arena::~arena()
+    { release(); }
@@ -3,14 +3,26 @@
 #include <set>
 #include <map>
 #include <list>
+#include <deque>
+#include <mutex>
+#include <limits>
+#include <atomic>
+#include <thread>
 #include <vector>
+#include <memory>
 #include <cassert>
+#include <optional>
+#include <iterator>
 #include <algorithm>
+#include <exception>
+#include <functional>
+#include <memory_resource>
+#include <condition_variable>
 
 #include <cpputils/mp/core.h>
+#include <cpputils/misc/simd.h>
 #include <cpputils/misc/exception.h>
 #include <cpputils/container/wrapper.h>
-#include <cpputils/container/nullable.h>
 
 // #define LINQ_DEBUG
 
@@ -53,6 +65,66 @@ namespace linq {
         template<class T>
         using mp_range_value_type = typename utl::mp::remove_ref<T>::value_type;
 
+        template<class T, class = void>
+        struct __impl_is_random_access : public std::false_type { };
+
+        template<class T>
+        struct __impl_is_random_access<T, typename std::enable_if<T::is_random_access>::type> : public std::true_type { };
+
+        /* range provides size() and at(index) for the elements that are not consumed yet */
+        template<class T>
+        using mp_is_random_access = __impl_is_random_access<utl::mp::remove_ref<T>>;
+
+        template<class T, class = void>
+        struct __impl_is_parallel : public std::false_type { };
+
+        template<class T>
+        struct __impl_is_parallel<T, typename std::enable_if<T::is_parallel>::type> : public std::true_type { };
+
+        /* range provides concurrency(), source_size() and slice(first, last) to be evaluated in parallel */
+        template<class T>
+        using mp_is_parallel = __impl_is_parallel<utl::mp::remove_ref<T>>;
+
+        template<class T, class = void>
+        struct __impl_is_contiguous : public std::false_type { };
+
+        template<class T>
+        struct __impl_is_contiguous<T, typename std::enable_if<T::is_contiguous>::type> : public std::true_type { };
+
+        /* random access range that provides data() as pointer to the remaining elements */
+        template<class T>
+        using mp_is_contiguous = __impl_is_contiguous<utl::mp::remove_ref<T>>;
+
+        template<class T, class = void>
+        struct __impl_is_limitable : public std::false_type { };
+
+        template<class T>
+        struct __impl_is_limitable<T, typename std::enable_if<T::is_limitable>::type> : public std::true_type { };
+
+        /* range accepts limit(count) before the first call to next() to produce only the first count elements */
+        template<class T>
+        using mp_is_limitable = __impl_is_limitable<utl::mp::remove_ref<T>>;
+
+        template<class T, class = void>
+        struct __impl_is_pushable : public std::false_type { };
+
+        template<class T>
+        struct __impl_is_pushable<T, typename std::enable_if<T::is_pushable>::type> : public std::true_type { };
+
+        /* range provides push(func) to call func for each remaining element in a loop driven by the range itself */
+        template<class T>
+        using mp_is_pushable = __impl_is_pushable<utl::mp::remove_ref<T>>;
+
+        template<class T, class = void>
+        struct __impl_has_data : public std::false_type { };
+
+        template<class T>
+        struct __impl_has_data<T, decltype(std::data(std::declval<T&>()), void())> : public std::true_type { };
+
+        /* container stores its elements in contiguous memory (std::vector, std::array, std::string, ...) */
+        template<class T>
+        using mp_has_data = __impl_has_data<utl::mp::remove_ref<T>>;
+
         /* helper types **************************************************************************/
         template<class T, class TPredicate>
         struct op_wrapper_less
@@ -78,6 +150,279 @@ namespace linq {
                 { }
         };
 
+        /* memory resource of the active memory_scope of the calling thread (nullptr if there is none) */
+        inline std::pmr::memory_resource*& current_memory_resource()
+        {
+            static thread_local std::pmr::memory_resource* value = nullptr;
+            return value;
+        }
+
+        /* memory resource to use for intermediate buffers (the default resource if no memory_scope is active) */
+        inline std::pmr::memory_resource* memory_resource()
+        {
+            auto ret = current_memory_resource();
+            return ret
+                ? ret
+                : std::pmr::get_default_resource();
+        }
+
+        template<class T>
+        using pmr_vector = std::vector<T, std::pmr::polymorphic_allocator<T>>;
+
+        /* stores the current value of a range in place (references are stored as pointer) */
+        template<class T>
+        struct value_cache
+        {
+            std::optional<T> value;
+
+            template<class X>
+            inline void emplace(X&& x)
+                { value.emplace(std::forward<X>(x)); }
+
+            inline void reset()
+                { value.reset(); }
+
+            inline T& operator*()
+                { return *value; }
+
+            inline explicit operator bool() const
+                { return value.has_value(); }
+        };
+
+        template<class T>
+        struct value_cache<T&>
+        {
+            T* value = nullptr;
+
+            inline void emplace(T& t)
+                { value = &t; }
+
+            inline void reset()
+                { value = nullptr; }
+
+            inline T& operator*()
+                { return *value; }
+
+            inline explicit operator bool() const
+                { return value != nullptr; }
+        };
+
+        /* pull each remaining element of the range and call func for it, random access ranges are
+         * iterated by index without going through next() and front() */
+        template<class TRange, class TFunc>
+        inline void range_pull(TRange& range, TFunc&& func, std::true_type)
+        {
+            using range_value_type = mp_range_value_type<TRange>;
+            auto size = range.size();
+            for (size_t i = 0; i < size; ++i)
+                func(std::forward<range_value_type>(range.at(i)));
+        }
+
+        template<class TRange, class TFunc>
+        inline void range_pull(TRange& range, TFunc&& func, std::false_type)
+        {
+            using range_value_type = mp_range_value_type<TRange>;
+            while (range.next())
+                func(std::forward<range_value_type>(range.front()));
+        }
+
+        /* call func for each remaining element of the range (the range must not be used afterwards).
+         * Pushable ranges (where, select) forward their elements from the loop of their source range, so a
+         * chain of these stages over a container is evaluated in one fused loop over the container */
+        template<class TRange, class TFunc>
+        inline void range_for_each(TRange& range, TFunc&& func, std::true_type)
+            { range.push(std::forward<TFunc>(func)); }
+
+        template<class TRange, class TFunc>
+        inline void range_for_each(TRange& range, TFunc&& func, std::false_type)
+            { range_pull(range, std::forward<TFunc>(func), mp_is_random_access<TRange>()); }
+
+        template<class TRange, class TFunc>
+        inline void range_for_each(TRange& range, TFunc&& func)
+            { range_for_each(range, std::forward<TFunc>(func), mp_is_pushable<TRange>()); }
+
+        /* tell a range that only the first count elements are needed (ignored by most ranges) */
+        template<class TRange>
+        inline void range_limit(TRange& range, size_t count, std::true_type)
+            { range.limit(count); }
+
+        template<class TRange>
+        inline void range_limit(TRange&, size_t, std::false_type)
+            { }
+
+        template<class TRange>
+        inline void range_limit(TRange& range, size_t count)
+            { range_limit(range, count, mp_is_limitable<TRange>()); }
+
+        /* number of remaining elements of a random access range or the passed default */
+        template<class TRange>
+        inline size_t range_size_hint(TRange& range, size_t, std::true_type)
+            { return range.size(); }
+
+        template<class TRange>
+        inline size_t range_size_hint(TRange&, size_t value, std::false_type)
+            { return value; }
+
+        template<class TRange>
+        inline size_t range_size_hint(TRange& range, size_t value)
+            { return range_size_hint(range, value, mp_is_random_access<TRange>()); }
+
+        /* collect the elements of the range (converted by make) in values and order them by less,
+         * if max_count is limited only the smallest max_count elements are kept in a bounded heap */
+        template<class TVector, class TRange, class TMake, class TLess>
+        inline void collect_ordered(TVector& values, TRange& range, size_t max_count, TMake&& make, TLess&& less)
+        {
+            values.clear();
+            if (max_count == std::numeric_limits<size_t>::max())
+            {
+                values.reserve(range_size_hint(range, 0));
+                while (range.next())
+                    values.emplace_back(make(range.front()));
+                std::sort(values.begin(), values.end(), less);
+            }
+            else if (max_count > 0)
+            {
+                while (range.next())
+                {
+                    if (values.size() < max_count)
+                    {
+                        values.emplace_back(make(range.front()));
+                        std::push_heap(values.begin(), values.end(), less);
+                        continue;
+                    }
+                    auto value = make(range.front());
+                    if (less(value, values.front()))
+                    {
+                        std::pop_heap(values.begin(), values.end(), less);
+                        values.back() = std::move(value);
+                        std::push_heap(values.begin(), values.end(), less);
+                    }
+                }
+                std::sort_heap(values.begin(), values.end(), less);
+            }
+        }
+
+        /* pool of worker threads that is used to evaluate parallel ranges */
+        struct thread_pool
+        {
+        private:
+            struct job
+            {
+                std::atomic<size_t>     next;
+                size_t                  done;
+                size_t                  count;
+                std::exception_ptr      error;
+                std::mutex              mutex;
+                std::condition_variable cond;
+            };
+
+            std::mutex                          _mutex;
+            std::condition_variable             _cond;
+            std::deque<std::function<void()>>   _tasks;
+            std::vector<std::thread>            _threads;
+            bool                                _shutdown;
+
+            inline void worker()
+            {
+                while (true)
+                {
+                    std::function<void()> task;
+                    {
+                        std::unique_lock<std::mutex> lock(_mutex);
+                        _cond.wait(lock, [this]{
+                            return _shutdown || !_tasks.empty();
+                        });
+                        if (_tasks.empty())
+                            return;
+                        task = std::move(_tasks.front());
+                        _tasks.pop_front();
+                    }
+                    task();
+                }
+            }
+
+            template<class TFunc>
+            static inline void execute(job& j, TFunc& func)
+            {
+                size_t index;
+                while ((index = j.next.fetch_add(1, std::memory_order_relaxed)) < j.count)
+                {
+                    std::exception_ptr error;
+                    try
+                    {
+                        func(index);
+                    }
+                    catch (...)
+                    {
+                        error = std::current_exception();
+                    }
+                    std::lock_guard<std::mutex> lock(j.mutex);
+                    if (error && !j.error)
+                        j.error = error;
+                    if (++j.done == j.count)
+                        j.cond.notify_all();
+                }
+            }
+
+        public:
+            /** execute func(index) for each index in [0, count), the calling thread takes part in the execution
+             *  @param count    number of indices to execute
+             *  @param func     function to execute (must be thread safe) */
+            template<class TFunc>
+            inline void run(size_t count, TFunc& func)
+            {
+                if (count == 0)
+                    return;
+
+                auto j = std::make_shared<job>();
+                j->next  = 0;
+                j->done  = 0;
+                j->count = count;
+                {
+                    std::lock_guard<std::mutex> lock(_mutex);
+                    while (_threads.size() + 1 < count)
+                        _threads.emplace_back(&thread_pool::worker, this);
+                    for (size_t i = 1; i < count; ++i)
+                    {
+                        _tasks.emplace_back([j, &func]{
+                            execute(*j, func);
+                        });
+                    }
+                }
+                _cond.notify_all();
+
+                execute(*j, func);
+
+                std::unique_lock<std::mutex> lock(j->mutex);
+                j->cond.wait(lock, [&j]{
+                    return j->done == j->count;
+                });
+                if (j->error)
+                    std::rethrow_exception(j->error);
+            }
+
+            static inline thread_pool& instance()
+            {
+                static thread_pool value;
+                return value;
+            }
+
+            inline thread_pool() :
+                _shutdown(false)
+                { }
+
+            inline ~thread_pool()
+            {
+                {
+                    std::lock_guard<std::mutex> lock(_mutex);
+                    _shutdown = true;
+                }
+                _cond.notify_all();
+                for (auto& t : _threads)
+                    t.join();
+            }
+        };
+
         template<class TRange>
         struct range_wrapper
         {
@@ -126,8 +471,8 @@ namespace linq {
             using wrapped_key_type      = utl::wrapper<key_type>;
             using wrapped_value_type    = utl::wrapper<value_type>;
             using keys_value_type       = std::pair<wrapped_key_type, size_t>;
-            using keys_type             = std::vector<keys_value_type>;
-            using values_type           = std::vector<wrapped_value_type>;
+            using keys_type             = pmr_vector<keys_value_type>;
+            using values_type           = pmr_vector<wrapped_value_type>;
             using range_indices_type    = std::pair<size_t, size_t>;
 
             struct lookup_range;
@@ -146,11 +491,20 @@ namespace linq {
                     finished,
                 };
 
+                static constexpr bool is_random_access = true;
+
                 values_type&    values;
                 size_t          current;
                 size_t          end;
                 state_type      state;
 
+                inline size_t upcoming() const
+                {
+                    return state == state_type::iterating
+                        ? current + 1
+                        : current;
+                }
+
                 inline value_type& front()
                 {
                     assert(state == state_type::iterating);
@@ -158,6 +512,16 @@ namespace linq {
                     return *values[current];
                 }
 
+                inline size_t size() const
+                {
+                    return state == state_type::finished
+                        ? 0
+                        : end - std::min(end, upcoming());
+                }
+
+                inline value_type& at(size_t index) const
+                    { return *values[upcoming() + index]; }
+
                 inline bool next()
                 {
                     switch (state)
@@ -196,6 +560,14 @@ namespace linq {
                     state   (other.state)
                     { LINQ_COPY_CTOR(); }
 
+                /* copy of the given range that refers to the values of another (copied) lookup */
+                inline lookup_range(values_type& v, const lookup_range& other) :
+                    values  (v),
+                    current (other.current),
+                    end     (other.end),
+                    state   (other.state)
+                    { LINQ_COPY_CTOR(); }
+
                 inline lookup_range(lookup_range&& other) :
                     values  (std::move(other).values),
                     current (std::move(other).current),
@@ -327,17 +699,19 @@ namespace linq {
 
         private:
             inline lookup(keys_type&& k, values_type&& v) :
-                _keys   (k),
-                _values (v)
+                _keys   (std::move(k)),
+                _values (std::move(v))
                 { LINQ_CTOR(); }
 
         public:
-            inline lookup()
+            inline lookup() :
+                _keys   (memory_resource()),
+                _values (memory_resource())
                 { LINQ_CTOR(); }
 
             inline lookup(const lookup& other) :
-                _keys   (other._keys),
-                _values (other._values)
+                _keys   (other._keys,   other._keys.get_allocator()),
+                _values (other._values, other._values.get_allocator())
                 { LINQ_COPY_CTOR(); }
 
             inline lookup(lookup&& other) :
@@ -352,8 +726,8 @@ namespace linq {
             template<class TRange, class TKeyPredicate, class TValuePredicate>
             static inline auto build(TRange& range, TKeyPredicate& kp, TValuePredicate& vp)
             {
-                keys_type   k;
-                values_type v;
+                keys_type   k(memory_resource());
+                values_type v(memory_resource());
 
                 size_t index = 0;
                 while (range.next())
@@ -367,8 +741,8 @@ namespace linq {
 
                 std::sort(k.begin(), k.end(), op_compare_keys());
 
-                keys_type keys;
-                values_type values;
+                keys_type   keys  (memory_resource());
+                values_type values(memory_resource());
 
                 keys.reserve  (k.size());
                 values.reserve(k.size());
@@ -400,6 +774,275 @@ namespace linq {
             }
         };
 
+        /* open addressing hash index (linear probing) that assigns consecutive ids to the inserted keys,
+         * the keys and their hashes are stored densely in the order of insertion */
+        template<class TKey, class THash, class TEqual>
+        struct flat_hash_index
+        {
+            using key_type          = TKey;
+            using clean_key_type    = utl::mp::remove_ref<key_type>;
+            using hash_type         = THash;
+            using equal_type        = TEqual;
+            using this_type         = flat_hash_index<key_type, hash_type, equal_type>;
+            using wrapped_key_type  = utl::wrapper<key_type>;
+            using keys_type         = pmr_vector<wrapped_key_type>;
+
+            static constexpr size_t npos         = std::numeric_limits<size_t>::max();
+            static constexpr size_t min_capacity = 16;
+
+            hash_type               hash;
+            equal_type              equal;
+            keys_type               keys;
+            pmr_vector<size_t>      hashes;
+            pmr_vector<size_t>      slots;      // id of the key + 1 (0 = empty slot)
+            size_t                  shift;
+
+            inline size_t slot_of(size_t h) const
+                { return static_cast<size_t>((static_cast<uint64_t>(h) * 0x9E3779B97F4A7C15ull) >> shift); }
+
+            inline void grow()
+            {
+                auto capacity = slots.empty() ? min_capacity : 2 * slots.size();
+                auto mask     = capacity - 1;
+                shift = 64;
+                for (auto c = capacity; c > 1; c >>= 1)
+                    --shift;
+                slots.assign(capacity, 0);
+                for (size_t id = 0; id < keys.size(); ++id)
+                {
+                    auto s = slot_of(hashes[id]);
+                    while (slots[s] != 0)
+                        s = (s + 1) & mask;
+                    slots[s] = id + 1;
+                }
+            }
+
+            inline size_t size() const
+                { return keys.size(); }
+
+            inline size_t find(const clean_key_type& key) const
+            {
+                if (keys.empty())
+                    return npos;
+                auto h    = static_cast<size_t>(hash(key));
+                auto mask = slots.size() - 1;
+                for (auto s = slot_of(h); slots[s] != 0; s = (s + 1) & mask)
+                {
+                    auto id = slots[s] - 1;
+                    if (hashes[id] == h && equal(*keys[id], key))
+                        return id;
+                }
+                return npos;
+            }
+
+            /* returns the id of the key and TRUE if the key was inserted, FALSE if it was already known */
+            template<class K>
+            inline std::pair<size_t, bool> insert(K&& key)
+            {
+                if (2 * (keys.size() + 1) > slots.size())
+                    grow();
+                auto h    = static_cast<size_t>(hash(key));
+                auto mask = slots.size() - 1;
+                auto s    = slot_of(h);
+                for (; slots[s] != 0; s = (s + 1) & mask)
+                {
+                    auto id = slots[s] - 1;
+                    if (hashes[id] == h && equal(*keys[id], key))
+                        return std::make_pair(id, false);
+                }
+                keys.emplace_back(std::forward<K>(key));
+                hashes.push_back(h);
+                slots[s] = keys.size();
+                return std::make_pair(keys.size() - 1, true);
+            }
+
+            template<class H, class E>
+            inline flat_hash_index(H&& h, E&& e) :
+                hash    (std::forward<H>(h)),
+                equal   (std::forward<E>(e)),
+                keys    (memory_resource()),
+                hashes  (memory_resource()),
+                slots   (memory_resource()),
+                shift   (64)
+                { }
+
+            inline flat_hash_index(const this_type& other) :
+                hash    (other.hash),
+                equal   (other.equal),
+                keys    (other.keys,   other.keys.get_allocator()),
+                hashes  (other.hashes, other.hashes.get_allocator()),
+                slots   (other.slots,  other.slots.get_allocator()),
+                shift   (other.shift)
+                { }
+
+            inline flat_hash_index(this_type&&) = default;
+        };
+
+        /* lookup that stores its keys in a flat_hash_index, the values of each key are stored
+         * contiguously (in the order of the source range) and the keys are iterated in the order
+         * of their first occurence */
+        template<class TKey, class TValue, class THash, class TEqual>
+        struct hash_lookup
+        {
+        public:
+            using key_type              = TKey;
+            using clean_key_type        = utl::mp::remove_ref<key_type>;
+            using value_type            = TValue;
+            using hash_type             = THash;
+            using equal_type            = TEqual;
+            using this_type             = hash_lookup<key_type, value_type, hash_type, equal_type>;
+            using index_type            = flat_hash_index<key_type, hash_type, equal_type>;
+            using base_lookup_type      = lookup<key_type, value_type>;
+            using values_type           = typename base_lookup_type::values_type;
+            using lookup_range          = typename base_lookup_type::lookup_range;
+            using lookup_range_wrapper  = typename base_lookup_type::lookup_range_wrapper;
+
+            struct lookup_key_value_range;
+
+            using lookup_key_value_range_wrapper = range_wrapper<lookup_key_value_range>;
+
+            struct lookup_key_value_range : public tag_range
+            {
+                using value_type = std::pair<key_type, lookup_range_wrapper>;
+
+                hash_lookup container;
+                bool        initialized;
+                size_t      current;
+
+                inline value_type front()
+                {
+                    assert(initialized);
+                    assert(current < container._index.size());
+                    return value_type(
+                        *container._index.keys[current],
+                        container.createRange(current));
+                }
+
+                inline bool next()
+                {
+                    if (!initialized)
+                        initialized = true;
+                    else if (current < container._index.size())
+                        ++current;
+                    return current < container._index.size();
+                }
+
+                template<class C>
+                lookup_key_value_range(C&& c) :
+                    container   (std::forward<C>(c)),
+                    initialized (false),
+                    current     (0)
+                    { LINQ_CTOR(); }
+
+                lookup_key_value_range(const lookup_key_value_range& other) :
+                    container   (other.container),
+                    initialized (other.initialized),
+                    current     (other.current)
+                    { LINQ_COPY_CTOR(); }
+
+                lookup_key_value_range(lookup_key_value_range&& other) :
+                    container   (std::move(other).container),
+                    initialized (std::move(other).initialized),
+                    current     (std::move(other).current)
+                    { LINQ_MOVE_CTOR(); }
+
+                ~lookup_key_value_range()
+                    { LINQ_DTOR(); }
+            };
+
+        private:
+            index_type          _index;
+            pmr_vector<size_t>  _offsets;   // first value of each key (+ end of the last key)
+            values_type         _values;
+
+            inline lookup_range_wrapper createRange(size_t id)
+            {
+                return id < _index.size()
+                    ? lookup_range_wrapper(_values, _offsets[id], _offsets[id + 1])
+                    : lookup_range_wrapper(_values, 0, 0);
+            }
+
+        public:
+            /** number of distinct keys */
+            inline size_t size() const
+                { return _index.size(); }
+
+            inline lookup_range_wrapper operator[](const clean_key_type& key)
+                { return createRange(_index.find(key)); }
+
+            /** create a copy of a range of a copied or moved lookup, that refers to the values of this lookup */
+            inline lookup_range_wrapper rebind(const lookup_range_wrapper& range)
+                { return lookup_range_wrapper(_values, range.range); }
+
+            template<class TBuilder>
+            inline auto operator >> (TBuilder&& builder) &
+                { return builder.build(lookup_key_value_range(*this)); }
+
+            template<class TBuilder>
+            inline auto operator >> (TBuilder&& builder) &&
+                { return builder.build(lookup_key_value_range(std::move(*this))); }
+
+        private:
+            inline hash_lookup(index_type&& i, pmr_vector<size_t>&& o, values_type&& v) :
+                _index      (std::move(i)),
+                _offsets    (std::move(o)),
+                _values     (std::move(v))
+                { LINQ_CTOR(); }
+
+        public:
+            inline hash_lookup(const hash_lookup& other) :
+                _index      (other._index),
+                _offsets    (other._offsets, other._offsets.get_allocator()),
+                _values     (other._values,  other._values.get_allocator())
+                { LINQ_COPY_CTOR(); }
+
+            inline hash_lookup(hash_lookup&& other) :
+                _index      (std::move(other)._index),
+                _offsets    (std::move(other)._offsets),
+                _values     (std::move(other)._values)
+                { LINQ_MOVE_CTOR(); }
+
+            inline ~hash_lookup()
+                { LINQ_DTOR(); }
+
+        public:
+            template<class TRange, class TKeyPredicate, class TValuePredicate>
+            static inline auto build(TRange& range, TKeyPredicate& kp, TValuePredicate& vp, const hash_type& h, const equal_type& e)
+            {
+                index_type          index(h, e);
+                pmr_vector<size_t>  ids(memory_resource());
+                values_type         v(memory_resource());
+
+                auto hint = range_size_hint(range, 0);
+                ids.reserve(hint);
+                v.reserve(hint);
+                while (range.next())
+                {
+                    ids.push_back(index.insert(kp(range.front())).first);
+                    v.emplace_back(vp(range.front()));
+                }
+
+                /* counting sort of the values by the id of their key (stable) */
+                pmr_vector<size_t> offsets(index.size() + 1, 0, memory_resource());
+                for (auto id : ids)
+                    ++offsets[id + 1];
+                for (size_t i = 1; i < offsets.size(); ++i)
+                    offsets[i] += offsets[i - 1];
+
+                pmr_vector<size_t> order(v.size(), memory_resource());
+                pmr_vector<size_t> pos(offsets.begin(), offsets.end() - 1, memory_resource());
+                for (size_t i = 0; i < ids.size(); ++i)
+                    order[pos[ids[i]]++] = i;
+
+                values_type values(memory_resource());
+                values.reserve(v.size());
+                for (auto i : order)
+                    values.push_back(std::move(v[i]));
+
+                return hash_lookup(std::move(index), std::move(offsets), std::move(values));
+            }
+        };
+
         /* ranges ********************************************************************************/
         template<class TIterator>
         struct iterator_range : public tag_range
@@ -407,11 +1050,22 @@ namespace linq {
             using iterator_type = TIterator;
             using this_type     = iterator_range<iterator_type>;
             using value_type    = decltype(*std::declval<iterator_type>());
+            using category_type = typename std::iterator_traits<iterator_type>::iterator_category;
+
+            static constexpr bool is_random_access = std::is_base_of<std::random_access_iterator_tag, category_type>::value;
+            static constexpr bool is_contiguous    = std::is_pointer<iterator_type>::value;
 
             bool            initialized;
             iterator_type   current;
             iterator_type   end;
 
+            inline iterator_type upcoming() const
+            {
+                return !initialized || current == end
+                    ? current
+                    : std::next(current);
+            }
+
             inline value_type& front()
             {
                 assert(initialized);
@@ -419,6 +1073,15 @@ namespace linq {
                 return *current;
             }
 
+            inline size_t size() const
+                { return static_cast<size_t>(std::distance(upcoming(), end)); }
+
+            inline value_type& at(size_t index) const
+                { return *(upcoming() + static_cast<ssize_t>(index)); }
+
+            inline auto data() const
+                { return upcoming(); }
+
             inline bool next()
             {
                 if (!initialized)
@@ -458,13 +1121,27 @@ namespace linq {
         {
             using container_type    = TContainer;
             using this_type         = container_range<container_type>;
-            using iterator_type     = decltype(std::begin(std::declval<container_type>()));
+            using iterator_type     = decltype(std::begin(std::declval<container_type&>()));
             using value_type        = decltype(*std::declval<iterator_type>());
 
+            using category_type     = typename std::iterator_traits<iterator_type>::iterator_category;
+
+            static constexpr bool is_random_access = std::is_base_of<std::random_access_iterator_tag, category_type>::value;
+            static constexpr bool is_contiguous    = is_random_access && mp_has_data<container_type>::value;
+
             TContainer      container;
             bool            initialized;
             iterator_type   current;
 
+            inline iterator_type upcoming()
+            {
+                if (!initialized)
+                    return std::begin(container);
+                return current == std::end(container)
+                    ? current
+                    : std::next(current);
+            }
+
             inline value_type& front()
             {
                 assert(initialized);
@@ -472,6 +1149,15 @@ namespace linq {
                 return *current;
             }
 
+            inline size_t size()
+                { return static_cast<size_t>(std::distance(upcoming(), std::end(container))); }
+
+            inline value_type& at(size_t index)
+                { return *(upcoming() + static_cast<ssize_t>(index)); }
+
+            inline auto data()
+                { return std::data(container) + std::distance(std::begin(container), upcoming()); }
+
             inline bool next()
             {
                 if (!initialized)
@@ -492,16 +1178,29 @@ namespace linq {
                 initialized (false)
                 { LINQ_CTOR(); }
 
+            /* an owned container is copied or moved with the range, so the current iterator is re-created from
+             * its offset (which is taken before the container of the other range is moved) */
+            inline ssize_t offset() const
+            {
+                /* the container is not modified, the cast only selects the same iterator type as current */
+                auto& c = const_cast<container_type&>(container);
+                return initialized ? static_cast<ssize_t>(std::distance(std::begin(c), current)) : 0;
+            }
+
             inline container_range(const this_type& other) noexcept :
                 container   (other.container),
                 initialized (other.initialized),
-                current     (other.current)
+                current     (std::next(std::begin(container), other.offset()))
                 { LINQ_COPY_CTOR(); }
 
             inline container_range(this_type&& other) noexcept :
+                container_range(std::move(other), other.offset())
+                { }
+
+            inline container_range(this_type&& other, ssize_t offset) noexcept :
                 container   (std::move(other).container),
                 initialized (std::move(other).initialized),
-                current     (std::move(other).current)
+                current     (std::next(std::begin(container), offset))
                 { LINQ_MOVE_CTOR(); }
 
             inline ~container_range()
@@ -563,6 +1262,9 @@ namespace linq {
             using this_type         = where_range<range_type, predicate_type>;
             using value_type        = mp_range_value_type<range_type>;
 
+            static constexpr bool is_parallel = mp_is_parallel<range_type>::value;
+            static constexpr bool is_pushable = true;
+
             range_type      range;
             predicate_type  predicate;
 
@@ -579,6 +1281,27 @@ namespace linq {
                 return false;
             }
 
+            template<class TFunc>
+            inline void push(TFunc&& func)
+            {
+                range_for_each(range, [this, &func](auto&& value) {
+                    if (predicate(value))
+                        func(std::forward<decltype(value)>(value));
+                });
+            }
+
+            inline size_t concurrency()
+                { return range.concurrency(); }
+
+            inline size_t source_size()
+                { return range.source_size(); }
+
+            inline auto slice(size_t first, size_t last)
+            {
+                using slice_type = where_range<decltype(range.slice(first, last)), predicate_type>;
+                return slice_type(range.slice(first, last), predicate);
+            }
+
             template<class R, class P>
             inline where_range(R&& r, P&& p) :
                 range       (std::forward<R>(r)),
@@ -610,7 +1333,11 @@ namespace linq {
             using this_type         = select_range<range_type, predicate_type>;
             using range_value_type  = mp_range_value_type<range_type>;
             using value_type        = decltype(std::declval<predicate_type>()(std::declval<range_value_type>()));
-            using cache_type        = utl::nullable<value_type>;
+            using cache_type        = value_cache<value_type>;
+
+            static constexpr bool is_parallel      = mp_is_parallel<range_type>::value;
+            static constexpr bool is_random_access = mp_is_random_access<range_type>::value;
+            static constexpr bool is_pushable      = true;
 
             predicate_type  predicate;
             range_type      range;
@@ -626,13 +1353,39 @@ namespace linq {
             {
                 if (range.next())
                 {
-                    cache = predicate(range.front());
+                    cache.emplace(predicate(range.front()));
                     return true;
                 }
                 cache.reset();
                 return false;
             }
 
+            inline size_t size()
+                { return range.size(); }
+
+            inline value_type at(size_t index)
+                { return predicate(range.at(index)); }
+
+            template<class TFunc>
+            inline void push(TFunc&& func)
+            {
+                range_for_each(range, [this, &func](auto&& value) {
+                    func(predicate(value));
+                });
+            }
+
+            inline size_t concurrency()
+                { return range.concurrency(); }
+
+            inline size_t source_size()
+                { return range.source_size(); }
+
+            inline auto slice(size_t first, size_t last)
+            {
+                using slice_type = select_range<decltype(range.slice(first, last)), predicate_type>;
+                return slice_type(range.slice(first, last), predicate);
+            }
+
             template<class R, class P>
             inline select_range(R&& r, P&& p) :
                 range       (std::forward<R>(r)),
@@ -671,7 +1424,7 @@ namespace linq {
 
             using range_type                = TRange;
             using predicate_type            = TPredicate;
-            using this_type                 = where_range<range_type, predicate_type>;
+            using this_type                 = select_many_range<range_type, predicate_type>;
             using range_value_type          = mp_range_value_type<range_type>;
             using predicate_return_type     = decltype(std::declval<predicate_type>()(std::declval<range_value_type>()));
             using inner_range_type          = utl::mp::eval_if_t<
@@ -679,7 +1432,7 @@ namespace linq {
                                                 predicate_return_type,
                                                 mp_make_inner_range, predicate_return_type>;
             using value_type                = mp_range_value_type<inner_range_type>;
-            using inner_range_cache_type    = utl::nullable<inner_range_type>;
+            using inner_range_cache_type    = value_cache<inner_range_type>;
 
             predicate_type          predicate;
             range_type              range;
@@ -688,28 +1441,28 @@ namespace linq {
             template<class T>
             inline typename std::enable_if<std::is_base_of<tag_range, T>::value>::type
             build_inner_range(T&& value)
-                { inner_range = value; }
+                { inner_range.emplace(std::forward<T>(value)); }
 
             template<class T>
             inline typename std::enable_if<!std::is_base_of<tag_range, T>::value>::type
             build_inner_range(T&& value)
-                { inner_range = inner_range_type(std::forward<T>(value)); }
+                { inner_range.emplace(std::forward<T>(value)); }
 
             inline value_type& front()
             {
                 assert(inner_range);
-                return inner_range->front();
+                return (*inner_range).front();
             }
 
             inline bool next()
             {
-                if (inner_range && inner_range->next())
+                if (inner_range && (*inner_range).next())
                     return true;
                 while (range.next())
                 {
                     inner_range.reset();
                     build_inner_range<predicate_return_type>(predicate(range.front()));
-                    if (inner_range && inner_range->next())
+                    if (inner_range && (*inner_range).next())
                         return true;
                 }
                 inner_range.reset();
@@ -750,12 +1503,15 @@ namespace linq {
             using this_type             = order_by_range<range_type, select_predicate_type, less_predicate_type>;
             using value_type            = mp_range_value_type<range_type>;
             using wrapped_value_type    = utl::wrapper<value_type>;
-            using vector_type           = std::vector<wrapped_value_type>;
+            using vector_type           = pmr_vector<wrapped_value_type>;
+
+            static constexpr bool is_limitable = true;
 
             range_type              range;
             select_predicate_type   select_predicate;
             less_predicate_type     less_predicate;
             ssize_t                 current;
+            size_t                  max_count;
             vector_type             values;
 
             inline value_type& front()
@@ -764,25 +1520,27 @@ namespace linq {
                 return *values.at(static_cast<typename vector_type::size_type>(current));
             }
 
+            /* only the first count elements of the ordered range are needed, so only the smallest count
+             * elements are kept in a bounded heap: O(n log count) time and O(count) memory */
+            inline void limit(size_t count)
+                { max_count = std::min(max_count, count); }
+
             inline bool next()
             {
                 if (current < 0)
                 {
-                    values.clear();
-                    while (range.next())
-                        values.emplace_back(range.front());
-
-                    if (values.empty())
-                        return false;
-
-                    std::sort(
-                    values.begin(),
-                    values.end(),
-                    [this](wrapped_value_type& l, wrapped_value_type& r) {
+                    auto make = [](value_type& v) {
+                        return wrapped_value_type(v);
+                    };
+                    auto less = [this](const wrapped_value_type& l, const wrapped_value_type& r) {
                         return this->less_predicate(
                             this->select_predicate(*l),
                             this->select_predicate(*r));
-                    });
+                    };
+                    collect_ordered(values, range, max_count, make, less);
+
+                    if (values.empty())
+                        return false;
 
                     current = 0;
                     return true;
@@ -798,21 +1556,27 @@ namespace linq {
                 range           (std::forward<R>(r)),
                 select_predicate(std::forward<SP>(sp)),
                 less_predicate  (std::forward<LP>(lp)),
-                current         (-1)
+                current         (-1),
+                max_count       (std::numeric_limits<size_t>::max()),
+                values          (memory_resource())
                 { LINQ_CTOR(); }
 
             inline order_by_range(const this_type& other) :
                 range           (other.range),
                 select_predicate(other.select_predicate),
                 less_predicate  (other.less_predicate),
-                current         (other.current)
+                current         (other.current),
+                max_count       (other.max_count),
+                values          (other.values.get_allocator())
                 { LINQ_COPY_CTOR(); }
 
             inline order_by_range(this_type&& other) :
                 range           (std::move(other).range),
                 select_predicate(std::move(other).select_predicate),
                 less_predicate  (std::move(other).less_predicate),
-                current         (std::move(other).current)
+                current         (std::move(other).current),
+                max_count       (std::move(other).max_count),
+                values          (other.values.get_allocator())
                 { LINQ_MOVE_CTOR(); }
 
             inline ~order_by_range()
@@ -822,6 +1586,101 @@ namespace linq {
         template<class TRange, class TSelectPredicate, class TLessPredicate>
         using order_by_range_wrapper = range_wrapper<order_by_range<TRange, TSelectPredicate, TLessPredicate>>;
 
+        /* orders the elements of a range over lvalues by reference: the key of each element is selected
+         * once and only the keys and pointers to the elements are sorted (the elements are not copied) */
+        template<class TRange, class TSelectPredicate, class TLessPredicate>
+        struct order_by_ref_range : public tag_range
+        {
+            using range_type            = TRange;
+            using select_predicate_type = TSelectPredicate;
+            using less_predicate_type   = TLessPredicate;
+            using this_type             = order_by_ref_range<range_type, select_predicate_type, less_predicate_type>;
+            using value_type            = mp_range_value_type<range_type>;
+            using pointer_type          = typename std::remove_reference<value_type>::type*;
+            using key_type              = decltype(std::declval<select_predicate_type>()(std::declval<value_type>()));
+            using wrapped_key_type      = utl::wrapper<key_type>;
+            using entry_type            = std::pair<wrapped_key_type, pointer_type>;
+            using vector_type           = pmr_vector<entry_type>;
+
+            static_assert(std::is_lvalue_reference<value_type>::value, "order_by_ref needs a range of lvalue references (e.g. a container)");
+
+            static constexpr bool is_limitable = true;
+
+            range_type              range;
+            select_predicate_type   select_predicate;
+            less_predicate_type     less_predicate;
+            ssize_t                 current;
+            size_t                  max_count;
+            vector_type             values;
+
+            inline value_type& front()
+            {
+                assert(current >= 0 && static_cast<size_t>(current) < values.size());
+                return *values[static_cast<typename vector_type::size_type>(current)].second;
+            }
+
+            inline void limit(size_t count)
+                { max_count = std::min(max_count, count); }
+
+            inline bool next()
+            {
+                if (current < 0)
+                {
+                    auto make = [this](value_type v) {
+                        return entry_type(wrapped_key_type(this->select_predicate(v)), &v);
+                    };
+                    auto less = [this](const entry_type& l, const entry_type& r) {
+                        return this->less_predicate(*l.first, *r.first);
+                    };
+                    collect_ordered(values, range, max_count, make, less);
+
+                    if (values.empty())
+                        return false;
+
+                    current = 0;
+                    return true;
+                }
+
+                if (current < static_cast<ssize_t>(values.size()))
+                    ++current;
+                return (current < static_cast<ssize_t>(values.size()));
+            }
+
+            template<class R, class SP, class LP>
+            inline order_by_ref_range(R&& r, SP&& sp, LP&& lp) :
+                range           (std::forward<R>(r)),
+                select_predicate(std::forward<SP>(sp)),
+                less_predicate  (std::forward<LP>(lp)),
+                current         (-1),
+                max_count       (std::numeric_limits<size_t>::max()),
+                values          (memory_resource())
+                { LINQ_CTOR(); }
+
+            inline order_by_ref_range(const this_type& other) :
+                range           (other.range),
+                select_predicate(other.select_predicate),
+                less_predicate  (other.less_predicate),
+                current         (other.current),
+                max_count       (other.max_count),
+                values          (other.values.get_allocator())
+                { LINQ_COPY_CTOR(); }
+
+            inline order_by_ref_range(this_type&& other) :
+                range           (std::move(other).range),
+                select_predicate(std::move(other).select_predicate),
+                less_predicate  (std::move(other).less_predicate),
+                current         (std::move(other).current),
+                max_count       (std::move(other).max_count),
+                values          (other.values.get_allocator())
+                { LINQ_MOVE_CTOR(); }
+
+            inline ~order_by_ref_range()
+                { LINQ_DTOR(); }
+        };
+
+        template<class TRange, class TSelectPredicate, class TLessPredicate>
+        using order_by_ref_range_wrapper = range_wrapper<order_by_ref_range<TRange, TSelectPredicate, TLessPredicate>>;
+
         template<class TRange, class TLessPredicate>
         struct distinct_range : public tag_range
         {
@@ -831,7 +1690,7 @@ namespace linq {
             using value_type            = mp_range_value_type<range_type>;
             using set_value_type        = utl::wrapper<value_type>;
             using set_less_type         = op_wrapper_less<value_type, less_predicate_type>;
-            using set_type              = std::set<set_value_type, set_less_type>;
+            using set_type              = std::set<set_value_type, set_less_type, std::pmr::polymorphic_allocator<set_value_type>>;
 
             range_type  range;
             set_type    set;
@@ -852,12 +1711,12 @@ namespace linq {
             template<class R, class LP>
             inline distinct_range(R&& r, LP&& lp) :
                 range   (std::forward<R>(r)),
-                set     (std::forward<LP>(lp))
+                set     (set_less_type(std::forward<LP>(lp)), memory_resource())
                 { LINQ_CTOR(); }
 
             inline distinct_range(const this_type& other) :
                 range   (other.range),
-                set     (other.set)
+                set     (other.set, other.set.get_allocator())
                 { LINQ_COPY_CTOR(); }
 
             inline distinct_range(this_type&& other) :
@@ -872,6 +1731,598 @@ namespace linq {
         template<class TRange, class TLessPredicate>
         using distinct_range_wrapper = range_wrapper<distinct_range<TRange, TLessPredicate>>;
 
+        template<class TRange, class THash, class TEqual>
+        struct distinct_hash_range : public tag_range
+        {
+            using range_type    = TRange;
+            using hash_type     = THash;
+            using equal_type    = TEqual;
+            using this_type     = distinct_hash_range<range_type, hash_type, equal_type>;
+            using value_type    = mp_range_value_type<range_type>;
+            using index_type    = flat_hash_index<value_type, hash_type, equal_type>;
+
+            range_type  range;
+            index_type  index;
+
+            inline value_type& front()
+                { return range.front(); }
+
+            inline bool next()
+            {
+                while (range.next())
+                {
+                    if (index.insert(range.front()).second)
+                        return true;
+                }
+                return false;
+            }
+
+            template<class R, class H, class E>
+            inline distinct_hash_range(R&& r, H&& h, E&& e) :
+                range   (std::forward<R>(r)),
+                index   (std::forward<H>(h), std::forward<E>(e))
+                { LINQ_CTOR(); }
+
+            inline distinct_hash_range(const this_type& other) :
+                range   (other.range),
+                index   (other.index)
+                { LINQ_COPY_CTOR(); }
+
+            inline distinct_hash_range(this_type&& other) :
+                range   (std::move(other).range),
+                index   (std::move(other).index)
+                { LINQ_MOVE_CTOR(); }
+
+            inline ~distinct_hash_range()
+                { LINQ_DTOR(); }
+        };
+
+        template<class TRange, class THash, class TEqual>
+        using distinct_hash_range_wrapper = range_wrapper<distinct_hash_range<TRange, THash, TEqual>>;
+
+        /* joins the elements of the outer range with the elements of the inner range that have the same
+         * key. The inner range is loaded into a hash_lookup on the first call to next() (so memory is
+         * proportional to the inner range), the outer range is streamed. The elements are produced in the
+         * order of the outer range, the matches of each outer element in the order of the inner range */
+        template<class TRange, class TInnerRange, class TOuterKeyPredicate, class TInnerKeyPredicate, class TResultPredicate, class THash, class TEqual>
+        struct join_range : public tag_range
+        {
+            using range_type                = TRange;
+            using inner_range_type          = TInnerRange;
+            using outer_key_predicate_type  = TOuterKeyPredicate;
+            using inner_key_predicate_type  = TInnerKeyPredicate;
+            using result_predicate_type     = TResultPredicate;
+            using hash_type                 = THash;
+            using equal_type                = TEqual;
+            using this_type                 = join_range<range_type, inner_range_type, outer_key_predicate_type, inner_key_predicate_type, result_predicate_type, hash_type, equal_type>;
+            using outer_value_type          = mp_range_value_type<range_type>;
+            using inner_value_type          = mp_range_value_type<inner_range_type>;
+            using key_type                  = utl::mp::clean_type<decltype(std::declval<inner_key_predicate_type>()(std::declval<inner_value_type&>()))>;
+            using value_type                = decltype(std::declval<result_predicate_type>()(std::declval<outer_value_type&>(), std::declval<inner_value_type&>()));
+            using lookup_type               = hash_lookup<key_type, inner_value_type, hash_type, equal_type>;
+            using matches_type              = typename lookup_type::lookup_range_wrapper;
+
+            range_type                  range;
+            inner_range_type            inner_range;
+            outer_key_predicate_type    outer_key_predicate;
+            inner_key_predicate_type    inner_key_predicate;
+            result_predicate_type       result_predicate;
+            hash_type                   hash;
+            equal_type                  equal;
+            std::optional<lookup_type>  lookup;
+            std::optional<matches_type> matches;
+            value_cache<value_type>     cache;
+
+            inline value_type& front()
+            {
+                assert(static_cast<bool>(cache));
+                return *cache;
+            }
+
+            inline bool next()
+            {
+                if (!lookup)
+                {
+                    auto select_value = [](inner_value_type& v) -> inner_value_type {
+                        return v;
+                    };
+                    lookup.emplace(lookup_type::build(inner_range, inner_key_predicate, select_value, hash, equal));
+                }
+
+                while (true)
+                {
+                    if (matches && matches->next())
+                    {
+                        cache.emplace(result_predicate(range.front(), matches->front()));
+                        return true;
+                    }
+                    if (!range.next())
+                    {
+                        cache.reset();
+                        return false;
+                    }
+                    matches.emplace((*lookup)[outer_key_predicate(range.front())]);
+                }
+            }
+
+            template<class R, class I, class OK, class IK, class RP, class H, class E>
+            inline join_range(R&& r, I&& i, OK&& ok, IK&& ik, RP&& rp, H&& h, E&& e) :
+                range               (std::forward<R>(r)),
+                inner_range         (std::forward<I>(i)),
+                outer_key_predicate (std::forward<OK>(ok)),
+                inner_key_predicate (std::forward<IK>(ik)),
+                result_predicate    (std::forward<RP>(rp)),
+                hash                (std::forward<H>(h)),
+                equal               (std::forward<E>(e))
+                { LINQ_CTOR(); }
+
+            /* the matches refer to the values of the lookup they were created by, so they are re-created
+             * for the copied (or moved) lookup */
+            inline join_range(const this_type& other) :
+                range               (other.range),
+                inner_range         (other.inner_range),
+                outer_key_predicate (other.outer_key_predicate),
+                inner_key_predicate (other.inner_key_predicate),
+                result_predicate    (other.result_predicate),
+                hash                (other.hash),
+                equal               (other.equal),
+                lookup              (other.lookup),
+                cache               (other.cache)
+            {
+                if (other.matches)
+                    matches.emplace(lookup->rebind(*other.matches));
+                LINQ_COPY_CTOR();
+            }
+
+            inline join_range(this_type&& other) :
+                range               (std::move(other).range),
+                inner_range         (std::move(other).inner_range),
+                outer_key_predicate (std::move(other).outer_key_predicate),
+                inner_key_predicate (std::move(other).inner_key_predicate),
+                result_predicate    (std::move(other).result_predicate),
+                hash                (std::move(other).hash),
+                equal               (std::move(other).equal),
+                lookup              (std::move(other).lookup),
+                cache               (std::move(other).cache)
+            {
+                if (other.matches)
+                    matches.emplace(lookup->rebind(*other.matches));
+                LINQ_MOVE_CTOR();
+            }
+
+            inline ~join_range()
+                { LINQ_DTOR(); }
+        };
+
+        template<class TRange, class TInnerRange, class TOuterKeyPredicate, class TInnerKeyPredicate, class TResultPredicate, class THash, class TEqual>
+        using join_range_wrapper = range_wrapper<join_range<TRange, TInnerRange, TOuterKeyPredicate, TInnerKeyPredicate, TResultPredicate, THash, TEqual>>;
+
+        /* joins two ranges that are ordered by their keys (ascending by the less predicate) in one pass
+         * over both ranges. Only the inner elements of the current key are buffered, a range that turns
+         * out to be not ordered throws an exception */
+        template<class TRange, class TInnerRange, class TOuterKeyPredicate, class TInnerKeyPredicate, class TResultPredicate, class TLessPredicate>
+        struct merge_join_range : public tag_range
+        {
+            using range_type                = TRange;
+            using inner_range_type          = TInnerRange;
+            using outer_key_predicate_type  = TOuterKeyPredicate;
+            using inner_key_predicate_type  = TInnerKeyPredicate;
+            using result_predicate_type     = TResultPredicate;
+            using less_predicate_type       = TLessPredicate;
+            using this_type                 = merge_join_range<range_type, inner_range_type, outer_key_predicate_type, inner_key_predicate_type, result_predicate_type, less_predicate_type>;
+            using outer_value_type          = mp_range_value_type<range_type>;
+            using inner_value_type          = mp_range_value_type<inner_range_type>;
+            using outer_key_type            = utl::mp::clean_type<decltype(std::declval<outer_key_predicate_type>()(std::declval<outer_value_type&>()))>;
+            using inner_key_type            = utl::mp::clean_type<decltype(std::declval<inner_key_predicate_type>()(std::declval<inner_value_type&>()))>;
+            using value_type                = decltype(std::declval<result_predicate_type>()(std::declval<outer_value_type&>(), std::declval<inner_value_type&>()));
+            using group_type                = pmr_vector<utl::wrapper<inner_value_type>>;
+
+            range_type                      range;
+            inner_range_type                inner_range;
+            outer_key_predicate_type        outer_key_predicate;
+            inner_key_predicate_type        inner_key_predicate;
+            result_predicate_type           result_predicate;
+            less_predicate_type             less_predicate;
+            bool                            initialized;
+            bool                            has_inner;
+            std::optional<outer_key_type>   outer_key;
+            std::optional<inner_key_type>   inner_key;
+            group_type                      group;
+            size_t                          group_index;
+            value_cache<value_type>         cache;
+
+            inline value_type& front()
+            {
+                assert(static_cast<bool>(cache));
+                return *cache;
+            }
+
+            inline void next_inner()
+            {
+                has_inner = inner_range.next();
+                if (!has_inner)
+                    return;
+                inner_key_type key = inner_key_predicate(inner_range.front());
+                if (inner_key && less_predicate(key, *inner_key))
+                    throw utl::exception("inner range of merge_join is not ordered");
+                inner_key = std::move(key);
+            }
+
+            inline bool next()
+            {
+                if (!initialized)
+                {
+                    initialized = true;
+                    next_inner();
+                }
+
+                while (true)
+                {
+                    if (group_index < group.size())
+                    {
+                        cache.emplace(result_predicate(range.front(), *group[group_index++]));
+                        return true;
+                    }
+                    if (!range.next())
+                    {
+                        cache.reset();
+                        return false;
+                    }
+
+                    outer_key_type key = outer_key_predicate(range.front());
+                    if (outer_key && less_predicate(key, *outer_key))
+                        throw utl::exception("outer range of merge_join is not ordered");
+                    auto same_key = outer_key && !less_predicate(*outer_key, key);
+                    outer_key = std::move(key);
+                    group_index = 0;
+
+                    /* the group of the previous outer element is reused for elements with the same key */
+                    if (same_key)
+                        continue;
+
+                    group.clear();
+                    while (has_inner && less_predicate(*inner_key, *outer_key))
+                        next_inner();
+                    while (has_inner && !less_predicate(*outer_key, *inner_key))
+                    {
+                        group.emplace_back(inner_range.front());
+                        next_inner();
+                    }
+                }
+            }
+
+            template<class R, class I, class OK, class IK, class RP, class LP>
+            inline merge_join_range(R&& r, I&& i, OK&& ok, IK&& ik, RP&& rp, LP&& lp) :
+                range               (std::forward<R>(r)),
+                inner_range         (std::forward<I>(i)),
+                outer_key_predicate (std::forward<OK>(ok)),
+                inner_key_predicate (std::forward<IK>(ik)),
+                result_predicate    (std::forward<RP>(rp)),
+                less_predicate      (std::forward<LP>(lp)),
+                initialized         (false),
+                has_inner           (false),
+                group               (memory_resource()),
+                group_index         (0)
+                { LINQ_CTOR(); }
+
+            inline merge_join_range(const this_type& other) :
+                range               (other.range),
+                inner_range         (other.inner_range),
+                outer_key_predicate (other.outer_key_predicate),
+                inner_key_predicate (other.inner_key_predicate),
+                result_predicate    (other.result_predicate),
+                less_predicate      (other.less_predicate),
+                initialized         (other.initialized),
+                has_inner           (other.has_inner),
+                outer_key           (other.outer_key),
+                inner_key           (other.inner_key),
+                group               (other.group, other.group.get_allocator()),
+                group_index         (other.group_index),
+                cache               (other.cache)
+                { LINQ_COPY_CTOR(); }
+
+            inline merge_join_range(this_type&& other) :
+                range               (std::move(other).range),
+                inner_range         (std::move(other).inner_range),
+                outer_key_predicate (std::move(other).outer_key_predicate),
+                inner_key_predicate (std::move(other).inner_key_predicate),
+                result_predicate    (std::move(other).result_predicate),
+                less_predicate      (std::move(other).less_predicate),
+                initialized         (std::move(other).initialized),
+                has_inner           (std::move(other).has_inner),
+                outer_key           (std::move(other).outer_key),
+                inner_key           (std::move(other).inner_key),
+                group               (std::move(other).group),
+                group_index         (std::move(other).group_index),
+                cache               (std::move(other).cache)
+                { LINQ_MOVE_CTOR(); }
+
+            inline ~merge_join_range()
+                { LINQ_DTOR(); }
+        };
+
+        template<class TRange, class TInnerRange, class TOuterKeyPredicate, class TInnerKeyPredicate, class TResultPredicate, class TLessPredicate>
+        using merge_join_range_wrapper = range_wrapper<merge_join_range<TRange, TInnerRange, TOuterKeyPredicate, TInnerKeyPredicate, TResultPredicate, TLessPredicate>>;
+
+        template<class TRange>
+        struct take_range : public tag_range
+        {
+            using range_type = TRange;
+            using this_type  = take_range<range_type>;
+            using value_type = mp_range_value_type<range_type>;
+
+            static constexpr bool is_random_access = mp_is_random_access<range_type>::value;
+            static constexpr bool is_contiguous    = mp_is_contiguous<range_type>::value;
+            static constexpr bool is_limitable     = true;
+
+            range_type  range;
+            size_t      count;
+
+            inline value_type& front()
+                { return range.front(); }
+
+            inline bool next()
+            {
+                if (count == 0)
+                    return false;
+                if (!range.next())
+                {
+                    count = 0;
+                    return false;
+                }
+                --count;
+                return true;
+            }
+
+            inline void limit(size_t c)
+                { range_limit(range, std::min(count, c)); }
+
+            inline size_t size()
+                { return std::min(count, range.size()); }
+
+            inline decltype(auto) at(size_t index)
+                { return range.at(index); }
+
+            inline auto data()
+                { return range.data(); }
+
+            template<class R>
+            inline take_range(R&& r, size_t c) :
+                range(std::forward<R>(r)),
+                count(c)
+                { range_limit(range, count); LINQ_CTOR(); }
+
+            inline take_range(const this_type& other) :
+                range(other.range),
+                count(other.count)
+                { LINQ_COPY_CTOR(); }
+
+            inline take_range(this_type&& other) :
+                range(std::move(other).range),
+                count(std::move(other).count)
+                { LINQ_MOVE_CTOR(); }
+
+            inline ~take_range()
+                { LINQ_DTOR(); }
+        };
+
+        template<class TRange>
+        using take_range_wrapper = range_wrapper<take_range<TRange>>;
+
+        template<class TRange>
+        struct skip_range : public tag_range
+        {
+            using range_type = TRange;
+            using this_type  = skip_range<range_type>;
+            using value_type = mp_range_value_type<range_type>;
+
+            static constexpr bool is_random_access = mp_is_random_access<range_type>::value;
+            static constexpr bool is_contiguous    = mp_is_contiguous<range_type>::value;
+            static constexpr bool is_limitable     = mp_is_limitable<range_type>::value;
+
+            range_type  range;
+            size_t      count;
+
+            inline size_t skipped()
+                { return std::min(count, range.size()); }
+
+            inline value_type& front()
+                { return range.front(); }
+
+            inline bool next()
+            {
+                while (count > 0)
+                {
+                    --count;
+                    if (!range.next())
+                    {
+                        count = 0;
+                        return false;
+                    }
+                }
+                return range.next();
+            }
+
+            inline void limit(size_t c)
+            {
+                range_limit(range, c > std::numeric_limits<size_t>::max() - count
+                    ? std::numeric_limits<size_t>::max()
+                    : c + count);
+            }
+
+            inline size_t size()
+                { return range.size() - skipped(); }
+
+            inline decltype(auto) at(size_t index)
+                { return range.at(skipped() + index); }
+
+            inline auto data()
+                { return range.data() + skipped(); }
+
+            template<class R>
+            inline skip_range(R&& r, size_t c) :
+                range(std::forward<R>(r)),
+                count(c)
+                { LINQ_CTOR(); }
+
+            inline skip_range(const this_type& other) :
+                range(other.range),
+                count(other.count)
+                { LINQ_COPY_CTOR(); }
+
+            inline skip_range(this_type&& other) :
+                range(std::move(other).range),
+                count(std::move(other).count)
+                { LINQ_MOVE_CTOR(); }
+
+            inline ~skip_range()
+                { LINQ_DTOR(); }
+        };
+
+        template<class TRange>
+        using skip_range_wrapper = range_wrapper<skip_range<TRange>>;
+
+        /* view of a block of contiguous elements (a batch of a batch_range) */
+        template<class T>
+        struct span
+        {
+            using value_type = T;
+
+            value_type* first;
+            value_type* last;
+
+            inline value_type* begin() const
+                { return first; }
+
+            inline value_type* end() const
+                { return last; }
+
+            inline value_type* data() const
+                { return first; }
+
+            inline size_t size() const
+                { return static_cast<size_t>(last - first); }
+
+            inline bool empty() const
+                { return first == last; }
+
+            inline value_type& operator[](size_t index) const
+                { return first[index]; }
+        };
+
+        /* references the current batch of the source range, also if it is a value that was cached by the source
+         * (e.g. by select), because the source is not advanced before the batch was unbatched completely */
+        struct op_select_batch
+        {
+            template<class T>
+            inline typename std::remove_reference<T>::type& operator()(T&& t) const
+                { return t; }
+        };
+
+        template<class TRange, bool Contiguous = mp_is_contiguous<TRange>::value>
+        struct __impl_batch_element_type
+            { using type = utl::mp::remove_const<utl::mp::clean_type<mp_range_value_type<TRange>>>; };
+
+        template<class TRange>
+        struct __impl_batch_element_type<TRange, true>
+            { using type = typename std::remove_pointer<decltype(std::declval<TRange&>().data())>::type; };
+
+        /* splits a range into batches of up to batch_size elements. The batches of a contiguous range refer
+         * to the elements of the range, all other ranges are copied batch by batch into one reused buffer
+         * (the batch is only valid until the next call to next()) */
+        template<class TRange>
+        struct batch_range : public tag_range
+        {
+            using range_type        = TRange;
+            using this_type         = batch_range<range_type>;
+            using range_value_type  = mp_range_value_type<range_type>;
+            using element_type      = typename __impl_batch_element_type<range_type>::type;
+            using batch_type        = span<element_type>;
+            using value_type        = batch_type&;
+            using buffer_type       = pmr_vector<element_type>;
+
+            static constexpr bool is_contiguous_source = mp_is_contiguous<range_type>::value;
+
+            range_type      range;
+            size_t          batch_size;
+            bool            initialized;
+            element_type*   source;
+            size_t          remaining;
+            buffer_type     buffer;
+            batch_type      current;
+
+            inline value_type front()
+                { return current; }
+
+            inline bool next(std::true_type)
+            {
+                if (!initialized)
+                {
+                    initialized = true;
+                    source      = range.data();
+                    remaining   = range.size();
+                }
+                auto count = std::min(batch_size, remaining);
+                current    = batch_type { source, source + count };
+                source    += count;
+                remaining -= count;
+                return count > 0;
+            }
+
+            inline bool next(std::false_type)
+            {
+                buffer.clear();
+                while (buffer.size() < batch_size && range.next())
+                    buffer.emplace_back(std::forward<range_value_type>(range.front()));
+                current = batch_type { buffer.data(), buffer.data() + buffer.size() };
+                return !buffer.empty();
+            }
+
+            inline bool next()
+                { return next(std::integral_constant<bool, is_contiguous_source>()); }
+
+            template<class R>
+            inline batch_range(R&& r, size_t size) :
+                range       (std::forward<R>(r)),
+                batch_size  (size),
+                initialized (false),
+                source      (nullptr),
+                remaining   (0),
+                buffer      (memory_resource()),
+                current     { nullptr, nullptr }
+                { LINQ_CTOR(); }
+
+            inline batch_range(const this_type& other) :
+                range       (other.range),
+                batch_size  (other.batch_size),
+                initialized (other.initialized),
+                source      (other.source),
+                remaining   (other.remaining),
+                buffer      (other.buffer, other.buffer.get_allocator()),
+                current     (other.current)
+            {
+                if (!is_contiguous_source)
+                    current = batch_type { buffer.data(), buffer.data() + buffer.size() };
+                LINQ_COPY_CTOR();
+            }
+
+            inline batch_range(this_type&& other) :
+                range       (std::move(other).range),
+                batch_size  (std::move(other).batch_size),
+                initialized (std::move(other).initialized),
+                source      (std::move(other).source),
+                remaining   (std::move(other).remaining),
+                buffer      (std::move(other).buffer),
+                current     (std::move(other).current)
+                { LINQ_MOVE_CTOR(); }
+
+            inline ~batch_range()
+                { LINQ_DTOR(); }
+        };
+
+        template<class TRange>
+        using batch_range_wrapper = range_wrapper<batch_range<TRange>>;
+
         template<class TRange, class T>
         struct default_if_empty_range : public tag_range
         {
@@ -904,53 +2355,225 @@ namespace linq {
                 {
                     case state_type::init:
 
-                        state = range.next()
-                            ? state_type::iterate
-                            : state_type::empty;
-                        return true;
+                        state = range.next()
+                            ? state_type::iterate
+                            : state_type::empty;
+                        return true;
+
+                    case state_type::iterate:
+                        if (!range.next())
+                        {
+                            state = state_type::finish;
+                            return false;
+                        }
+                        return true;
+
+                    case state_type::empty:
+                        state = state_type::finish;
+                        /* fall through */
+
+                    default:
+                        return false;
+                }
+            }
+
+            template<class R, class X>
+            inline default_if_empty_range(R&& r, X&& t) :
+                range(std::forward<R>(r)),
+                value(t),
+                state(state_type::init)
+                { LINQ_CTOR(); }
+
+            inline default_if_empty_range(const default_if_empty_range& other) :
+                range(other.range),
+                value(other.value),
+                state(other.state)
+                { LINQ_COPY_CTOR(); }
+
+            inline default_if_empty_range(default_if_empty_range&& other) :
+                range(std::move(other).range),
+                value(std::move(other).value),
+                state(std::move(other).state)
+                { LINQ_MOVE_CTOR(); }
+
+            inline ~default_if_empty_range()
+                { LINQ_DTOR(); }
+        };
+
+        template<class TRange, class T>
+        using default_if_empty_range_wrapper = range_wrapper<default_if_empty_range<TRange, T>>;
+
+        template<class TRange>
+        struct parallel_slice_range : public tag_range
+        {
+            using range_type = TRange;
+            using this_type  = parallel_slice_range<range_type>;
+            using value_type = mp_range_value_type<range_type>;
+            using cache_type = value_cache<value_type>;
+
+            static constexpr bool is_random_access = true;
+            static constexpr bool is_contiguous    = mp_is_contiguous<range_type>::value;
+
+            range_type* range;
+            size_t      first;
+            size_t      last;
+            size_t      current;
+            bool        initialized;
+            cache_type  cache;
+
+            inline size_t upcoming() const
+            {
+                return !initialized || current == last
+                    ? current
+                    : current + 1;
+            }
+
+            inline value_type& front()
+            {
+                assert(static_cast<bool>(cache));
+                return *cache;
+            }
+
+            inline bool next()
+            {
+                if (!initialized)
+                    initialized = true;
+                else if (current < last)
+                    ++current;
+                if (current >= last)
+                {
+                    cache.reset();
+                    return false;
+                }
+                cache.emplace(range->at(current));
+                return true;
+            }
+
+            inline size_t size() const
+                { return last - upcoming(); }
+
+            inline decltype(auto) at(size_t index) const
+                { return range->at(upcoming() + index); }
+
+            inline auto data() const
+                { return range->data() + upcoming(); }
+
+            inline parallel_slice_range(range_type& r, size_t f, size_t l) :
+                range       (&r),
+                first       (f),
+                last        (l),
+                current     (f),
+                initialized (false)
+                { LINQ_CTOR(); }
+
+            inline parallel_slice_range(const this_type& other) :
+                range       (other.range),
+                first       (other.first),
+                last        (other.last),
+                current     (other.current),
+                initialized (other.initialized),
+                cache       (other.cache)
+                { LINQ_COPY_CTOR(); }
+
+            inline parallel_slice_range(this_type&& other) :
+                range       (std::move(other).range),
+                first       (std::move(other).first),
+                last        (std::move(other).last),
+                current     (std::move(other).current),
+                initialized (std::move(other).initialized),
+                cache       (std::move(other).cache)
+                { LINQ_MOVE_CTOR(); }
+
+            inline ~parallel_slice_range()
+                { LINQ_DTOR(); }
+        };
+
+        template<class TRange>
+        struct parallel_range : public tag_range
+        {
+            using range_type = TRange;
+            using this_type  = parallel_range<range_type>;
+            using value_type = mp_range_value_type<range_type>;
+            using slice_type = parallel_slice_range<range_type>;
+
+            static_assert(mp_is_random_access<range_type>::value, "parallel execution needs a random access range");
+
+            static constexpr bool is_random_access = true;
+            static constexpr bool is_contiguous    = mp_is_contiguous<range_type>::value;
+            static constexpr bool is_parallel      = true;
+
+            range_type  range;
+            size_t      threads;
+
+            inline value_type& front()
+                { return range.front(); }
+
+            inline bool next()
+                { return range.next(); }
+
+            inline size_t size()
+                { return range.size(); }
+
+            inline decltype(auto) at(size_t index)
+                { return range.at(index); }
+
+            inline auto data()
+                { return range.data(); }
 
-                    case state_type::iterate:
-                        if (!range.next())
-                        {
-                            state = state_type::finish;
-                            return false;
-                        }
-                        return true;
+            inline size_t concurrency() const
+                { return threads; }
 
-                    case state_type::empty:
-                        state = state_type::finish;
-                        /* fall through */
+            inline size_t source_size()
+                { return range.size(); }
 
-                    default:
-                        return false;
-                }
-            }
+            inline slice_type slice(size_t first, size_t last)
+                { return slice_type(range, first, last); }
 
-            template<class R, class X>
-            inline default_if_empty_range(R&& r, X&& t) :
-                range(std::forward<R>(r)),
-                value(t),
-                state(state_type::init)
+            template<class R>
+            inline parallel_range(R&& r, size_t t) :
+                range   (std::forward<R>(r)),
+                threads (t)
                 { LINQ_CTOR(); }
 
-            inline default_if_empty_range(const default_if_empty_range& other) :
-                range(other.range),
-                value(other.value),
-                state(other.state)
+            inline parallel_range(const this_type& other) :
+                range   (other.range),
+                threads (other.threads)
                 { LINQ_COPY_CTOR(); }
 
-            inline default_if_empty_range(default_if_empty_range&& other) :
-                range(std::move(other).range),
-                value(std::move(other).value),
-                state(std::move(other).state)
+            inline parallel_range(this_type&& other) :
+                range   (std::move(other).range),
+                threads (std::move(other).threads)
                 { LINQ_MOVE_CTOR(); }
 
-            inline ~default_if_empty_range()
+            inline ~parallel_range()
                 { LINQ_DTOR(); }
         };
 
-        template<class TRange, class T>
-        using default_if_empty_range_wrapper = range_wrapper<default_if_empty_range<TRange, T>>;
+        template<class TRange>
+        using parallel_range_wrapper = range_wrapper<parallel_range<TRange>>;
+
+        /* evaluate the slices of a parallel range on the thread pool and merge the results in order */
+        template<class TRange, class TReduce, class TMerge>
+        inline auto parallel_reduce(TRange& range, TReduce&& reduce, TMerge&& merge)
+        {
+            using slice_type  = decltype(range.slice(0, 0));
+            using result_type = utl::mp::remove_ref<decltype(reduce(std::declval<slice_type&>()))>;
+
+            auto size  = range.source_size();
+            auto count = std::max<size_t>(1, std::min(range.concurrency(), size));
+            std::vector<utl::wrapper<result_type>> results(count);
+
+            auto func = [&](size_t index) {
+                auto slice = range.slice(size * index / count, size * (index + 1) / count);
+                results[index] = reduce(slice);
+            };
+            thread_pool::instance().run(count, func);
+
+            auto ret = std::move(*results[0]);
+            for (size_t i = 1; i < count; ++i)
+                ret = merge(std::move(ret), std::move(*results[i]));
+            return ret;
+        }
 
         /* builder *******************************************************************************/
         template<template<class> class TOuterRange>
@@ -1077,74 +2700,199 @@ namespace linq {
                 { }
         };
 
-        struct count_builder : public tag_builder
+        template<template<class> class TOuterRange>
+        struct count_range_builder : public tag_builder
+        {
+            template<class R>
+            using outer_range_type  = TOuterRange<R>;
+
+            size_t count;
+
+            template<class TRange>
+            inline auto build(TRange&& range)
+            {
+                // CAUTION: we want no reference to a range here, because the passed range may be destroyed before used in outer_range_type
+                using range_type = utl::mp::remove_ref<TRange>;
+                return outer_range_type<range_type>(std::forward<TRange>(range), count);
+            }
+
+            inline count_range_builder(size_t c) :
+                count(c)
+                { }
+        };
+
+        /* builder that reduces a range to a single result (TBuilder::reduce), parallel ranges are
+         * split into slices that are reduced on the thread pool and combined with TBuilder::merge */
+        template<class TBuilder>
+        struct reduce_builder : public tag_builder
+        {
+            using builder_type = TBuilder;
+
+            template<class TRange>
+            inline auto build(TRange&& range)
+                { return build_impl(range, mp_is_parallel<TRange>()); }
+
+        private:
+            template<class TRange>
+            inline auto build_impl(TRange& range, std::false_type)
+                { return static_cast<builder_type&>(*this).reduce(range); }
+
+            template<class TRange>
+            inline auto build_impl(TRange& range, std::true_type)
+            {
+                auto& builder = static_cast<builder_type&>(*this);
+                return parallel_reduce(
+                    range,
+                    [&builder](auto& slice) {
+                        return builder.reduce(slice);
+                    },
+                    [&builder](auto&& l, auto&& r) {
+                        return builder.merge(std::move(l), std::move(r));
+                    });
+            }
+        };
+
+        struct parallel_builder : public tag_builder
         {
+            size_t threads;
+
             template<class TRange>
             inline auto build(TRange&& range)
+            {
+                // CAUTION: we want no reference to a range here, because the passed range may be destroyed before used in outer_range_type
+                using range_type = utl::mp::remove_ref<TRange>;
+                return parallel_range_wrapper<range_type>(std::forward<TRange>(range), threads);
+            }
+
+            inline parallel_builder(size_t t) :
+                threads(t)
+                { }
+        };
+
+        struct count_builder : public reduce_builder<count_builder>
+        {
+            template<class TRange>
+            inline auto reduce(TRange& range)
+                { return reduce(range, mp_is_random_access<TRange>()); }
+
+            template<class TRange>
+            inline size_t reduce(TRange& range, std::true_type)
+                { return range.size(); }
+
+            template<class TRange>
+            inline size_t reduce(TRange& range, std::false_type)
             {
                 size_t ret = 0;
-                while (range.next())
+                range_for_each(range, [&ret](auto&&) {
                     ++ret;
+                });
                 return ret;
             }
+
+            inline size_t merge(size_t l, size_t r)
+                { return l + r; }
         };
 
-        struct sum_builder : public tag_builder
+        /* contiguous range of values the vectorized kernels are implemented for */
+        template<class TRange>
+        using mp_is_simd_range = std::integral_constant<bool,
+               mp_is_contiguous<TRange>::value
+            && utl::simd::is_supported<utl::mp::clean_type<mp_range_value_type<TRange>>>::value>;
+
+        struct sum_builder : public reduce_builder<sum_builder>
         {
             template<class TRange>
-            inline auto build(TRange&& range)
+            inline auto reduce(TRange& range)
+                { return reduce(range, mp_is_simd_range<TRange>()); }
+
+            template<class TRange>
+            inline auto reduce(TRange& range, std::true_type)
+                { return utl::simd::sum(range.data(), range.size()); }
+
+            template<class TRange>
+            inline auto reduce(TRange& range, std::false_type)
             {
                 using value_type  = mp_range_value_type<TRange>;
                 using return_type = utl::mp::clean_type<value_type>;
 
                 return_type sum = return_type();
-                while (range.next())
-                    sum += range.front();
+                range_for_each(range, [&sum](auto&& value) {
+                    sum += value;
+                });
                 return sum;
             }
+
+            template<class T>
+            inline T merge(T l, T r)
+                { return l + r; }
         };
 
-        struct min_builder : public tag_builder
+        struct min_builder : public reduce_builder<min_builder>
         {
             template<class TRange>
-            inline auto build(TRange&& range)
+            inline auto reduce(TRange& range)
+                { return reduce(range, mp_is_simd_range<TRange>()); }
+
+            template<class TRange>
+            inline auto reduce(TRange& range, std::true_type)
+                { return utl::simd::min(range.data(), range.size()); }
+
+            template<class TRange>
+            inline auto reduce(TRange& range, std::false_type)
             {
                 using value_type  = mp_range_value_type<TRange>;
                 using return_type = utl::mp::clean_type<value_type>;
 
                 return_type ret = std::numeric_limits<return_type>::max();
-                while (range.next())
-                {
-                    if (ret > range.front())
-                        ret = range.front();
-                }
+                range_for_each(range, [&ret](auto&& value) {
+                    if (ret > value)
+                        ret = value;
+                });
                 return ret;
             }
+
+            template<class T>
+            inline T merge(T l, T r)
+                { return l > r ? r : l; }
         };
 
-        struct max_builder : public tag_builder
+        struct max_builder : public reduce_builder<max_builder>
         {
             template<class TRange>
-            inline auto build(TRange&& range)
+            inline auto reduce(TRange& range)
+                { return reduce(range, mp_is_simd_range<TRange>()); }
+
+            template<class TRange>
+            inline auto reduce(TRange& range, std::true_type)
+                { return utl::simd::max(range.data(), range.size()); }
+
+            template<class TRange>
+            inline auto reduce(TRange& range, std::false_type)
             {
                 using value_type  = mp_range_value_type<TRange>;
                 using return_type = utl::mp::clean_type<value_type>;
 
-                return_type ret = std::numeric_limits<return_type>::min();
-                while (range.next())
-                {
-                    if (ret < range.front())
-                        ret = range.front();
-                }
+                return_type ret = std::numeric_limits<return_type>::lowest();
+                range_for_each(range, [&ret](auto&& value) {
+                    if (ret < value)
+                        ret = value;
+                });
                 return ret;
             }
+
+            template<class T>
+            inline T merge(T l, T r)
+                { return l < r ? r : l; }
         };
 
-        struct any_builder : public tag_builder
+        struct any_builder : public reduce_builder<any_builder>
         {
             template<class TRange>
-            inline auto build(TRange&& range)
+            inline auto reduce(TRange& range)
                 { return range.next(); }
+
+            inline bool merge(bool l, bool r)
+                { return l || r; }
         };
 
         template <class T, class TPredicate>
@@ -1212,6 +2960,8 @@ namespace linq {
             inline auto build(TRange&& range)
             {
                 using range_value_type = mp_range_value_type<TRange>;
+                if (!std::is_lvalue_reference<TRange>::value)
+                    range_limit(range, 1);
                 if (!range.next())
                     throw utl::exception("range is empty");
                 return std::forward<range_value_type>(range.front());
@@ -1225,6 +2975,8 @@ namespace linq {
             {
                 using range_value_type = mp_range_value_type<TRange>;
                 using value_type       = utl::mp::remove_ref<range_value_type>;
+                if (!std::is_lvalue_reference<TRange>::value)
+                    range_limit(range, 1);
                 if (!range.next())
                     return value_type();
                 return std::forward<range_value_type>(range.front());
@@ -1307,24 +3059,33 @@ namespace linq {
             }
         };
 
-        struct to_vector_builder : public tag_builder
+        struct to_vector_builder : public reduce_builder<to_vector_builder>
         {
             size_t capacity;
 
             template<class TRange>
-            inline auto build(TRange&& range)
+            inline auto reduce(TRange& range)
             {
                 using range_value_type = mp_range_value_type<TRange>;
                 using value_type       = utl::mp::remove_const<utl::mp::remove_ref<range_value_type>>;
                 using vector_type      = std::vector<value_type>;
 
                 vector_type ret;
-                ret.reserve(capacity);
-                while (range.next())
-                    ret.emplace_back(std::forward<range_value_type>(range.front()));
+                ret.reserve(range_size_hint(range, capacity));
+                range_for_each(range, [&ret](auto&& value) {
+                    ret.emplace_back(std::forward<decltype(value)>(value));
+                });
                 return ret;
             }
 
+            template<class T>
+            inline std::vector<T> merge(std::vector<T> l, std::vector<T> r)
+            {
+                l.reserve(l.size() + r.size());
+                std::move(r.begin(), r.end(), std::back_inserter(l));
+                return l;
+            }
+
             inline to_vector_builder(size_t cap = 16) :
                 capacity(cap)
                 { }
@@ -1340,8 +3101,9 @@ namespace linq {
                 using list_type        = std::list<value_type>;
 
                 list_type ret;
-                while (range.next())
-                    ret.emplace_back(std::forward<range_value_type>(range.front()));
+                range_for_each(range, [&ret](auto&& value) {
+                    ret.emplace_back(std::forward<decltype(value)>(value));
+                });
                 return ret;
             }
         };
@@ -1366,14 +3128,13 @@ namespace linq {
                 using map_type          = std::map<utl::mp::remove_ref<key_type>, value_type>;
 
                 map_type map;
-                while (range.next())
-                {
+                range_for_each(range, [this, &map](auto&& value) {
                     auto ret = map.emplace(
-                        key_predicate(range.front()),
-                        value_predicate(range.front()));
+                        key_predicate(value),
+                        value_predicate(value));
                     if (!ret.second)
                         throw utl::exception("duplicate key in range");
-                }
+                });
                 return map;
             }
 
@@ -1394,8 +3155,9 @@ namespace linq {
             template<class TRange>
             inline auto build(TRange&& range)
             {
-                while(range.next())
-                    predicate(range.front());
+                range_for_each(range, [this](auto&& value) {
+                    predicate(value);
+                });
             }
 
             inline for_each_builder(const predicate_type& p) :
@@ -1429,8 +3191,180 @@ namespace linq {
                 value_predicate (vp)
                 { LINQ_CTOR(); }
         };
+
+        template<class TKeyPredicate, class TValuePredicate, class THash, class TEqual>
+        struct to_hash_lookup_builder : public tag_builder
+        {
+            using key_predicate_type    = TKeyPredicate;
+            using value_predicate_type  = TValuePredicate;
+            using hash_type             = THash;
+            using equal_type            = TEqual;
+            using this_type             = to_hash_lookup_builder<key_predicate_type, value_predicate_type, hash_type, equal_type>;
+
+            key_predicate_type      key_predicate;
+            value_predicate_type    value_predicate;
+            hash_type               hash;
+            equal_type              equal;
+
+            template<class TRange>
+            inline auto build(TRange&& range)
+            {
+                using range_type        = TRange;
+                using range_value_type  = mp_range_value_type<range_type>;
+                using key_type          = decltype(std::declval<key_predicate_type>()(std::declval<range_value_type>()));
+                using value_type        = decltype(std::declval<value_predicate_type>()(std::declval<range_value_type>()));
+                using lookup_type       = hash_lookup<key_type, value_type, hash_type, equal_type>;
+                return lookup_type::build(range, key_predicate, value_predicate, hash, equal);
+            }
+
+            inline to_hash_lookup_builder(const key_predicate_type& kp, const value_predicate_type& vp, const hash_type& h, const equal_type& e) :
+                key_predicate   (kp),
+                value_predicate (vp),
+                hash            (h),
+                equal           (e)
+                { LINQ_CTOR(); }
+        };
+
+        template<class TKeyPredicate, class TValuePredicate, class THash, class TEqual>
+        struct group_by_builder : public tag_builder
+        {
+            using key_predicate_type    = TKeyPredicate;
+            using value_predicate_type  = TValuePredicate;
+            using hash_type             = THash;
+            using equal_type            = TEqual;
+            using this_type             = group_by_builder<key_predicate_type, value_predicate_type, hash_type, equal_type>;
+
+            key_predicate_type      key_predicate;
+            value_predicate_type    value_predicate;
+            hash_type               hash;
+            equal_type              equal;
+
+            template<class TRange>
+            inline auto build(TRange&& range)
+            {
+                using range_type        = TRange;
+                using range_value_type  = mp_range_value_type<range_type>;
+                using key_type          = decltype(std::declval<key_predicate_type>()(std::declval<range_value_type>()));
+                using value_type        = decltype(std::declval<value_predicate_type>()(std::declval<range_value_type>()));
+                using lookup_type       = hash_lookup<key_type, value_type, hash_type, equal_type>;
+                using range_wrapper     = typename lookup_type::lookup_key_value_range_wrapper;
+                return range_wrapper(lookup_type::build(range, key_predicate, value_predicate, hash, equal));
+            }
+
+            inline group_by_builder(const key_predicate_type& kp, const value_predicate_type& vp, const hash_type& h, const equal_type& e) :
+                key_predicate   (kp),
+                value_predicate (vp),
+                hash            (h),
+                equal           (e)
+                { LINQ_CTOR(); }
+        };
+
+        template<class TInnerRange, class TOuterKeyPredicate, class TInnerKeyPredicate, class TResultPredicate, class THash, class TEqual>
+        struct join_builder : public tag_builder
+        {
+            using inner_range_type          = TInnerRange;
+            using outer_key_predicate_type  = TOuterKeyPredicate;
+            using inner_key_predicate_type  = TInnerKeyPredicate;
+            using result_predicate_type     = TResultPredicate;
+            using hash_type                 = THash;
+            using equal_type                = TEqual;
+            using this_type                 = join_builder<inner_range_type, outer_key_predicate_type, inner_key_predicate_type, result_predicate_type, hash_type, equal_type>;
+
+            inner_range_type            inner_range;
+            outer_key_predicate_type    outer_key_predicate;
+            inner_key_predicate_type    inner_key_predicate;
+            result_predicate_type       result_predicate;
+            hash_type                   hash;
+            equal_type                  equal;
+
+            template<class TRange>
+            inline auto build(TRange&& range)
+            {
+                using range_type = utl::mp::remove_ref<TRange>;
+                return join_range_wrapper<range_type, inner_range_type, outer_key_predicate_type, inner_key_predicate_type, result_predicate_type, hash_type, equal_type>(
+                    std::forward<range_type>(range),
+                    std::move(inner_range),
+                    std::move(outer_key_predicate),
+                    std::move(inner_key_predicate),
+                    std::move(result_predicate),
+                    std::move(hash),
+                    std::move(equal));
+            }
+
+            template<class I>
+            inline join_builder(I&& i, const outer_key_predicate_type& ok, const inner_key_predicate_type& ik, const result_predicate_type& rp, const hash_type& h, const equal_type& e) :
+                inner_range         (std::forward<I>(i)),
+                outer_key_predicate (ok),
+                inner_key_predicate (ik),
+                result_predicate    (rp),
+                hash                (h),
+                equal               (e)
+                { LINQ_CTOR(); }
+        };
+
+        template<class TInnerRange, class TOuterKeyPredicate, class TInnerKeyPredicate, class TResultPredicate, class TLessPredicate>
+        struct merge_join_builder : public tag_builder
+        {
+            using inner_range_type          = TInnerRange;
+            using outer_key_predicate_type  = TOuterKeyPredicate;
+            using inner_key_predicate_type  = TInnerKeyPredicate;
+            using result_predicate_type     = TResultPredicate;
+            using less_predicate_type       = TLessPredicate;
+            using this_type                 = merge_join_builder<inner_range_type, outer_key_predicate_type, inner_key_predicate_type, result_predicate_type, less_predicate_type>;
+
+            inner_range_type            inner_range;
+            outer_key_predicate_type    outer_key_predicate;
+            inner_key_predicate_type    inner_key_predicate;
+            result_predicate_type       result_predicate;
+            less_predicate_type         less_predicate;
+
+            template<class TRange>
+            inline auto build(TRange&& range)
+            {
+                using range_type = utl::mp::remove_ref<TRange>;
+                return merge_join_range_wrapper<range_type, inner_range_type, outer_key_predicate_type, inner_key_predicate_type, result_predicate_type, less_predicate_type>(
+                    std::forward<range_type>(range),
+                    std::move(inner_range),
+                    std::move(outer_key_predicate),
+                    std::move(inner_key_predicate),
+                    std::move(result_predicate),
+                    std::move(less_predicate));
+            }
+
+            template<class I>
+            inline merge_join_builder(I&& i, const outer_key_predicate_type& ok, const inner_key_predicate_type& ik, const result_predicate_type& rp, const less_predicate_type& lp) :
+                inner_range         (std::forward<I>(i)),
+                outer_key_predicate (ok),
+                inner_key_predicate (ik),
+                result_predicate    (rp),
+                less_predicate      (lp)
+                { LINQ_CTOR(); }
+        };
     }
 
+    /** use the given memory resource for the intermediate buffers (order_by, distinct, lookups, ...) of
+     *  all ranges and lookups that are created by the calling thread while the scope exists, e.g. an
+     *  utl::arena that is reset after each evaluation of a recurring query. The memory resource must
+     *  outlive these ranges and lookups. Results of the reducing generators (to_vector, to_map, ...)
+     *  always use the default allocator. */
+    struct memory_scope
+    {
+    private:
+        std::pmr::memory_resource* _previous;
+
+    public:
+        inline memory_scope(std::pmr::memory_resource& resource) :
+            _previous(__impl::current_memory_resource())
+            { __impl::current_memory_resource() = &resource; }
+
+        memory_scope(const memory_scope&) = delete;
+
+        memory_scope& operator=(const memory_scope&) = delete;
+
+        inline ~memory_scope()
+            { __impl::current_memory_resource() = _previous; }
+    };
+
     /* default operations ********************************************************************/
     struct op_select_default
     {
@@ -1439,6 +3373,14 @@ namespace linq {
             { return t; }
     };
 
+    /* passes the element through as reference (used by the reference modes to store pointers instead of copies) */
+    struct op_select_ref
+    {
+        template<class T>
+        inline T& operator()(T& t) const
+            { return t; }
+    };
+
     struct op_less_default
     {
         template<class L, class R>
@@ -1453,6 +3395,13 @@ namespace linq {
             { return (l == r); }
     };
 
+    struct op_hash_default
+    {
+        template<class T>
+        inline size_t operator()(const T& t) const
+            { return std::hash<utl::mp::clean_type<T>>()(t); }
+    };
+
     struct op_select_key_default
     {
         template<class TKey, class TValue>
@@ -1517,17 +3466,34 @@ namespace linq {
     inline auto select_many(TPredicate&& predicate)
         { return __impl::predicate_builder<TPredicate, __impl::select_many_range_wrapper>(std::forward<TPredicate>(predicate)); }
 
+    /** flatten a range of batches (linq::span<T> or containers) into a range of their elements */
+    inline auto unbatch()
+        { return select_many(__impl::op_select_batch()); }
+
     template<class TSelectPredicate, class TLessPredicate>
     inline auto order_by(TSelectPredicate&& sp, TLessPredicate&& lp)
         { return __impl::dual_predicate_builder<TSelectPredicate, TLessPredicate, __impl::order_by_range_wrapper>(std::forward<TSelectPredicate>(sp), std::forward<TLessPredicate>(lp)); }
 
     template<class TSelectPredicate>
     inline auto order_by(TSelectPredicate&& sp)
-        { return order_by(std::forward(sp), op_less_default()); }
+        { return order_by(std::forward<TSelectPredicate>(sp), op_less_default()); }
 
     inline auto order_by()
         { return order_by(op_select_default(), op_less_default()); }
 
+    /** order the elements of the range by reference: the key of each element is selected only once and
+     *  the elements are not copied, front() returns a reference to the element in the source range
+     *  (the range must return lvalue references, e.g. from_container or from_array)
+     *  @param sp   key selector: key(value_type&)
+     *  @param lp   less comparison of two keys */
+    template<class TSelectPredicate, class TLessPredicate>
+    inline auto order_by_ref(TSelectPredicate&& sp, TLessPredicate&& lp)
+        { return __impl::dual_predicate_builder<TSelectPredicate, TLessPredicate, __impl::order_by_ref_range_wrapper>(std::forward<TSelectPredicate>(sp), std::forward<TLessPredicate>(lp)); }
+
+    template<class TSelectPredicate>
+    inline auto order_by_ref(TSelectPredicate&& sp)
+        { return order_by_ref(std::forward<TSelectPredicate>(sp), op_less_default()); }
+
     template<class TLessPredicate>
     inline auto distinct(TLessPredicate&& lp)
         { return __impl::predicate_builder<TLessPredicate, __impl::distinct_range_wrapper>(std::forward<TLessPredicate>(lp)); }
@@ -1535,10 +3501,58 @@ namespace linq {
     inline auto distinct()
         { return distinct(op_less_default()); }
 
+    /** remove duplicates using an open addressing hash table (the first occurence of each value is kept)
+     *  @param h    hash function: size_t(const value_type&)
+     *  @param e    equality comparison: bool(const value_type&, const value_type&) */
+    template<class THash, class TEqual>
+    inline auto distinct_hash(THash&& h, TEqual&& e)
+        { return __impl::dual_predicate_builder<THash, TEqual, __impl::distinct_hash_range_wrapper>(std::forward<THash>(h), std::forward<TEqual>(e)); }
+
+    template<class THash>
+    inline auto distinct_hash(THash&& h)
+        { return distinct_hash(std::forward<THash>(h), op_compare_default()); }
+
+    inline auto distinct_hash()
+        { return distinct_hash(op_hash_default(), op_compare_default()); }
+
     template<class T>
     inline auto default_if_empty(T&& t)
         { return __impl::default_if_empty_builder<T>(std::forward<T>(t)); }
 
+    /** take only the first count elements of the range
+     *  (order_by >> take(count) keeps only count elements instead of sorting the whole range) */
+    inline auto take(size_t count)
+        { return __impl::count_range_builder<__impl::take_range_wrapper>(count); }
+
+    /** skip the first count elements of the range */
+    inline auto skip(size_t count)
+        { return __impl::count_range_builder<__impl::skip_range_wrapper>(count); }
+
+    template<class T>
+    using span = __impl::span<T>;
+
+    /** split the range into batches of up to size elements (linq::span<T>), e.g. to pass blocks of
+     *  elements to batched or vectorized functions. Batches of contiguous ranges (vector, array, ...)
+     *  refer to the elements of the range, other ranges are copied into one reused buffer, so a batch
+     *  is only valid until the next batch is requested */
+    inline auto batch(size_t size)
+    {
+        if (size == 0)
+            throw utl::exception("batch size must not be zero");
+        return __impl::count_range_builder<__impl::batch_range_wrapper>(size);
+    }
+
+    /** evaluate the following where/select stages and the reducing result generator (count, sum, min,
+     *  max, any, to_vector) in parallel. The range must be random access (e.g. a vector or an array),
+     *  it is split into one slice per thread. Predicates are copied for each slice and must be thread safe.
+     *  @param threads  number of threads to use (0 = number of hardware threads) */
+    inline auto parallel(size_t threads = 0)
+    {
+        if (threads == 0)
+            threads = std::max<size_t>(1, std::thread::hardware_concurrency());
+        return __impl::parallel_builder(threads);
+    }
+
     /* result generators */
     inline auto count()
         { return __impl::count_builder(); }
@@ -1613,11 +3627,113 @@ namespace linq {
     inline auto to_lookup()
         { return to_lookup(op_select_key_default(), op_select_value_default()); }
 
+    /** create a lookup that stores references to the elements of the range instead of copies
+     *  (the range must return lvalue references, e.g. from_container or from_array) */
+    template<class TKeyPredicate>
+    inline auto to_lookup_ref(TKeyPredicate&& kp)
+        { return to_lookup(std::forward<TKeyPredicate>(kp), op_select_ref()); }
+
+    /** create a lookup that groups the values by their key in an open addressing hash table
+     *  (keys are iterated in the order of their first occurence, not ordered) */
+    template<class TKeyPredicate, class TValuePredicate, class THash, class TEqual>
+    inline auto to_hash_lookup(TKeyPredicate&& kp, TValuePredicate&& vp, THash&& h, TEqual&& e)
+        { return __impl::to_hash_lookup_builder<TKeyPredicate, TValuePredicate, THash, TEqual>(std::forward<TKeyPredicate>(kp), std::forward<TValuePredicate>(vp), std::forward<THash>(h), std::forward<TEqual>(e)); }
+
+    template<class TKeyPredicate, class TValuePredicate, class THash>
+    inline auto to_hash_lookup(TKeyPredicate&& kp, TValuePredicate&& vp, THash&& h)
+        { return to_hash_lookup(std::forward<TKeyPredicate>(kp), std::forward<TValuePredicate>(vp), std::forward<THash>(h), op_compare_default()); }
+
+    template<class TKeyPredicate, class TValuePredicate>
+    inline auto to_hash_lookup(TKeyPredicate&& kp, TValuePredicate&& vp)
+        { return to_hash_lookup(std::forward<TKeyPredicate>(kp), std::forward<TValuePredicate>(vp), op_hash_default(), op_compare_default()); }
+
+    template<class TKeyPredicate>
+    inline auto to_hash_lookup(TKeyPredicate&& kp)
+        { return to_hash_lookup(std::forward<TKeyPredicate>(kp), op_select_value_default()); }
+
+    inline auto to_hash_lookup()
+        { return to_hash_lookup(op_select_key_default(), op_select_value_default()); }
+
+    /** create a hash lookup that stores references to the elements of the range instead of copies */
+    template<class TKeyPredicate>
+    inline auto to_hash_lookup_ref(TKeyPredicate&& kp)
+        { return to_hash_lookup(std::forward<TKeyPredicate>(kp), op_select_ref()); }
+
+    /** group the elements of the range by their key (using an open addressing hash table),
+     *  the result is a range of std::pair<key, range of elements> in the order of the first occurence of each key */
+    template<class TKeyPredicate, class THash, class TEqual>
+    inline auto group_by(TKeyPredicate&& kp, THash&& h, TEqual&& e)
+        { return __impl::group_by_builder<TKeyPredicate, op_select_default, THash, TEqual>(std::forward<TKeyPredicate>(kp), op_select_default(), std::forward<THash>(h), std::forward<TEqual>(e)); }
+
+    template<class TKeyPredicate, class THash>
+    inline auto group_by(TKeyPredicate&& kp, THash&& h)
+        { return group_by(std::forward<TKeyPredicate>(kp), std::forward<THash>(h), op_compare_default()); }
+
+    template<class TKeyPredicate>
+    inline auto group_by(TKeyPredicate&& kp)
+        { return group_by(std::forward<TKeyPredicate>(kp), op_hash_default(), op_compare_default()); }
+
+    /** group the elements of the range by their key like group_by, but the groups contain references
+     *  to the elements of the range instead of copies */
+    template<class TKeyPredicate>
+    inline auto group_by_ref(TKeyPredicate&& kp)
+        { return __impl::group_by_builder<TKeyPredicate, op_select_ref, op_hash_default, op_compare_default>(std::forward<TKeyPredicate>(kp), op_select_ref(), op_hash_default(), op_compare_default()); }
+
+    /** join the elements of the range with the elements of the inner range that have the same key
+     *  (hash join). The inner range is loaded into a hash table when the result is evaluated and the
+     *  range is streamed, so the smaller range should be passed as inner range. The result is ordered
+     *  like the range, the matches of each element like the inner range.
+     *  @param inner    range to join with (e.g. from_container(...))
+     *  @param ok       key of the elements of the range: key(value_type&)
+     *  @param ik       key of the elements of the inner range: key(inner_value_type&)
+     *  @param rp       result of each match: result(value_type&, inner_value_type&)
+     *  @param h        hash function of the keys
+     *  @param e        equality comparison of the keys */
+    template<class TInner, class TOuterKeyPredicate, class TInnerKeyPredicate, class TResultPredicate, class THash, class TEqual>
+    inline auto join(TInner&& inner, TOuterKeyPredicate&& ok, TInnerKeyPredicate&& ik, TResultPredicate&& rp, THash&& h, TEqual&& e)
+    {
+        using inner_range_type = typename utl::mp::clean_type<TInner>::range_type;
+        return __impl::join_builder<inner_range_type, TOuterKeyPredicate, TInnerKeyPredicate, TResultPredicate, THash, TEqual>(
+            std::forward<TInner>(inner).range,
+            std::forward<TOuterKeyPredicate>(ok),
+            std::forward<TInnerKeyPredicate>(ik),
+            std::forward<TResultPredicate>(rp),
+            std::forward<THash>(h),
+            std::forward<TEqual>(e));
+    }
+
+    template<class TInner, class TOuterKeyPredicate, class TInnerKeyPredicate, class TResultPredicate>
+    inline auto join(TInner&& inner, TOuterKeyPredicate&& ok, TInnerKeyPredicate&& ik, TResultPredicate&& rp)
+        { return join(std::forward<TInner>(inner), std::forward<TOuterKeyPredicate>(ok), std::forward<TInnerKeyPredicate>(ik), std::forward<TResultPredicate>(rp), op_hash_default(), op_compare_default()); }
+
+    /** join two ranges that are both ordered by their keys (merge join). Both ranges are streamed in one
+     *  pass, only the inner elements of the current key are buffered. Throws if one of the ranges is not
+     *  ordered by the less predicate.
+     *  @param lp   less comparison of two keys (the ordering of both ranges) */
+    template<class TInner, class TOuterKeyPredicate, class TInnerKeyPredicate, class TResultPredicate, class TLessPredicate>
+    inline auto merge_join(TInner&& inner, TOuterKeyPredicate&& ok, TInnerKeyPredicate&& ik, TResultPredicate&& rp, TLessPredicate&& lp)
+    {
+        using inner_range_type = typename utl::mp::clean_type<TInner>::range_type;
+        return __impl::merge_join_builder<inner_range_type, TOuterKeyPredicate, TInnerKeyPredicate, TResultPredicate, TLessPredicate>(
+            std::forward<TInner>(inner).range,
+            std::forward<TOuterKeyPredicate>(ok),
+            std::forward<TInnerKeyPredicate>(ik),
+            std::forward<TResultPredicate>(rp),
+            std::forward<TLessPredicate>(lp));
+    }
+
+    template<class TInner, class TOuterKeyPredicate, class TInnerKeyPredicate, class TResultPredicate>
+    inline auto merge_join(TInner&& inner, TOuterKeyPredicate&& ok, TInnerKeyPredicate&& ik, TResultPredicate&& rp)
+        { return merge_join(std::forward<TInner>(inner), std::forward<TOuterKeyPredicate>(ok), std::forward<TInnerKeyPredicate>(ik), std::forward<TResultPredicate>(rp), op_less_default()); }
+
     template <class TKey, class TValue>
     using lookup_value_range_type = typename __impl::lookup<TKey, TValue>::lookup_range_wrapper;
 
     template <class TKey, class TValue>
     using lookup_key_value_range_type = typename __impl::lookup<TKey, TValue>::lookup_key_value_range_wrapper;
 
+    template <class TKey, class TValue, class THash = op_hash_default, class TEqual = op_compare_default>
+    using hash_lookup_key_value_range_type = typename __impl::hash_lookup<TKey, TValue, THash, TEqual>::lookup_key_value_range_wrapper;
+
 }
 }
\ No newline at end of file
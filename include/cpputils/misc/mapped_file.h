@@ -0,0 +1,84 @@
+#pragma once
+
+#include <string>
+#include <cstdint>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include <cpputils/misc/exception.h>
+
+namespace utl
+{
+
+    /* memory mapping of a whole file. The mapping is either read only or copy-on-write (the mapped memory
+     * is writable, but the changes are private to the process and never written back to the file) */
+    struct mapped_file
+    {
+    public:
+        enum class mode
+        {
+            read_only,
+            copy_on_write,
+        };
+
+    private:
+        int     _fd;
+        void*   _data;
+        size_t  _size;
+
+    public:
+        inline void* data()
+            { return _data; }
+
+        inline const void* data() const
+            { return _data; }
+
+        inline size_t size() const
+            { return _size; }
+
+        inline mapped_file(const std::string& filename, mode m = mode::read_only) :
+            _fd     (-1),
+            _data   (nullptr),
+            _size   (0)
+        {
+            _fd = ::open(filename.c_str(), O_RDONLY);
+            if (_fd < 0)
+                throw exception("unable to open file: " + filename);
+            struct stat st;
+            if (::fstat(_fd, &st) != 0)
+            {
+                ::close(_fd);
+                throw exception("unable to get size of file: " + filename);
+            }
+            _size = static_cast<size_t>(st.st_size);
+            if (_size > 0)
+            {
+                auto prot = m == mode::copy_on_write
+                    ? PROT_READ | PROT_WRITE
+                    : PROT_READ;
+                _data = ::mmap(nullptr, _size, prot, MAP_PRIVATE, _fd, 0);
+                if (_data == MAP_FAILED)
+                {
+                    ::close(_fd);
+                    throw exception("unable to map file: " + filename);
+                }
+                ::madvise(_data, _size, m == mode::copy_on_write ? MADV_WILLNEED : MADV_SEQUENTIAL);
+            }
+        }
+
+        inline ~mapped_file()
+        {
+            if (_data)
+                ::munmap(_data, _size);
+            if (_fd >= 0)
+                ::close(_fd);
+        }
+
+    private:
+        mapped_file(mapped_file&&) = delete;
+        mapped_file(const mapped_file&) = delete;
+    };
+
+}
@@ -0,0 +1,508 @@
+#pragma once
+
+#include <limits>
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <type_traits>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+    #define UTL_SIMD_X86
+    #include <immintrin.h>
+#endif
+
+namespace utl {
+namespace simd {
+
+    enum class instruction_set
+    {
+        scalar,
+        sse42,
+        avx2,
+    };
+
+    /** get the best instruction set that is supported by the executing cpu (detected once) */
+    inline instruction_set supported_instruction_set();
+
+    /** types the vectorized kernels are implemented for (all other types use the scalar kernel) */
+    template<class T>
+    struct is_supported :
+        public std::integral_constant<bool,
+               std::is_same<T, float>::value
+            || std::is_same<T, double>::value
+            || std::is_same<T, int32_t>::value
+            || std::is_same<T, int64_t>::value>
+        { };
+
+    /** sum of the given values (the order of the additions differs from a sequential loop,
+     *  so the result of floating point values may differ in the last digits)
+     *  @param data     values to sum up
+     *  @param size     number of values
+     *  @param is       instruction set to use (must be supported by the cpu)
+     *  @return         sum of the values */
+    template<class T>
+    inline T sum(const T* data, size_t size, instruction_set is = supported_instruction_set());
+
+    /** minimum of the given values (NaN values are skipped)
+     *  @param data     values to get minimum of
+     *  @param size     number of values
+     *  @param is       instruction set to use (must be supported by the cpu)
+     *  @return         smallest value or std::numeric_limits<T>::max() if size is zero */
+    template<class T>
+    inline T min(const T* data, size_t size, instruction_set is = supported_instruction_set());
+
+    /** maximum of the given values (NaN values are skipped)
+     *  @param data     values to get maximum of
+     *  @param size     number of values
+     *  @param is       instruction set to use (must be supported by the cpu)
+     *  @return         greatest value or std::numeric_limits<T>::lowest() if size is zero */
+    template<class T>
+    inline T max(const T* data, size_t size, instruction_set is = supported_instruction_set());
+
+    namespace __impl
+    {
+        enum class reduce_op
+        {
+            sum,
+            min,
+            max,
+        };
+
+        template<reduce_op Op, class T>
+        struct scalar_op;
+
+        template<class T>
+        struct scalar_op<reduce_op::sum, T>
+        {
+            static inline T init()
+                { return T(); }
+
+            static inline T apply(T l, T r)
+                { return static_cast<T>(l + r); }
+        };
+
+        template<class T>
+        struct scalar_op<reduce_op::min, T>
+        {
+            static inline T init()
+                { return std::numeric_limits<T>::max(); }
+
+            static inline T apply(T l, T r)
+                { return r < l ? r : l; }
+        };
+
+        template<class T>
+        struct scalar_op<reduce_op::max, T>
+        {
+            static inline T init()
+                { return std::numeric_limits<T>::lowest(); }
+
+            static inline T apply(T l, T r)
+                { return l < r ? r : l; }
+        };
+
+        template<reduce_op Op, class T>
+        inline T reduce_scalar(const T* data, size_t size);
+
+        template<reduce_op Op, class T>
+        inline T reduce(const T* data, size_t size, instruction_set is, std::true_type);
+
+        template<reduce_op Op, class T>
+        inline T reduce(const T* data, size_t size, instruction_set is, std::false_type);
+
+#ifdef UTL_SIMD_X86
+        /* vector operations of one instruction set and value type, all functions are compiled for
+         * the instruction set, so they are inlined into the kernel of the same instruction set.
+         * apply() gets the accumulator as a and the loaded values as b. The min/max instructions of
+         * floating point values return their second operand if one of the operands is NaN, so the
+         * operands are swapped to keep the accumulator and skip NaNs like the scalar kernel does. */
+        template<instruction_set IS, class T>
+        struct isa;
+
+        template<>
+        struct isa<instruction_set::avx2, float>
+        {
+            using vector_type = __m256;
+            static constexpr size_t width = 8;
+
+            __attribute__((target("avx2")))
+            static inline vector_type load(const float* p)
+                { return _mm256_loadu_ps(p); }
+
+            __attribute__((target("avx2")))
+            static inline vector_type set1(float v)
+                { return _mm256_set1_ps(v); }
+
+            template<reduce_op Op>
+            __attribute__((target("avx2")))
+            static inline vector_type apply(vector_type a, vector_type b)
+            {
+                return Op == reduce_op::sum ? _mm256_add_ps(a, b)
+                     : Op == reduce_op::min ? _mm256_min_ps(b, a)
+                     :                        _mm256_max_ps(b, a);
+            }
+        };
+
+        template<>
+        struct isa<instruction_set::avx2, double>
+        {
+            using vector_type = __m256d;
+            static constexpr size_t width = 4;
+
+            __attribute__((target("avx2")))
+            static inline vector_type load(const double* p)
+                { return _mm256_loadu_pd(p); }
+
+            __attribute__((target("avx2")))
+            static inline vector_type set1(double v)
+                { return _mm256_set1_pd(v); }
+
+            template<reduce_op Op>
+            __attribute__((target("avx2")))
+            static inline vector_type apply(vector_type a, vector_type b)
+            {
+                return Op == reduce_op::sum ? _mm256_add_pd(a, b)
+                     : Op == reduce_op::min ? _mm256_min_pd(b, a)
+                     :                        _mm256_max_pd(b, a);
+            }
+        };
+
+        template<>
+        struct isa<instruction_set::avx2, int32_t>
+        {
+            using vector_type = __m256i;
+            static constexpr size_t width = 8;
+
+            __attribute__((target("avx2")))
+            static inline vector_type load(const int32_t* p)
+                { return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)); }
+
+            __attribute__((target("avx2")))
+            static inline vector_type set1(int32_t v)
+                { return _mm256_set1_epi32(v); }
+
+            template<reduce_op Op>
+            __attribute__((target("avx2")))
+            static inline vector_type apply(vector_type a, vector_type b)
+            {
+                return Op == reduce_op::sum ? _mm256_add_epi32(a, b)
+                     : Op == reduce_op::min ? _mm256_min_epi32(a, b)
+                     :                        _mm256_max_epi32(a, b);
+            }
+        };
+
+        template<>
+        struct isa<instruction_set::avx2, int64_t>
+        {
+            using vector_type = __m256i;
+            static constexpr size_t width = 4;
+
+            __attribute__((target("avx2")))
+            static inline vector_type load(const int64_t* p)
+                { return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)); }
+
+            __attribute__((target("avx2")))
+            static inline vector_type set1(int64_t v)
+                { return _mm256_set1_epi64x(v); }
+
+            /* AVX2 has no 64 bit min/max, so the greater lanes are selected by a compare mask */
+            template<reduce_op Op>
+            __attribute__((target("avx2")))
+            static inline vector_type apply(vector_type a, vector_type b)
+            {
+                return Op == reduce_op::sum ? _mm256_add_epi64(a, b)
+                     : Op == reduce_op::min ? _mm256_blendv_epi8(a, b, _mm256_cmpgt_epi64(a, b))
+                     :                        _mm256_blendv_epi8(b, a, _mm256_cmpgt_epi64(a, b));
+            }
+        };
+
+        template<>
+        struct isa<instruction_set::sse42, float>
+        {
+            using vector_type = __m128;
+            static constexpr size_t width = 4;
+
+            __attribute__((target("sse4.2")))
+            static inline vector_type load(const float* p)
+                { return _mm_loadu_ps(p); }
+
+            __attribute__((target("sse4.2")))
+            static inline vector_type set1(float v)
+                { return _mm_set1_ps(v); }
+
+            template<reduce_op Op>
+            __attribute__((target("sse4.2")))
+            static inline vector_type apply(vector_type a, vector_type b)
+            {
+                return Op == reduce_op::sum ? _mm_add_ps(a, b)
+                     : Op == reduce_op::min ? _mm_min_ps(b, a)
+                     :                        _mm_max_ps(b, a);
+            }
+        };
+
+        template<>
+        struct isa<instruction_set::sse42, double>
+        {
+            using vector_type = __m128d;
+            static constexpr size_t width = 2;
+
+            __attribute__((target("sse4.2")))
+            static inline vector_type load(const double* p)
+                { return _mm_loadu_pd(p); }
+
+            __attribute__((target("sse4.2")))
+            static inline vector_type set1(double v)
+                { return _mm_set1_pd(v); }
+
+            template<reduce_op Op>
+            __attribute__((target("sse4.2")))
+            static inline vector_type apply(vector_type a, vector_type b)
+            {
+                return Op == reduce_op::sum ? _mm_add_pd(a, b)
+                     : Op == reduce_op::min ? _mm_min_pd(b, a)
+                     :                        _mm_max_pd(b, a);
+            }
+        };
+
+        template<>
+        struct isa<instruction_set::sse42, int32_t>
+        {
+            using vector_type = __m128i;
+            static constexpr size_t width = 4;
+
+            __attribute__((target("sse4.2")))
+            static inline vector_type load(const int32_t* p)
+                { return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p)); }
+
+            __attribute__((target("sse4.2")))
+            static inline vector_type set1(int32_t v)
+                { return _mm_set1_epi32(v); }
+
+            template<reduce_op Op>
+            __attribute__((target("sse4.2")))
+            static inline vector_type apply(vector_type a, vector_type b)
+            {
+                return Op == reduce_op::sum ? _mm_add_epi32(a, b)
+                     : Op == reduce_op::min ? _mm_min_epi32(a, b)
+                     :                        _mm_max_epi32(a, b);
+            }
+        };
+
+        template<>
+        struct isa<instruction_set::sse42, int64_t>
+        {
+            using vector_type = __m128i;
+            static constexpr size_t width = 2;
+
+            __attribute__((target("sse4.2")))
+            static inline vector_type load(const int64_t* p)
+                { return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p)); }
+
+            __attribute__((target("sse4.2")))
+            static inline vector_type set1(int64_t v)
+                { return _mm_set1_epi64x(v); }
+
+            template<reduce_op Op>
+            __attribute__((target("sse4.2")))
+            static inline vector_type apply(vector_type a, vector_type b)
+            {
+                return Op == reduce_op::sum ? _mm_add_epi64(a, b)
+                     : Op == reduce_op::min ? _mm_blendv_epi8(a, b, _mm_cmpgt_epi64(a, b))
+                     :                        _mm_blendv_epi8(b, a, _mm_cmpgt_epi64(a, b));
+            }
+        };
+
+        template<reduce_op Op, class T>
+        __attribute__((target("avx2")))
+        inline T reduce_avx2(const T* data, size_t size);
+
+        template<reduce_op Op, class T>
+        __attribute__((target("sse4.2")))
+        inline T reduce_sse42(const T* data, size_t size);
+#endif
+    }
+
+}
+}
+
+/* HELPER ****************************************************************************************/
+
+inline utl::simd::instruction_set
+utl::simd::supported_instruction_set()
+{
+#ifdef UTL_SIMD_X86
+    static const instruction_set value = []{
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx2"))
+            return instruction_set::avx2;
+        if (__builtin_cpu_supports("sse4.2"))
+            return instruction_set::sse42;
+        return instruction_set::scalar;
+    }();
+    return value;
+#else
+    return instruction_set::scalar;
+#endif
+}
+
+/* KERNELS ***************************************************************************************/
+
+template<utl::simd::__impl::reduce_op Op, class T>
+inline T
+utl::simd::__impl::reduce_scalar(
+    const T* data,
+    size_t size)
+{
+    using op_type = scalar_op<Op, T>;
+    T ret = op_type::init();
+    for (size_t i = 0; i < size; ++i)
+        ret = op_type::apply(ret, data[i]);
+    return ret;
+}
+
+#ifdef UTL_SIMD_X86
+
+/* the kernels use four independent accumulators to hide the latency of the vector operations */
+
+template<utl::simd::__impl::reduce_op Op, class T>
+__attribute__((target("avx2")))
+inline T
+utl::simd::__impl::reduce_avx2(
+    const T* data,
+    size_t size)
+{
+    using isa_type    = isa<instruction_set::avx2, T>;
+    using vector_type = typename isa_type::vector_type;
+    using op_type     = scalar_op<Op, T>;
+    constexpr size_t w = isa_type::width;
+
+    vector_type acc0 = isa_type::set1(op_type::init());
+    vector_type acc1 = acc0;
+    vector_type acc2 = acc0;
+    vector_type acc3 = acc0;
+    size_t i = 0;
+    for (; i + 4 * w <= size; i += 4 * w)
+    {
+        acc0 = isa_type::template apply<Op>(acc0, isa_type::load(data + i + 0 * w));
+        acc1 = isa_type::template apply<Op>(acc1, isa_type::load(data + i + 1 * w));
+        acc2 = isa_type::template apply<Op>(acc2, isa_type::load(data + i + 2 * w));
+        acc3 = isa_type::template apply<Op>(acc3, isa_type::load(data + i + 3 * w));
+    }
+    for (; i + w <= size; i += w)
+        acc0 = isa_type::template apply<Op>(acc0, isa_type::load(data + i));
+    acc0 = isa_type::template apply<Op>(
+        isa_type::template apply<Op>(acc0, acc1),
+        isa_type::template apply<Op>(acc2, acc3));
+
+    T lanes[w];
+    memcpy(&lanes[0], &acc0, sizeof(lanes));
+    T ret = lanes[0];
+    for (size_t j = 1; j < w; ++j)
+        ret = op_type::apply(ret, lanes[j]);
+    for (; i < size; ++i)
+        ret = op_type::apply(ret, data[i]);
+    return ret;
+}
+
+template<utl::simd::__impl::reduce_op Op, class T>
+__attribute__((target("sse4.2")))
+inline T
+utl::simd::__impl::reduce_sse42(
+    const T* data,
+    size_t size)
+{
+    using isa_type    = isa<instruction_set::sse42, T>;
+    using vector_type = typename isa_type::vector_type;
+    using op_type     = scalar_op<Op, T>;
+    constexpr size_t w = isa_type::width;
+
+    vector_type acc0 = isa_type::set1(op_type::init());
+    vector_type acc1 = acc0;
+    vector_type acc2 = acc0;
+    vector_type acc3 = acc0;
+    size_t i = 0;
+    for (; i + 4 * w <= size; i += 4 * w)
+    {
+        acc0 = isa_type::template apply<Op>(acc0, isa_type::load(data + i + 0 * w));
+        acc1 = isa_type::template apply<Op>(acc1, isa_type::load(data + i + 1 * w));
+        acc2 = isa_type::template apply<Op>(acc2, isa_type::load(data + i + 2 * w));
+        acc3 = isa_type::template apply<Op>(acc3, isa_type::load(data + i + 3 * w));
+    }
+    for (; i + w <= size; i += w)
+        acc0 = isa_type::template apply<Op>(acc0, isa_type::load(data + i));
+    acc0 = isa_type::template apply<Op>(
+        isa_type::template apply<Op>(acc0, acc1),
+        isa_type::template apply<Op>(acc2, acc3));
+
+    T lanes[w];
+    memcpy(&lanes[0], &acc0, sizeof(lanes));
+    T ret = lanes[0];
+    for (size_t j = 1; j < w; ++j)
+        ret = op_type::apply(ret, lanes[j]);
+    for (; i < size; ++i)
+        ret = op_type::apply(ret, data[i]);
+    return ret;
+}
+
+#endif
+
+template<utl::simd::__impl::reduce_op Op, class T>
+inline T
+utl::simd::__impl::reduce(
+    const T* data,
+    size_t size,
+    instruction_set is,
+    std::true_type)
+{
+#ifdef UTL_SIMD_X86
+    switch (is)
+    {
+        case instruction_set::avx2:
+            return reduce_avx2<Op>(data, size);
+
+        case instruction_set::sse42:
+            return reduce_sse42<Op>(data, size);
+
+        default:
+            break;
+    }
+#else
+    (void)is;
+#endif
+    return reduce_scalar<Op>(data, size);
+}
+
+template<utl::simd::__impl::reduce_op Op, class T>
+inline T
+utl::simd::__impl::reduce(
+    const T* data,
+    size_t size,
+    instruction_set,
+    std::false_type)
+    { return reduce_scalar<Op>(data, size); }
+
+/* REDUCE ****************************************************************************************/
+
+template<class T>
+inline T
+utl::simd::sum(
+    const T* data,
+    size_t size,
+    instruction_set is)
+    { return __impl::reduce<__impl::reduce_op::sum>(data, size, is, is_supported<T>()); }
+
+template<class T>
+inline T
+utl::simd::min(
+    const T* data,
+    size_t size,
+    instruction_set is)
+    { return __impl::reduce<__impl::reduce_op::min>(data, size, is, is_supported<T>()); }
+
+template<class T>
+inline T
+utl::simd::max(
+    const T* data,
+    size_t size,
+    instruction_set is)
+    { return __impl::reduce<__impl::reduce_op::max>(data, size, is, is_supported<T>()); }
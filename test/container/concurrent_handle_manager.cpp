@@ -0,0 +1,86 @@
+#include <set>
+#include <thread>
+#include <vector>
+#include <gtest/gtest.h>
+#include <cpputils/container/concurrent_handle_manager.h>
+
+using namespace utl;
+
+using concurrent_handle_manager_int = utl::concurrent_handle_manager<int>;
+
+TEST(concurrent_handle_manager_tests, insert_remove)
+{
+    concurrent_handle_manager_int manager;
+    auto handle = manager.insert(0, 0, 123);
+    EXPECT_TRUE (static_cast<bool>(handle));
+    EXPECT_TRUE (manager.is_valid(handle));
+    EXPECT_FALSE(manager.remove(156161));
+    EXPECT_FALSE(manager.remove(0));
+    EXPECT_TRUE (manager.remove(handle));
+    EXPECT_FALSE(manager.remove(handle));
+    EXPECT_FALSE(manager.is_valid(handle));
+
+    auto reused = manager.insert(0, 0, 456);
+    EXPECT_NE   (handle, reused);
+    EXPECT_EQ   (get_system_id(handle), get_system_id(reused));
+    EXPECT_FALSE(manager.is_valid(handle));
+    EXPECT_TRUE (manager.is_valid(reused));
+}
+
+TEST(concurrent_handle_manager_tests, try_get_get_update)
+{
+    int val;
+    concurrent_handle_manager_int manager;
+    EXPECT_FALSE    (manager.try_get(123, val));
+    EXPECT_FALSE    (manager.try_get(15616724, val));
+    EXPECT_ANY_THROW(manager.get(123));
+    EXPECT_FALSE    (manager.update(123, 555));
+
+    auto handle = manager.insert(1, 2, 555);
+    EXPECT_EQ  (1, get_type_id(handle));
+    EXPECT_EQ  (2, get_system_id(handle));
+    EXPECT_TRUE(manager.try_get(handle, val));
+    EXPECT_EQ  (555, val);
+    EXPECT_TRUE(manager.update(handle, 554));
+    EXPECT_EQ  (554, manager.get(handle));
+}
+
+TEST(concurrent_handle_manager_tests, multi_threaded)
+{
+    static constexpr int thread_count = 8;
+    static constexpr int value_count  = 10000;
+
+    concurrent_handle_manager_int manager;
+    std::vector<std::vector<handle>> handles(thread_count);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < thread_count; ++t)
+    {
+        threads.emplace_back([&, t]{
+            auto& h = handles[static_cast<size_t>(t)];
+            for (int i = 0; i < value_count; ++i)
+            {
+                h.push_back(manager.insert(0, 0, t * value_count + i));
+                if (i & 1)
+                {
+                    EXPECT_TRUE(manager.remove(h.back()));
+                    h.pop_back();
+                }
+            }
+        });
+    }
+    for (auto& t : threads)
+        t.join();
+
+    std::set<handle> unique;
+    for (int t = 0; t < thread_count; ++t)
+    {
+        for (auto& h : handles[static_cast<size_t>(t)])
+        {
+            int val = -1;
+            EXPECT_TRUE(unique.insert(h).second);
+            EXPECT_TRUE(manager.try_get(h, val));
+            EXPECT_EQ  (t, val / value_count);
+        }
+    }
+    EXPECT_EQ(static_cast<size_t>(thread_count * value_count / 2), unique.size());
+}
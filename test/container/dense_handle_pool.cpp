@@ -0,0 +1,78 @@
+#include <map>
+#include <vector>
+#include <gtest/gtest.h>
+#include <cpputils/container/dense_handle_pool.h>
+
+using namespace utl;
+
+using dense_handle_pool_int = utl::dense_handle_pool<int>;
+
+TEST(dense_handle_pool_tests, insert_remove)
+{
+    dense_handle_pool_int pool;
+    auto h0 = pool.insert (7, 0, 10);
+    auto h1 = pool.insert (7, 0, 11);
+    auto h2 = pool.emplace(7, 1, 12);
+    auto h3 = pool.insert (3, 0, 30);
+    EXPECT_EQ   (3u, pool.size(7));
+    EXPECT_EQ   (1u, pool.size(3));
+    EXPECT_EQ   (0u, pool.size(200));
+    EXPECT_EQ   (7,  get_type_id(h0));
+    EXPECT_EQ   (11, pool.get_ref(h1));
+    EXPECT_EQ   (30, *pool.try_get_ptr(h3));
+
+    EXPECT_TRUE (pool.remove(h0));
+    EXPECT_FALSE(pool.remove(h0));
+    EXPECT_FALSE(pool.is_valid(h0));
+    EXPECT_EQ   (nullptr, pool.try_get_ptr(h0));
+    EXPECT_ANY_THROW(pool.get_ref(h0));
+    EXPECT_EQ   (2u, pool.size(7));
+    EXPECT_EQ   (11, pool.get_ref(h1));
+    EXPECT_EQ   (12, pool.get_ref(h2));
+
+    // the last value was moved to the front
+    auto values = pool.values(7);
+    ASSERT_EQ   (2u, values.size());
+    EXPECT_EQ   (12, values.first[0]);
+    EXPECT_EQ   (11, values.first[1]);
+    EXPECT_EQ   (h2, pool.handles(7)[0]);
+    EXPECT_EQ   (h1, pool.handles(7)[1]);
+
+    pool.clear();
+    EXPECT_FALSE(pool.is_valid(h1));
+    EXPECT_EQ   (0u, pool.size(7));
+}
+
+TEST(dense_handle_pool_tests, for_each)
+{
+    dense_handle_pool_int pool;
+    std::map<handle, int> expected;
+    std::vector<handle> handles;
+    for (int i = 0; i < 1000; ++i)
+    {
+        auto h = pool.insert(static_cast<type_id_type>(i % 4), 0, i);
+        handles.push_back(h);
+        expected[h] = i;
+    }
+    for (size_t i = 0; i < handles.size(); i += 3)
+    {
+        EXPECT_TRUE(pool.remove(handles[i]));
+        expected.erase(handles[i]);
+    }
+
+    size_t count = 0;
+    for (type_id_type tId = 0; tId < 4; ++tId)
+    {
+        int sum = 0;
+        for (auto& v : pool.values(tId))
+            sum += v;
+        pool.for_each(tId, [&](const handle& h, int& v) {
+            EXPECT_EQ(tId, get_type_id(h));
+            EXPECT_EQ(expected[h], v);
+            sum -= v;
+            ++count;
+        });
+        EXPECT_EQ(0, sum);
+    }
+    EXPECT_EQ(expected.size(), count);
+}
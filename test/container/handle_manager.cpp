@@ -1,5 +1,11 @@
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
 #include <gtest/gtest.h>
 #include <cpputils/misc/string.h>
+#include <cpputils/misc/mapped_file.h>
 #include <cpputils/container/handle_manager.h>
 
 using namespace utl;
@@ -20,6 +26,67 @@ TEST(handle_manager_tests, from_string_to_string)
     EXPECT_EQ   (std::string("11-22-3344-55667788"), to_string(h));
     EXPECT_TRUE (try_from_string("1122334455667788", h));
     EXPECT_EQ   (std::string("11-22-3344-55667788"), to_string(h));
+    EXPECT_TRUE (try_from_string("12-AB-cdEF-01234567", h));
+    EXPECT_EQ   (std::string("12-AB-CDEF-01234567"), to_string(h));
+}
+
+TEST(handle_manager_tests, to_chars_from_chars)
+{
+    handle h;
+    char buffer[64];
+    const char* str = "12-AB-cdEF-01234567 rest";
+    auto parsed = handle::from_chars(str, str + strlen(str), h);
+    EXPECT_EQ   (std::errc(), parsed.ec);
+    EXPECT_EQ   (str + handle::string_size, parsed.ptr);
+
+    auto written = h.to_chars(&buffer[0], &buffer[0] + sizeof(buffer));
+    EXPECT_EQ   (std::errc(), written.ec);
+    EXPECT_EQ   (std::string("12-AB-CDEF-01234567"), std::string(&buffer[0], written.ptr));
+
+    written = h.to_chars(&buffer[0], &buffer[0] + handle::string_size - 1);
+    EXPECT_EQ   (std::errc::value_too_large, written.ec);
+
+    handle unchanged(123);
+    str    = "12-AB-cdEF-0123456x";
+    parsed = handle::from_chars(str, str + strlen(str), unchanged);
+    EXPECT_EQ   (std::errc::invalid_argument, parsed.ec);
+    EXPECT_EQ   (str + 18, parsed.ptr);
+    EXPECT_EQ   (handle(123), unchanged);
+
+    str    = "12AB-cdEF01234567";
+    parsed = handle::from_chars(str, str + strlen(str), h);
+    EXPECT_EQ   (std::errc(), parsed.ec);
+    EXPECT_EQ   (std::string("12-AB-CDEF-01234567"), to_string(h));
+}
+
+TEST(handle_manager_tests, to_chars_n_from_chars_n)
+{
+    handle_manager_int manager;
+    std::vector<handle> handles;
+    for (int i = 0; i < 100; ++i)
+        handles.push_back(manager.insert(static_cast<type_id_type>(i % 3), 0, i));
+
+    std::string buffer(handles.size() * (handle::string_size + 1) - 1, ' ');
+    auto first   = &buffer[0];
+    auto last    = first + buffer.size();
+    auto written = handle::to_chars_n(handles.data(), handles.size(), first, last, '\n');
+    EXPECT_EQ   (std::errc(), written.ec);
+    EXPECT_EQ   (last, written.ptr);
+    EXPECT_EQ   (to_string(handles[1]), buffer.substr(handle::string_size + 1, handle::string_size));
+
+    std::vector<handle> parsed(handles.size());
+    auto ret = handle::from_chars_n(first, last, parsed.data(), parsed.size(), '\n');
+    EXPECT_EQ   (std::errc(), ret.ec);
+    EXPECT_EQ   (static_cast<const char*>(last), ret.ptr);
+    EXPECT_EQ   (handles, parsed);
+
+    written = handle::to_chars_n(handles.data(), handles.size(), first, last - 1, '\n');
+    EXPECT_EQ   (std::errc::value_too_large, written.ec);
+
+    buffer[handle::string_size] = ' ';
+    ret = handle::from_chars_n(first, last, parsed.data(), parsed.size(), '\n');
+    EXPECT_EQ   (std::errc::invalid_argument, ret.ec);
+    EXPECT_EQ   (static_cast<const char*>(first + handle::string_size), ret.ptr);
 }
 
 TEST(handle_manager_tests, insert)
@@ -117,4 +184,710 @@ TEST(handle_manager_tests, set)
 
     EXPECT_FALSE(manager.set(from_string<utl::handle>("00-00-0002-00000000"), 553));
     EXPECT_EQ   (554, manager.get(handle));
-}
\ No newline at end of file
+}
+
+TEST(handle_manager_tests, insert_grow)
+{
+    handle_manager_int manager;
+    std::vector<handle> handles;
+    for (int i = 0; i < 1000; ++i)
+        handles.push_back(manager.insert(0, 0, i));
+    for (int i = 0; i < 1000; ++i)
+        EXPECT_EQ(i, manager.get(handles[static_cast<size_t>(i)]));
+}
+
+TEST(handle_manager_tests, stable_references)
+{
+    handle_manager_int manager;
+    auto  handle = manager.insert(0, 0, 123);
+    auto& value  = manager[handle];
+    for (int i = 0; i < 10000; ++i)
+        manager.insert(0, 0, i);
+    EXPECT_EQ(&value, &manager[handle]);
+    EXPECT_EQ(123, value);
+}
+
+TEST(handle_manager_tests, soa_layout)
+{
+    int val;
+    utl::handle_manager<int, soa_layout> manager;
+    EXPECT_FALSE(manager.is_valid(123));
+    EXPECT_FALSE(manager.try_get(123, val));
+
+    auto handle1 = manager.insert(1, 2, 555);
+    auto handle2 = manager.insert(1, 2, 556);
+    EXPECT_TRUE (manager.is_valid(handle1));
+    EXPECT_TRUE (manager.try_get(handle1, val));
+    EXPECT_EQ   (555, val);
+    EXPECT_TRUE (manager.update(handle2, 554));
+    EXPECT_EQ   (554, manager.get(handle2));
+    manager[handle2] = 553;
+    EXPECT_EQ   (553, manager.get(handle2));
+
+    EXPECT_TRUE (manager.remove(handle1));
+    EXPECT_FALSE(manager.is_valid(handle1));
+    auto handle3 = manager.insert(1, 2, 557);
+    EXPECT_NE   (handle1, handle3);
+    EXPECT_EQ   (557, manager.get(handle3));
+
+    EXPECT_TRUE (manager.set(from_string<utl::handle>("00-00-0001-00000010"), 558));
+    EXPECT_EQ   (558, manager.get(from_string<utl::handle>("00-00-0001-00000010")));
+}
+
+TEST(handle_manager_tests, iterate)
+{
+    handle_manager_int manager;
+    EXPECT_TRUE(manager.begin() == manager.end());
+
+    auto handle0 = manager.insert(1, 0, 10);
+    auto handle1 = manager.insert(2, 0, 11);
+    auto handle2 = manager.insert(1, 3, 12);
+    auto handle3 = manager.insert(2, 3, 13);
+    manager.remove(handle1);
+
+    std::vector<std::pair<handle, int>> values;
+    for (auto p : manager)
+        values.emplace_back(p.first, p.second);
+    ASSERT_EQ(3u, values.size());
+    EXPECT_EQ(handle0, values[0].first);
+    EXPECT_EQ(10,      values[0].second);
+    EXPECT_EQ(handle2, values[1].first);
+    EXPECT_EQ(12,      values[1].second);
+    EXPECT_EQ(handle3, values[2].first);
+    EXPECT_EQ(13,      values[2].second);
+
+    values.clear();
+    for (auto p : manager.system_values(3))
+        values.emplace_back(p.first, p.second);
+    ASSERT_EQ(2u, values.size());
+    EXPECT_EQ(handle2, values[0].first);
+    EXPECT_EQ(handle3, values[1].first);
+
+    values.clear();
+    for (auto p : manager.type_values(1))
+        values.emplace_back(p.first, p.second);
+    ASSERT_EQ(2u, values.size());
+    EXPECT_EQ(handle0, values[0].first);
+    EXPECT_EQ(handle2, values[1].first);
+
+    auto range = manager.system_values(7);
+    EXPECT_TRUE(range.begin() == range.end());
+
+    for (auto p : manager)
+        p.second += 100;
+    EXPECT_EQ(110, manager.get(handle0));
+}
+
+TEST(handle_manager_tests, for_each_chunked)
+{
+    handle_manager<int, soa_layout> manager;
+    for (int i = 0; i < 5000; ++i)
+        manager.insert(0, static_cast<system_id_type>(i % 3), i);
+
+    int sum   = 0;
+    int count = 0;
+    for (size_t chunk = 0; chunk < 7; ++chunk)
+    {
+        manager.for_each(chunk, 7, [&](const handle& h, int& value) {
+            EXPECT_EQ(value, manager.get(h));
+            sum += value;
+            ++count;
+        });
+    }
+    EXPECT_EQ(5000,            count);
+    EXPECT_EQ(4999 * 5000 / 2, sum);
+}
+
+TEST(handle_manager_tests, batch)
+{
+    handle_manager_int manager;
+    auto single = manager.insert(0, 1, 5);
+
+    std::vector<int>    values(2500);
+    std::vector<handle> handles(values.size());
+    for (size_t i = 0; i < values.size(); ++i)
+        values[i] = static_cast<int>(i);
+    manager.insert_n(2, 1, values.data(), values.size(), handles.data());
+    for (size_t i = 0; i < values.size(); ++i)
+    {
+        EXPECT_EQ(2, get_type_id(handles[i]));
+        EXPECT_EQ(values[i], manager.get(handles[i]));
+    }
+
+    std::vector<handle> removed { handles[3], handles[7], handles[3], 0 };
+    EXPECT_EQ(2u, manager.remove_n(removed.data(), removed.size()));
+
+    std::vector<handle> lookup { handles[2], handles[3], single, 12345 };
+    std::vector<int>    result(lookup.size(), -1);
+    bool valid[4];
+    EXPECT_EQ   (2u, manager.try_get_n(lookup.data(), lookup.size(), result.data(), valid));
+    EXPECT_TRUE (valid[0]);
+    EXPECT_FALSE(valid[1]);
+    EXPECT_TRUE (valid[2]);
+    EXPECT_FALSE(valid[3]);
+    EXPECT_EQ   (2,  result[0]);
+    EXPECT_EQ   (-1, result[1]);
+    EXPECT_EQ   (5,  result[2]);
+
+    int count = 0;
+    manager.for_each([&](const handle&, int&) { ++count; });
+    EXPECT_EQ(2499, count);
+
+    manager.insert_n(2, 1, values.data(), 2, handles.data());
+    EXPECT_EQ(0, manager.get(handles[0]));
+    EXPECT_EQ(1, manager.get(handles[1]));
+    EXPECT_TRUE(manager.remove(handles[0]));
+}
+
+TEST(handle_manager_tests, native_encoding)
+{
+    using native_manager_type = utl::handle_manager<int, aos_layout, native_handle_encoding>;
+    native_manager_type native;
+    handle_manager_int  network;
+
+    auto nativeHandle  = native.insert (0x12, 0x34, 555);
+    auto networkHandle = network.insert(0x12, 0x34, 555);
+    EXPECT_EQ   (555, native.get(nativeHandle));
+    EXPECT_EQ   (0x34, native_handle_encoding::decode(nativeHandle).system_id);
+    EXPECT_EQ   (0x12, native_handle_encoding::decode(nativeHandle).type_id);
+    EXPECT_EQ   (networkHandle, native_handle_encoding::to_network(nativeHandle));
+    EXPECT_EQ   (to_string(networkHandle), native_handle_encoding::to_string(nativeHandle));
+
+    handle h;
+    EXPECT_TRUE (native_handle_encoding::from_string(to_string(networkHandle), h));
+    EXPECT_EQ   (nativeHandle, h);
+    EXPECT_TRUE (native.remove(h));
+    EXPECT_FALSE(native.is_valid(nativeHandle));
+}
+
+TEST(handle_manager_tests, handle_layout)
+{
+    using layout_type  = handle_layout<2, 6, 32, 24>;
+    using manager_type = utl::handle_manager<int, aos_layout, layout_type>;
+    manager_type manager;
+
+    auto handle = manager.insert(0x2A, 3, 555);
+    auto hf     = layout_type::decode(handle);
+    EXPECT_EQ(3,    hf.system_id);
+    EXPECT_EQ(0x2A, hf.type_id);
+    EXPECT_EQ(1u,   hf.counter);
+    EXPECT_EQ(0u,   hf.entry_index);
+    EXPECT_EQ(555,  manager.get(handle));
+
+    // a 16 bit counter would wrap around and make the first handle valid again
+    auto first = handle;
+    for (int i = 0; i < 70000; ++i)
+    {
+        EXPECT_TRUE(manager.remove(handle));
+        handle = manager.insert(0x2A, 3, i);
+    }
+    EXPECT_EQ   (0u, layout_type::decode(handle).entry_index);
+    EXPECT_EQ   (70001u, layout_type::decode(handle).counter);
+    EXPECT_FALSE(manager.is_valid(first));
+    EXPECT_TRUE (manager.is_valid(handle));
+}
+
+TEST(handle_manager_tests, handle_layout_full)
+{
+    using manager_type = utl::handle_manager<int, aos_layout, handle_layout<8, 8, 32, 16>>;
+    manager_type manager;
+    for (int i = 0; i < 65536; ++i)
+        manager.insert(0, 0, i);
+    EXPECT_ANY_THROW(manager.insert(0, 0, 0));
+    EXPECT_NO_THROW (manager.insert(0, 1, 0));
+}
+
+TEST(handle_manager_tests, fifo_recycling)
+{
+    using manager_type = utl::handle_manager<int, aos_layout, network_handle_encoding, fifo_recycling<16>>;
+    manager_type manager;
+
+    auto current = manager.insert(0, 0, 0);
+    auto first   = current;
+    for (int i = 0; i < 16; ++i)
+    {
+        EXPECT_TRUE(manager.remove(current));
+        current = manager.insert(0, 0, i);
+        EXPECT_NE(network_handle_encoding::decode(first).entry_index, network_handle_encoding::decode(current).entry_index);
+    }
+
+    std::vector<handle> handles(100);
+    std::vector<int>    values(100, 5);
+    manager.insert_n(0, 0, values.data(), values.size(), handles.data());
+    EXPECT_EQ(100u, manager.remove_n(handles.data(), handles.size()));
+    EXPECT_EQ(15, manager.get(current));
+}
+
+TEST(handle_manager_tests, lowest_index_recycling)
+{
+    using manager_type = utl::handle_manager<int, aos_layout, network_handle_encoding, lowest_index_recycling>;
+    manager_type manager;
+
+    std::vector<handle> handles;
+    for (int i = 0; i < 10; ++i)
+        handles.push_back(manager.insert(0, 0, i));
+    EXPECT_TRUE(manager.remove(handles[7]));
+    EXPECT_TRUE(manager.remove(handles[2]));
+    EXPECT_TRUE(manager.remove(handles[5]));
+
+    EXPECT_EQ(2u,  network_handle_encoding::decode(manager.insert(0, 0, 0)).entry_index);
+    EXPECT_EQ(5u,  network_handle_encoding::decode(manager.insert(0, 0, 0)).entry_index);
+    EXPECT_EQ(7u,  network_handle_encoding::decode(manager.insert(0, 0, 0)).entry_index);
+    EXPECT_EQ(10u, network_handle_encoding::decode(manager.insert(0, 0, 0)).entry_index);
+}
+
+TEST(handle_manager_tests, lowest_index_recycling_after_set)
+{
+    using manager_type = utl::handle_manager<int, aos_layout, network_handle_encoding, lowest_index_recycling>;
+    manager_type manager;
+
+    /* set grows the system up to the given index, the skipped indices are free as well */
+    auto h = from_string<utl::handle>("00-00-0001-00000400");
+    EXPECT_TRUE(manager.set(h, 5));
+    EXPECT_TRUE(manager.remove(h));
+
+    EXPECT_EQ(0u, network_handle_encoding::decode(manager.insert(0, 0, 0)).entry_index);
+    EXPECT_EQ(1u, network_handle_encoding::decode(manager.insert(0, 0, 0)).entry_index);
+
+    /* a free entry that was used by set is not handed out again */
+    auto h2 = from_string<utl::handle>("00-00-0001-00000002");
+    EXPECT_TRUE(manager.set(h2, 7));
+    EXPECT_EQ(3u, network_handle_encoding::decode(manager.insert(0, 0, 0)).entry_index);
+    EXPECT_EQ(7,  manager.get(h2));
+}
+
+TEST(handle_manager_tests, compact)
+{
+    handle_manager_int manager;
+    std::vector<handle> handles;
+    for (int i = 0; i < 10; ++i)
+        handles.push_back(manager.insert(1, 0, i));
+    for (int i = 0; i < 10; i += 2)
+        EXPECT_TRUE(manager.remove(handles[static_cast<size_t>(i)]));
+
+    auto remap = manager.compact();
+    EXPECT_EQ(3u, remap.size());
+    for (auto& r : remap)
+    {
+        EXPECT_FALSE(manager.is_valid(r.first));
+        EXPECT_TRUE (manager.is_valid(r.second));
+        EXPECT_LT   (network_handle_encoding::decode(r.second).entry_index, 5u);
+        EXPECT_EQ   (1, get_type_id(r.second));
+        for (auto& h : handles)
+            if (h == r.first)
+                h = r.second;
+    }
+
+    for (int i = 1; i < 10; i += 2)
+    {
+        auto& h = handles[static_cast<size_t>(i)];
+        EXPECT_EQ(i, manager.get(h));
+        EXPECT_LT(network_handle_encoding::decode(h).entry_index, 5u);
+    }
+
+    auto reused = manager.insert(0, 0, 10);
+    EXPECT_EQ(5u, network_handle_encoding::decode(reused).entry_index);
+    EXPECT_TRUE(manager.compact().empty());
+}
+
+TEST(handle_manager_tests, snapshot)
+{
+    handle_manager_int manager;
+    std::vector<handle> handles;
+    for (int i = 0; i < 3000; ++i)
+        handles.push_back(manager.insert(static_cast<type_id_type>(i % 3), static_cast<system_id_type>(i % 2), i));
+    for (size_t i = 0; i < handles.size(); i += 3)
+        EXPECT_TRUE(manager.remove(handles[i]));
+
+    std::stringstream ss;
+    manager.serialize(ss);
+
+    handle_manager_int restored;
+    restored.insert(0, 5, 0);
+    restored.deserialize(ss);
+    for (size_t i = 0; i < handles.size(); ++i)
+    {
+        EXPECT_EQ(manager.is_valid(handles[i]), restored.is_valid(handles[i]));
+        if (i % 3 != 0)
+        {
+            EXPECT_EQ(static_cast<int>(i), restored.get(handles[i]));
+        }
+    }
+
+    // free list is restored, so new handles are the same for both managers
+    auto h5 = manager.insert(0, 1, 5);
+    EXPECT_EQ(h5, restored.insert(0, 1, 5));
+    EXPECT_EQ(manager.insert(0, 0, 6), restored.insert(0, 0, 6));
+
+    // pages are stored raw, so the layout has to match
+    std::string data = ss.str();
+    utl::handle_manager<int, soa_layout> soa;
+    EXPECT_ANY_THROW(soa.deserialize(data.data(), data.size()));
+
+    EXPECT_ANY_THROW(restored.deserialize(data.data(), data.size() - 1));
+    data[0] = 'X';
+    EXPECT_ANY_THROW(restored.deserialize(data.data(), data.size()));
+    EXPECT_EQ(5, restored.get(h5));
+}
+
+TEST(handle_manager_tests, snapshot_corrupt)
+{
+    handle_manager_int manager;
+    auto h = manager.insert(1, 0, 123);
+    manager.insert(1, 0, 456);
+
+    std::stringstream ss;
+    manager.serialize(ss);
+    const std::string data = ss.str();
+
+    using entry_type  = __impl::entry<int>;
+    auto state_offset = sizeof(__impl::snapshot_header);
+    auto page_offset  = __impl::snapshot_data_offset(1);
+    auto corrupt = [&](size_t offset, uint64_t value, size_t size) {
+        auto ret = data;
+        memcpy(&ret[offset], &value, size);
+        return ret;
+    };
+
+    std::vector<std::string> corrupted {
+        corrupt(state_offset + offsetof(__impl::snapshot_system, first_free), 1u << 30,   8),   // list head out of range
+        corrupt(state_offset + offsetof(__impl::snapshot_system, used_count), 3,         8),   // count does not match
+        corrupt(page_offset,                                                  5000,      8),   // link out of range
+        corrupt(page_offset + sizeof(entry_type),                             1,         8),   // cycle in used list
+        corrupt(page_offset + sizeof(entry_type) + 2 * sizeof(size_t) + 4,    7,         1),   // invalid status
+        data.substr(0, page_offset + 100),                                                      // truncated
+    };
+
+    handle_manager_int restored;
+    auto other = restored.insert(2, 1, 789);
+    for (auto& c : corrupted)
+    {
+        EXPECT_ANY_THROW(restored.deserialize(c.data(), c.size()));
+        EXPECT_EQ   (789, restored.get(other));
+        EXPECT_FALSE(restored.is_valid(h));
+    }
+
+    restored.deserialize(data.data(), data.size());
+    EXPECT_EQ(123, restored.get(h));
+}
+
+TEST(handle_manager_tests, snapshot_mapped_file)
+{
+    handle_manager_int manager;
+    std::vector<handle> handles;
+    for (int i = 0; i < 2000; ++i)
+        handles.push_back(manager.insert(1, 2, i));
+    EXPECT_TRUE(manager.remove(handles[0]));
+
+    std::string filename = ::testing::TempDir() + "handle_manager_snapshot.bin";
+    {
+        std::ofstream os(filename, std::ios::binary);
+        manager.serialize(os);
+    }
+
+    handle_manager_int restored;
+    restored.map_snapshot(filename);
+    EXPECT_FALSE(restored.is_valid(handles[0]));
+    EXPECT_EQ   (456, restored.get(handles[456]));
+
+    // the mapped pages are writable and the systems can grow, the file is not changed
+    EXPECT_EQ   (manager.insert(1, 2, 0), restored.insert(1, 2, 0));
+    EXPECT_TRUE (restored.update(handles[1], 111));
+    EXPECT_TRUE (restored.remove(handles[2]));
+    std::vector<handle> added;
+    for (int i = 0; i < 2000; ++i)
+        added.push_back(restored.insert(1, 2, i));
+    EXPECT_EQ   (111, restored.get(handles[1]));
+    EXPECT_EQ   (1999, restored.get(added.back()));
+
+    restored.clear();
+    EXPECT_FALSE(restored.is_valid(handles[1]));
+
+    handle_manager_int reloaded;
+    reloaded.map_snapshot(filename);
+    std::remove(filename.c_str());
+    EXPECT_EQ   (1, reloaded.get(handles[1]));
+    EXPECT_EQ   (2, reloaded.get(handles[2]));
+    EXPECT_FALSE(reloaded.is_valid(added.back()));
+}
+
+namespace
+{
+    struct copy_counter
+    {
+        static int copies;
+
+        int value;
+
+        copy_counter(int v = 0) :
+            value(v)
+            { }
+
+        copy_counter(const copy_counter& other) :
+            value(other.value)
+            { ++copies; }
+
+        copy_counter(copy_counter&&) = default;
+
+        copy_counter& operator=(const copy_counter& other)
+        {
+            value = other.value;
+            ++copies;
+            return *this;
+        }
+
+        copy_counter& operator=(copy_counter&&) = default;
+    };
+
+    int copy_counter::copies = 0;
+}
+
+TEST(handle_manager_tests, move_only)
+{
+    using manager_type = utl::handle_manager<std::unique_ptr<int>>;
+    manager_type manager;
+
+    auto h0 = manager.emplace(1, 0, new int(5));
+    auto h1 = manager.insert (1, 0, std::make_unique<int>(6));
+    EXPECT_EQ   (5, *manager.get_ref(h0));
+    EXPECT_EQ   (6, **manager.try_get_ptr(h1));
+    EXPECT_TRUE (manager.update(h0, std::make_unique<int>(7)));
+    EXPECT_EQ   (7, *manager.get_ref(h0));
+    EXPECT_TRUE (manager.remove(h0));
+    EXPECT_EQ   (nullptr, manager.try_get_ptr(h0));
+    EXPECT_ANY_THROW(manager.get_ref(h0));
+
+    auto remap = manager.compact();
+    ASSERT_EQ(1u, remap.size());
+    EXPECT_EQ(6, *manager.get_ref(remap[0].second));
+
+    const auto& cmanager = manager;
+    EXPECT_EQ(6, *cmanager.get_ref(remap[0].second));
+    EXPECT_EQ(nullptr, cmanager.try_get_ptr(h1));
+}
+
+TEST(handle_manager_tests, remove_releases_value)
+{
+    auto value = std::make_shared<int>(5);
+    utl::handle_manager<std::shared_ptr<int>> manager;
+    auto h0 = manager.insert(0, 0, value);
+    auto h1 = manager.insert(0, 0, value);
+    auto h2 = manager.insert(0, 0, value);
+    EXPECT_EQ(4, value.use_count());
+
+    EXPECT_TRUE(manager.remove(h0));
+    EXPECT_EQ(3, value.use_count());
+
+    EXPECT_EQ(1u, manager.remove_n(&h1, 1));
+    EXPECT_EQ(2, value.use_count());
+
+    auto remap = manager.compact();
+    ASSERT_EQ(1u, remap.size());
+    EXPECT_EQ(h2, remap[0].first);
+    EXPECT_EQ(2, value.use_count());
+    EXPECT_EQ(5, *manager.get_ref(remap[0].second));
+}
+
+TEST(handle_manager_tests, insert_n_move)
+{
+    using manager_type = utl::handle_manager<std::unique_ptr<int>>;
+    manager_type manager;
+
+    std::vector<std::unique_ptr<int>> values;
+    values.push_back(std::make_unique<int>(1));
+    values.push_back(std::make_unique<int>(2));
+    std::vector<handle> handles(values.size());
+    manager.insert_n(0, 0, std::make_move_iterator(values.begin()), values.size(), handles.data());
+    EXPECT_EQ(nullptr, values[0]);
+    EXPECT_EQ(nullptr, values[1]);
+    EXPECT_EQ(1, *manager.get_ref(handles[0]));
+    EXPECT_EQ(2, *manager.get_ref(handles[1]));
+}
+
+namespace
+{
+    /* copy constructor throws after a given number of copies */
+    struct throwing_copy
+    {
+        static int copies_left;
+
+        int value;
+
+        throwing_copy(int v = 0) :
+            value(v)
+            { }
+
+        throwing_copy(const throwing_copy& other) :
+            value(other.value)
+        {
+            if (copies_left-- <= 0)
+                throw std::runtime_error("copy failed");
+        }
+
+        throwing_copy& operator=(const throwing_copy&) = default;
+    };
+
+    int throwing_copy::copies_left = 0;
+
+    template<class T_manager>
+    void check_insert_n_throwing()
+    {
+        T_manager manager;
+        throwing_copy::copies_left = 100;
+        auto h0 = manager.insert(0, 0, throwing_copy(1));
+
+        std::vector<throwing_copy> values { 2, 3, 4, 5 };
+        std::vector<handle> handles(values.size());
+        throwing_copy::copies_left = 2;
+        EXPECT_THROW(manager.insert_n(0, 0, values.begin(), values.size(), handles.data()), std::runtime_error);
+
+        std::vector<int> stored;
+        for (auto p : manager)
+            stored.push_back(p.second.value);
+        EXPECT_EQ((std::vector<int> { 1 }), stored);
+
+        throwing_copy::copies_left = 100;
+        manager.insert_n(0, 0, values.begin(), values.size(), handles.data());
+        auto h1 = manager.insert(0, 0, throwing_copy(6));
+
+        stored.clear();
+        for (auto p : manager)
+            stored.push_back(p.second.value);
+        EXPECT_EQ((std::vector<int> { 1, 2, 3, 4, 5, 6 }), stored);
+        EXPECT_EQ(1, manager.get_ref(h0).value);
+        EXPECT_EQ(6, manager.get_ref(h1).value);
+    }
+}
+
+TEST(handle_manager_tests, insert_n_throwing)
+{
+    check_insert_n_throwing<utl::handle_manager<throwing_copy>>();
+    check_insert_n_throwing<utl::handle_manager<throwing_copy, soa_layout>>();
+    check_insert_n_throwing<utl::handle_manager<throwing_copy, aos_layout, network_handle_encoding, fifo_recycling<>>>();
+    check_insert_n_throwing<utl::handle_manager<throwing_copy, aos_layout, network_handle_encoding, lowest_index_recycling>>();
+}
+
+TEST(handle_manager_tests, no_copies)
+{
+    utl::handle_manager<copy_counter, soa_layout> manager;
+    copy_counter::copies = 0;
+
+    auto h = manager.emplace(0, 0, 5);
+    EXPECT_EQ(5, manager.get_ref(h).value);
+    manager.get_ref(h).value = 6;
+    EXPECT_EQ(6, manager.try_get_ptr(h)->value);
+    EXPECT_TRUE(manager.update(h, copy_counter(7)));
+    EXPECT_EQ(7, manager.get_ref(h).value);
+    EXPECT_EQ(0, copy_counter::copies);
+}
+
+namespace
+{
+    /* neither copyable nor movable, throws for negative values */
+    struct pinned_value
+    {
+        int value;
+
+        pinned_value(int v = 0) :
+            value(v)
+        {
+            if (v < 0)
+                throw std::runtime_error("negative value");
+        }
+
+        pinned_value(pinned_value&&) = delete;
+        pinned_value& operator=(pinned_value&&) = delete;
+    };
+
+    template<class T_manager>
+    void check_emplace_throwing()
+    {
+        T_manager manager;
+        auto h0 = manager.emplace(0, 0, 1);
+        EXPECT_THROW(manager.emplace(0, 0, -1), std::runtime_error);
+        auto h1 = manager.emplace(0, 0, 2);
+        EXPECT_THROW(manager.emplace(0, 0, -2), std::runtime_error);
+
+        std::vector<int> values;
+        for (auto p : manager)
+            values.push_back(p.second.value);
+        EXPECT_EQ((std::vector<int> { 1, 2 }), values);
+        EXPECT_EQ(1, manager.get_ref(h0).value);
+        EXPECT_EQ(2, manager.get_ref(h1).value);
+
+        EXPECT_TRUE(manager.remove(h0));
+        auto h2 = manager.emplace(0, 0, 3);
+        EXPECT_FALSE(manager.is_valid(h0));
+        EXPECT_EQ(3, manager.get_ref(h2).value);
+    }
+}
+
+TEST(handle_manager_tests, emplace_throwing)
+{
+    check_emplace_throwing<utl::handle_manager<pinned_value>>();
+    check_emplace_throwing<utl::handle_manager<pinned_value, soa_layout>>();
+}
+
+TEST(handle_manager_tests, reserve_shrink_to_fit)
+{
+    handle_manager_int manager;
+    manager.reserve(2, 5000);
+    auto stats = manager.memory_stats();
+    ASSERT_EQ(3u, stats.size());
+    EXPECT_EQ(0u,    stats[0].capacity);
+    EXPECT_EQ(5120u, stats[2].capacity);
+    EXPECT_EQ(5120u, stats[2].free);
+    EXPECT_EQ(0u,    stats[2].live);
+    EXPECT_LT(5120u * sizeof(int), stats[2].bytes);
+
+    std::vector<handle> handles;
+    for (int i = 0; i < 5000; ++i)
+        handles.push_back(manager.insert(0, 2, i));
+    stats = manager.memory_stats();
+    EXPECT_EQ(5120u, stats[2].capacity);
+    EXPECT_EQ(5000u, stats[2].live);
+    EXPECT_EQ(120u,  stats[2].free);
+
+    for (size_t i = 1000; i < handles.size(); ++i)
+        EXPECT_TRUE(manager.remove(handles[i]));
+    auto bytes = stats[2].bytes;
+    manager.shrink_to_fit();
+    stats = manager.memory_stats();
+    EXPECT_EQ(1024u, stats[2].capacity);
+    EXPECT_EQ(1000u, stats[2].live);
+    EXPECT_EQ(24u,   stats[2].free);
+    EXPECT_GT(bytes, stats[2].bytes);
+    for (size_t i = 0; i < 1000; ++i)
+        EXPECT_EQ(static_cast<int>(i), manager.get(handles[i]));
+
+    // the released entries are not in the free list anymore
+    for (int i = 0; i < 24; ++i)
+    {
+        auto index = network_handle_encoding::decode(manager.insert(0, 2, i)).entry_index;
+        EXPECT_GE(index, 1000u);
+        EXPECT_LT(index, 1024u);
+    }
+    EXPECT_EQ(1024u, network_handle_encoding::decode(manager.insert(0, 2, 0)).entry_index);
+    EXPECT_EQ(2048u, manager.memory_stats()[2].capacity);
+}
+
+TEST(handle_manager_tests, growth_factor)
+{
+    utl::handle_manager<int, soa_layout, network_handle_encoding, lowest_index_recycling> manager;
+    EXPECT_ANY_THROW(manager.growth_factor(0.5));
+    manager.growth_factor(2.0);
+
+    std::vector<handle> handles;
+    for (int i = 0; i < 1025; ++i)
+        handles.push_back(manager.insert(0, 0, i));
+    EXPECT_EQ(2048u, manager.memory_stats()[0].capacity);
+    for (int i = 1025; i < 2049; ++i)
+        handles.push_back(manager.insert(0, 0, i));
+    EXPECT_EQ(4096u, manager.memory_stats()[0].capacity);
+
+    for (size_t i = 100; i < handles.size(); ++i)
+        EXPECT_TRUE(manager.remove(handles[i]));
+    manager.shrink_to_fit();
+    EXPECT_EQ(1024u, manager.memory_stats()[0].capacity);
+    EXPECT_EQ(100u, network_handle_encoding::decode(manager.insert(0, 0, 0)).entry_index);
+}
@@ -0,0 +1,175 @@
+#include <set>
+#include <atomic>
+#include <thread>
+#include <vector>
+#include <gtest/gtest.h>
+#include <cpputils/container/sharded_handle_manager.h>
+
+using namespace utl;
+
+using sharded_handle_manager_int = utl::sharded_handle_manager<int, 3>;
+
+TEST(sharded_handle_manager_tests, insert_remove)
+{
+    sharded_handle_manager_int manager;
+    auto handle = manager.insert(5, 1, 2, 123);
+    EXPECT_TRUE (manager.is_valid(handle));
+    EXPECT_EQ   (5u,  sharded_handle_manager_int::shard_of(handle));
+    EXPECT_EQ   (1,   get_type_id(handle));
+    EXPECT_EQ   (2,   get_system_id(handle));
+    EXPECT_EQ   (123, manager.get(handle));
+    EXPECT_TRUE (manager.update(handle, 456));
+    EXPECT_EQ   (456, manager.get(handle));
+    EXPECT_FALSE(manager.remove(156161));
+    EXPECT_TRUE (manager.remove(handle));
+    EXPECT_FALSE(manager.remove(handle));
+    EXPECT_FALSE(manager.is_valid(handle));
+    EXPECT_ANY_THROW(manager.get(handle));
+    EXPECT_ANY_THROW(manager.insert(8, 0, 0, 0));
+
+    auto other = manager.insert(4, 1, 2, 789);
+    EXPECT_NE   (handle, other);
+    EXPECT_EQ   (4u, sharded_handle_manager_int::shard_of(other));
+    EXPECT_EQ   (789, manager.get(other));
+
+    manager.clear();
+    EXPECT_FALSE(manager.is_valid(other));
+}
+
+TEST(sharded_handle_manager_tests, multi_threaded)
+{
+    static constexpr int thread_count = 8;
+    static constexpr int value_count  = 10000;
+
+    sharded_handle_manager_int manager;
+    std::vector<std::vector<handle>> handles(thread_count);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < thread_count; ++t)
+    {
+        threads.emplace_back([&, t]{
+            auto& h = handles[static_cast<size_t>(t)];
+            for (int i = 0; i < value_count; ++i)
+            {
+                h.push_back(manager.insert(static_cast<size_t>(t), 0, 0, t * value_count + i));
+                if (i & 1)
+                {
+                    EXPECT_TRUE(manager.remove(h.back()));
+                    h.pop_back();
+                }
+            }
+        });
+    }
+    for (auto& t : threads)
+        t.join();
+
+    std::set<handle> unique;
+    for (int t = 0; t < thread_count; ++t)
+    {
+        for (auto& h : handles[static_cast<size_t>(t)])
+        {
+            EXPECT_TRUE(unique.insert(h).second);
+            EXPECT_EQ  (static_cast<size_t>(t), sharded_handle_manager_int::shard_of(h));
+            EXPECT_EQ  (t, manager.get(h) / value_count);
+        }
+    }
+    EXPECT_EQ(static_cast<size_t>(thread_count * value_count / 2), unique.size());
+}
+
+TEST(sharded_handle_manager_tests, shard_leases)
+{
+    static constexpr size_t shard_count = sharded_handle_manager_int::shard_count;
+
+    /* more threads than shards use the manager over time, but only shard_count threads at the same time */
+    sharded_handle_manager_int manager;
+    for (int wave = 0; wave < 4; ++wave)
+    {
+        std::atomic<size_t>      inserted(0);
+        std::atomic<bool>        done(false);
+        std::vector<size_t>      shards(shard_count);
+        std::vector<std::thread> threads;
+        for (size_t t = 0; t < shard_count; ++t)
+        {
+            threads.emplace_back([&, t]{
+                shards[t] = sharded_handle_manager_int::shard_of(manager.insert(0, 0, static_cast<int>(t)));
+                EXPECT_EQ(shards[t], manager.current_shard());
+                ++inserted;
+                while (!done)
+                    std::this_thread::yield();
+            });
+        }
+        while (inserted < shard_count)
+            std::this_thread::yield();
+
+        /* all shards are leased by the running threads */
+        std::thread([&]{ EXPECT_ANY_THROW(manager.insert(0, 0, 0)); }).join();
+
+        done = true;
+        for (auto& t : threads)
+            t.join();
+        EXPECT_EQ(shard_count, std::set<size_t>(shards.begin(), shards.end()).size());
+    }
+}
+
+TEST(sharded_handle_manager_tests, concurrent_resolve)
+{
+    using manager_type = utl::sharded_handle_manager<uint64_t, 3>;
+    static constexpr size_t writer_count = 4;
+    static constexpr size_t reader_count = 4;
+    static constexpr size_t slot_count   = 64;
+    static constexpr size_t op_count     = 20000;
+
+    /* each writer replaces the handles of its slots, readers resolve all slots at the same time */
+    manager_type manager;
+    std::vector<std::atomic<uint64_t>> slots(writer_count * slot_count);
+    for (auto& slot : slots)
+        slot = 0;
+    std::atomic<bool>   done(false);
+    std::atomic<size_t> resolved(0);
+
+    std::vector<std::thread> readers;
+    for (size_t r = 0; r < reader_count; ++r)
+    {
+        readers.emplace_back([&]{
+            size_t count = 0;
+            while (!done)
+            {
+                for (auto& slot : slots)
+                {
+                    handle   h = slot.load();
+                    uint64_t value;
+                    if (!manager.try_get(h, value))
+                        continue;
+                    EXPECT_EQ(manager_type::shard_of(h), value >> 32);
+                    ++count;
+                }
+            }
+            resolved += count;
+        });
+    }
+
+    std::vector<std::thread> writers;
+    for (size_t w = 0; w < writer_count; ++w)
+    {
+        writers.emplace_back([&, w]{
+            for (size_t i = 0; i < op_count; ++i)
+            {
+                auto& slot = slots[w * slot_count + i % slot_count];
+                manager.remove(slot.load());
+                slot = manager.insert(w, 0, static_cast<system_id_type>(i % 2), (uint64_t(w) << 32) | i);
+            }
+        });
+    }
+    for (auto& t : writers)
+        t.join();
+    done = true;
+    for (auto& t : readers)
+        t.join();
+
+    EXPECT_LT(0u, resolved.load());
+    for (size_t i = 0; i < slots.size(); ++i)
+    {
+        uint64_t value;
+        ASSERT_TRUE(manager.try_get(slots[i].load(), value));
+        EXPECT_EQ  (i / slot_count, value >> 32);
+    }
+}
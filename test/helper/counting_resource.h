@@ -0,0 +1,32 @@
+#pragma once
+
+#include <cstddef>
+#include <memory_resource>
+
+namespace test_helper
+{
+
+    /* memory resource that counts the allocations passed to the new/delete resource */
+    struct counting_resource
+        : public std::pmr::memory_resource
+    {
+        size_t allocations   = 0;
+        size_t deallocations = 0;
+
+        void* do_allocate(size_t bytes, size_t alignment) override
+        {
+            ++allocations;
+            return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+        }
+
+        void do_deallocate(void* p, size_t bytes, size_t alignment) override
+        {
+            ++deallocations;
+            std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+        }
+
+        bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override
+            { return this == &other; }
+    };
+
+}
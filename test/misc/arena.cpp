@@ -0,0 +1,68 @@
+#include <vector>
+#include <memory_resource>
+#include <gtest/gtest.h>
+#include <cpputils/misc/arena.h>
+#include "../helper/counting_resource.h"
+
+using namespace ::utl;
+
+namespace arena_tests
+{
+    using ::test_helper::counting_resource;
+}
+
+using namespace ::arena_tests;
+
+TEST(arena_tests, allocate)
+{
+    counting_resource upstream;
+    arena a(1024, &upstream);
+    EXPECT_EQ(0, a.block_count());
+
+    auto p0 = static_cast<char*>(a.allocate(10, 1));
+    auto p1 = static_cast<char*>(a.allocate(8, 8));
+    auto p2 = static_cast<char*>(a.allocate(64, 64));
+    EXPECT_LE(p0 + 10, p1);
+    EXPECT_EQ(0, reinterpret_cast<uintptr_t>(p1) % 8);
+    EXPECT_EQ(0, reinterpret_cast<uintptr_t>(p2) % 64);
+    EXPECT_LE(p1 + 8, p2);
+    EXPECT_EQ(1,  a.block_count());
+    EXPECT_EQ(1,  upstream.allocations);
+    EXPECT_EQ(82, a.used());
+
+    /* requests that exceed the block size get their own block */
+    auto big = a.allocate(4096, 16);
+    EXPECT_NE(nullptr, big);
+    EXPECT_EQ(2, a.block_count());
+    EXPECT_GE(a.capacity(), 1024 + 4096);
+
+    a.release();
+    EXPECT_EQ(0, a.block_count());
+    EXPECT_EQ(0, a.used());
+    EXPECT_EQ(upstream.allocations, upstream.deallocations);
+}
+
+TEST(arena_tests, reset_keeps_blocks)
+{
+    counting_resource upstream;
+    {
+        arena a(256, &upstream);
+        for (size_t run = 0; run < 10; ++run)
+        {
+            std::pmr::vector<int> v(&a);
+            for (int i = 0; i < 1000; ++i)
+                v.push_back(i);
+            EXPECT_EQ(999, v.back());
+            a.reset();
+        }
+
+        /* all runs after the first one reuse the blocks of the first run */
+        auto allocations = upstream.allocations;
+        std::pmr::vector<int> v(&a);
+        for (int i = 0; i < 1000; ++i)
+            v.push_back(i);
+        EXPECT_EQ(allocations, upstream.allocations);
+        EXPECT_EQ(0, upstream.deallocations);
+    }
+    EXPECT_EQ(upstream.allocations, upstream.deallocations);
+}
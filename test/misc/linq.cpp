@@ -1,6 +1,9 @@
 #include <vector>
+#include <numeric>
 #include <gtest/gtest.h>
 #include <cpputils/misc/linq.h>
+#include <cpputils/misc/arena.h>
+#include "../helper/counting_resource.h"
 
 namespace linq_tests
 {
@@ -113,6 +116,28 @@ TEST(LinqTest, from_container)
     ASSERT_FALSE(range.next());
 }
 
+TEST(LinqTest, from_container_owned)
+{
+    EXPECT_EQ(3u, from_container(std::vector<int>({ 1, 2, 3 })) >> count());
+    EXPECT_EQ(6,  from_container(std::vector<int>({ 1, 2, 3 })) >> sum());
+    EXPECT_EQ(std::vector<int>({ 1, 2, 3 }), from_container(std::vector<int>({ 1, 2, 3 })) >> to_vector());
+
+    // copies of an initialized range iterate their own container
+    auto range = from_container(std::vector<int>({ 4, 5, 6 }));
+    ASSERT_TRUE (range.next());
+    const auto& crange = range;
+    auto copy = crange;
+    ASSERT_TRUE (range.next());
+    ASSERT_EQ   (4, copy.front());
+    ASSERT_TRUE (copy.next());
+    ASSERT_EQ   (5, copy.front());
+    auto moved = std::move(copy);
+    ASSERT_EQ   (5, moved.front());
+    ASSERT_TRUE (moved.next());
+    ASSERT_EQ   (6, moved.front());
+    ASSERT_FALSE(moved.next());
+}
+
 TEST(LinqTest, from_array)
 {
     int data[] = { 4, 5, 6, 7, 8 };
@@ -932,4 +957,671 @@ TEST(LinqTest, const_objects)
     ASSERT_NE(it, v.end());
     EXPECT_EQ(1, it->value);
     }
-}
\ No newline at end of file
+}
+TEST(LinqTest, parallel)
+{
+    std::vector<int> data;
+    for (int i = 0; i < 1000; ++i)
+        data.push_back(i);
+
+    auto is_even = [](int& i) {
+        return (i & 1) == 0;
+    };
+    auto square = [](int& i) -> int64_t {
+        return static_cast<int64_t>(i) * i;
+    };
+    using is_even_type = decltype(is_even);
+    using square_type  = decltype(square);
+
+    EXPECT_EQ(1000,      from_container(data) >> parallel(4) >> count());
+    EXPECT_EQ(500,       from_container(data) >> parallel(4) >> where(is_even_type(is_even)) >> count());
+    EXPECT_EQ(166167000, from_container(data) >> parallel(4) >> where(is_even_type(is_even)) >> select(square_type(square)) >> linq::sum());
+    EXPECT_EQ(0,         from_container(data) >> parallel(3) >> min());
+    EXPECT_EQ(999,       from_container(data) >> parallel(3) >> max());
+    EXPECT_TRUE (        from_container(data) >> parallel(8) >> where([](int& i) { return i == 999; }) >> any());
+    EXPECT_FALSE(        from_container(data) >> parallel(8) >> where([](int& i) { return i > 999; }) >> any());
+
+    auto v = from_container(data) >> parallel(7) >> where(is_even_type(is_even)) >> to_vector();
+    ASSERT_EQ(500, v.size());
+    for (size_t i = 0; i < v.size(); ++i)
+        EXPECT_EQ(static_cast<int>(2 * i), v[i]);
+
+    std::vector<int> small({ 1, 2 });
+    EXPECT_EQ(3, from_container(small) >> parallel(16) >> linq::sum());
+
+    std::vector<int> empty;
+    EXPECT_EQ(0, from_container(empty) >> parallel(4) >> count());
+
+    auto first_value = from_container(data) >> parallel(4) >> where(is_even_type(is_even)) >> first();
+    EXPECT_EQ(0, first_value);
+
+    EXPECT_ANY_THROW(from_container(data) >> parallel(4) >> select([](int& i) -> int {
+        if (i == 500)
+            throw utl::exception("error");
+        return i;
+    }) >> linq::sum());
+}
+
+TEST(LinqTest, random_access)
+{
+    std::vector<int> data({ 4, 5, 6, 7, 8 });
+
+    auto range = from_container(data);
+    EXPECT_EQ   (5, range.range.size());
+    ASSERT_TRUE (range.next());
+    EXPECT_EQ   (4, range.range.size());
+    EXPECT_EQ   (&data[1], &range.range.at(0));
+    EXPECT_EQ   (4, range >> count());
+
+    auto selected = from_container(data)
+        >>  select([](int& i) {
+                return i * 2;
+            });
+    ASSERT_TRUE (selected.next());
+    EXPECT_EQ   (8, selected.front());
+    auto v = selected >> to_vector();
+    ASSERT_EQ   (4, v.size());
+    EXPECT_EQ   (4, v.capacity());
+    EXPECT_EQ   (10, v[0]);
+    EXPECT_EQ   (16, v[3]);
+
+    EXPECT_EQ   (60, from_container(data) >> select([](int& i) { return i * 2; }) >> linq::sum());
+    EXPECT_EQ   (4,  from_container(data) >> select([](int& i) { return i; }) >> min());
+    EXPECT_EQ   (8,  from_container(data) >> select([](int& i) { return i; }) >> max());
+
+    using pair_type = std::pair<int, int>;
+    std::vector<pair_type> pairs({ { 1, 10 }, { 2, 20 }, { 1, 11 }, { 1, 12 } });
+    auto lookup = from_container(pairs) >> to_lookup();
+    EXPECT_EQ   (3,  lookup[1] >> count());
+    EXPECT_EQ   (33, lookup[1] >> linq::sum());
+    EXPECT_EQ   (1,  lookup[2] >> count());
+    EXPECT_EQ   (0,  lookup[3] >> count());
+}
+
+TEST(LinqTest, simd_reducers)
+{
+    std::vector<float> floats({ -3.5f, -1.25f, -8.0f, -2.0f, -4.0f, -6.5f, -7.0f, -0.5f, -9.0f });
+    EXPECT_FLOAT_EQ(-41.75f, from_container(floats) >> linq::sum());
+    EXPECT_FLOAT_EQ(-9.0f,   from_container(floats) >> min());
+    EXPECT_FLOAT_EQ(-0.5f,   from_container(floats) >> max());
+    EXPECT_FLOAT_EQ(-0.5f,   from_container(floats) >> select([](float& f) { return f; }) >> max());
+
+    std::vector<int64_t> ints;
+    for (int64_t i = 0; i < 1000; ++i)
+        ints.push_back((i * 37) % 1000 - 500);
+    EXPECT_EQ(-500, from_container(ints) >> min());
+    EXPECT_EQ(499,  from_container(ints) >> max());
+    EXPECT_EQ(-500, from_container(ints) >> linq::sum());
+    EXPECT_EQ(-500, from_container(ints) >> parallel(4) >> linq::sum());
+    EXPECT_EQ(499,  from_container(ints) >> parallel(4) >> max());
+
+    const int array[] = { 5, 3, 9, 1 };
+    EXPECT_EQ(18, from_array(array) >> linq::sum());
+    EXPECT_EQ(1,  from_array(array) >> min());
+}
+
+TEST(LinqTest, take_skip)
+{
+    std::vector<int> data({ 4, 5, 6, 7, 8 });
+
+    auto range = from_container(data) >> skip(1) >> take(3);
+    ASSERT_TRUE (range.next());
+    ASSERT_EQ   (&data.at(1), &range.front());
+    ASSERT_TRUE (range.next());
+    ASSERT_EQ   (&data.at(2), &range.front());
+    ASSERT_TRUE (range.next());
+    ASSERT_EQ   (&data.at(3), &range.front());
+    ASSERT_FALSE(range.next());
+
+    EXPECT_EQ(3,  from_container(data) >> take(3) >> count());
+    EXPECT_EQ(5,  from_container(data) >> take(10) >> count());
+    EXPECT_EQ(0,  from_container(data) >> skip(10) >> count());
+    EXPECT_EQ(15, from_container(data) >> take(3) >> linq::sum());
+    EXPECT_EQ(21, from_container(data) >> skip(2) >> linq::sum());
+    EXPECT_EQ(2,  from_container(data) >> where([](int& i) { return (i & 1) == 0; }) >> skip(1) >> count());
+
+    auto v = from_container(data) >> skip(1) >> take(2) >> to_vector();
+    ASSERT_EQ(2, v.size());
+    EXPECT_EQ(5, v[0]);
+    EXPECT_EQ(6, v[1]);
+}
+
+TEST(LinqTest, order_by_take)
+{
+    std::vector<int> data({ 6, 3, 8, 5, 1, 9, 2, 7, 4, 0 });
+
+    auto range = from_container(data) >> order_by() >> take(3);
+    ASSERT_TRUE (range.next());
+    ASSERT_EQ   (&data.at(9), &range.front());
+    ASSERT_TRUE (range.next());
+    ASSERT_EQ   (&data.at(4), &range.front());
+    ASSERT_TRUE (range.next());
+    ASSERT_EQ   (&data.at(6), &range.front());
+    ASSERT_FALSE(range.next());
+
+    auto v = from_container(data) >> order_by() >> skip(2) >> take(3) >> to_vector();
+    ASSERT_EQ(3, v.size());
+    EXPECT_EQ(2, v[0]);
+    EXPECT_EQ(3, v[1]);
+    EXPECT_EQ(4, v[2]);
+
+    EXPECT_EQ(0,  from_container(data) >> order_by() >> first());
+    EXPECT_EQ(0,  from_container(data) >> order_by() >> first_or_default());
+    EXPECT_EQ(10, from_container(data) >> order_by() >> take(20) >> count());
+    EXPECT_EQ(0,  from_container(data) >> order_by() >> take(0) >> count());
+
+    auto desc = from_container(data)
+        >>  order_by(op_select_default(), [](int l, int r) { return l > r; })
+        >>  take(2)
+        >>  to_vector();
+    ASSERT_EQ(2, desc.size());
+    EXPECT_EQ(9, desc[0]);
+    EXPECT_EQ(8, desc[1]);
+
+    /* a limit must not change the ordered range it was applied to */
+    auto ordered = from_container(data) >> order_by();
+    EXPECT_EQ(2,  ordered >> take(2) >> count());
+    EXPECT_EQ(10, ordered >> count());
+}
+
+TEST(LinqTest, distinct_hash)
+{
+    std::vector<int> data({ 4, 2, 4, 7, 2, 9, 7, 4, 1 });
+
+    auto range = from_container(data) >> distinct_hash();
+    ASSERT_TRUE (range.next());
+    ASSERT_EQ   (&data.at(0), &range.front());
+    ASSERT_TRUE (range.next());
+    ASSERT_EQ   (&data.at(1), &range.front());
+    ASSERT_TRUE (range.next());
+    ASSERT_EQ   (&data.at(3), &range.front());
+    ASSERT_TRUE (range.next());
+    ASSERT_EQ   (&data.at(5), &range.front());
+    ASSERT_TRUE (range.next());
+    ASSERT_EQ   (&data.at(8), &range.front());
+    ASSERT_FALSE(range.next());
+
+    std::vector<test_data> objects({ 1, 11, 2, 21, 3, 12 });
+    auto v = from_container(objects)
+        >>  distinct_hash(
+                [](const test_data& d) { return std::hash<int>()(d.value % 10); },
+                [](const test_data& l, const test_data& r) { return l.value % 10 == r.value % 10; })
+        >>  select([](test_data& d) { return d.value; })
+        >>  to_vector();
+    EXPECT_EQ(std::vector<int>({ 1, 2, 3 }), v);
+
+    /* enough distinct values to grow the hash table several times */
+    std::vector<int> many;
+    for (int i = 0; i < 10000; ++i)
+        many.push_back((i * 7919) % 1000);
+    EXPECT_EQ(1000, from_container(many) >> distinct_hash() >> count());
+    EXPECT_EQ(from_container(many) >> distinct() >> count(), from_container(many) >> distinct_hash() >> count());
+}
+
+TEST(LinqTest, to_hash_lookup)
+{
+    using pair_type   = std::pair<int, std::string>;
+    using vector_type = std::vector<pair_type>;
+    vector_type data({
+        { 2, "Str2-0" },
+        { 0, "Str0-0" },
+        { 1, "Str1-0" },
+        { 0, "Str0-1" },
+        { 2, "Str2-1" },
+        { 0, "Str0-2" },
+    });
+    auto lookup = from_container(data)
+        >>  to_hash_lookup([](pair_type& p)->int&{
+                return p.first;
+            }, [](pair_type& p)->std::string&{
+                return p.second;
+            });
+    EXPECT_EQ(3, lookup.size());
+
+    auto range0 = lookup[0];
+    ASSERT_TRUE (range0.next());
+    ASSERT_EQ   (&data.at(1).second, &range0.front());
+    ASSERT_TRUE (range0.next());
+    ASSERT_EQ   (&data.at(3).second, &range0.front());
+    ASSERT_TRUE (range0.next());
+    ASSERT_EQ   (&data.at(5).second, &range0.front());
+    ASSERT_FALSE(range0.next());
+
+    EXPECT_EQ(2, lookup[2] >> count());
+    EXPECT_EQ(1, lookup[1] >> count());
+    EXPECT_EQ(0, lookup[5] >> count());
+
+    /* keys are iterated in the order of their first occurence */
+    using key_value_range_type = linq::hash_lookup_key_value_range_type<int&, std::string&>;
+    auto keys = lookup
+        >>  select([](key_value_range_type::value_type v){
+                return v.first;
+            })
+        >>  to_vector();
+    EXPECT_EQ(std::vector<int>({ 2, 0, 1 }), keys);
+
+    using copy_key_value_range_type = linq::hash_lookup_key_value_range_type<int, std::string>;
+    auto map = from_container(data)
+        >>  to_hash_lookup()
+        >>  to_map([](copy_key_value_range_type::value_type v){
+                return v.first;
+            }, [](copy_key_value_range_type::value_type v){
+                return v.second >> to_vector();
+            });
+    using map_type = decltype(map);
+    map_type expected({
+        { 0, { "Str0-0", "Str0-1", "Str0-2" } },
+        { 1, { "Str1-0" } },
+        { 2, { "Str2-0", "Str2-1" } }
+    });
+    EXPECT_EQ(expected, map);
+}
+
+TEST(LinqTest, group_by)
+{
+    std::vector<std::string> data({ "apple", "kiwi", "avocado", "banana", "cherry", "blueberry", "akee" });
+
+    auto groups = from_container(data)
+        >>  group_by([](std::string& s) { return s.front(); })
+        >>  select([](auto g) {
+                return std::make_pair(g.first, g.second >> to_vector());
+            })
+        >>  to_vector();
+
+    ASSERT_EQ(4, groups.size());
+    EXPECT_EQ('a', groups[0].first);
+    EXPECT_EQ(std::vector<std::string>({ "apple", "avocado", "akee" }), groups[0].second);
+    EXPECT_EQ('k', groups[1].first);
+    EXPECT_EQ(std::vector<std::string>({ "kiwi" }), groups[1].second);
+    EXPECT_EQ('b', groups[2].first);
+    EXPECT_EQ(std::vector<std::string>({ "banana", "blueberry" }), groups[2].second);
+    EXPECT_EQ('c', groups[3].first);
+    EXPECT_EQ(std::vector<std::string>({ "cherry" }), groups[3].second);
+
+    std::vector<int> empty;
+    EXPECT_EQ(0, from_container(empty) >> group_by([](int i) { return i; }) >> count());
+}
+
+TEST(LinqTest, reference_mode)
+{
+    std::vector<TestData2> data({
+        { 3, "c" },
+        { 1, "a" },
+        { 2, "b" },
+        { 1, "d" },
+    });
+
+    size_t selects = 0;
+    auto range = from_container(data)
+        >>  order_by_ref([&](TestData2& d) {
+                ++selects;
+                return d.value;
+            });
+    ASSERT_TRUE (range.next());
+    ASSERT_EQ   (&data.at(1), &range.front());
+    ASSERT_TRUE (range.next());
+    ASSERT_EQ   (&data.at(3), &range.front());
+    ASSERT_TRUE (range.next());
+    ASSERT_EQ   (&data.at(2), &range.front());
+    ASSERT_TRUE (range.next());
+    ASSERT_EQ   (&data.at(0), &range.front());
+    ASSERT_FALSE(range.next());
+    EXPECT_EQ   (4, selects);
+
+    auto desc = from_container(data)
+        >>  order_by_ref([](TestData2& d) -> std::string& { return d.name; }, [](const std::string& l, const std::string& r) { return l > r; })
+        >>  take(2)
+        >>  select([](TestData2& d) { return d.name; })
+        >>  to_vector();
+    EXPECT_EQ(std::vector<std::string>({ "d", "c" }), desc);
+
+    auto lookup = from_container(data)
+        >>  to_lookup_ref([](TestData2& d) { return d.value; });
+    auto range1 = lookup[1];
+    ASSERT_TRUE (range1.next());
+    ASSERT_EQ   (&data.at(1), &range1.front());
+    ASSERT_TRUE (range1.next());
+    ASSERT_EQ   (&data.at(3), &range1.front());
+    ASSERT_FALSE(range1.next());
+
+    auto hash_lookup = from_container(data)
+        >>  to_hash_lookup_ref([](TestData2& d) { return d.value; });
+    auto range3 = hash_lookup[3];
+    ASSERT_TRUE (range3.next());
+    ASSERT_EQ   (&data.at(0), &range3.front());
+    ASSERT_FALSE(range3.next());
+
+    auto groups = from_container(data)
+        >>  group_by_ref([](TestData2& d) { return d.value; })
+        >>  select([](auto g) {
+                return g.second >> select([](TestData2& d) { return &d; }) >> to_vector();
+            })
+        >>  to_vector();
+    ASSERT_EQ(3, groups.size());
+    EXPECT_EQ(std::vector<TestData2*>({ &data.at(0) }), groups[0]);
+    EXPECT_EQ(std::vector<TestData2*>({ &data.at(1), &data.at(3) }), groups[1]);
+    EXPECT_EQ(std::vector<TestData2*>({ &data.at(2) }), groups[2]);
+}
+
+namespace linq_tests
+{
+    using ::test_helper::counting_resource;
+}
+
+TEST(LinqTest, memory_scope)
+{
+    std::vector<int> data({ 5, 3, 9, 3, 1, 5, 7, 9 });
+    std::vector<TestDataMany> many({ std::vector<int>({ 1, 2 }), std::vector<int>({ 3 }) });
+
+    auto evaluate = [&]{
+        size_t ret = 0;
+        ret += from_container(data) >> order_by() >> first();
+        ret += from_container(data) >> order_by_ref(op_select_default()) >> take(2) >> count();
+        ret += from_container(data) >> distinct() >> count();
+        ret += from_container(data) >> distinct_hash() >> count();
+        ret += from_container(data) >> to_lookup([](int i) { return i % 3; }, op_select_default()) >> count();
+        ret += (from_container(data) >> to_hash_lookup([](int i) { return i % 3; }, op_select_default()))[0] >> count();
+        ret += from_container(many) >> select_many([](TestDataMany& d) -> std::vector<int>& { return d.values; }) >> count();
+        return ret;
+    };
+
+    counting_resource counter;
+    auto previous = std::pmr::set_default_resource(&counter);
+
+    auto expected = evaluate();
+    EXPECT_LT(0, counter.allocations);
+
+    counter.allocations = 0;
+    utl::arena arena(1024, std::pmr::new_delete_resource());
+    size_t block_count = 0;
+    for (size_t run = 0; run < 3; ++run)
+    {
+        {
+            memory_scope scope(arena);
+            EXPECT_EQ(expected, evaluate());
+        }
+        EXPECT_LT(0, arena.used());
+        arena.reset();
+
+        /* the blocks of the first run are reused by the following runs */
+        if (run == 0)
+            block_count = arena.block_count();
+        EXPECT_EQ(block_count, arena.block_count());
+    }
+    EXPECT_EQ(0, counter.allocations);
+
+    /* the scope is restored after it was left */
+    evaluate();
+    EXPECT_LT(0, counter.allocations);
+
+    std::pmr::set_default_resource(previous);
+}
+
+TEST(LinqTest, push_evaluation)
+{
+    std::vector<int> data({ 1, 2, 3, 4, 5, 6, 7, 8, 9, 10 });
+    std::list<int>   list(data.begin(), data.end());
+
+    auto pipeline = [](auto&& range) {
+        return std::forward<decltype(range)>(range)
+            >>  where([](int& i) { return (i & 1) == 0; })
+            >>  select([](int& i) { return i * 3; })
+            >>  where([](int i) { return i > 10; });
+    };
+
+    /* partially consumed ranges push only their remaining elements */
+    auto range = pipeline(from_container(data));
+    ASSERT_TRUE (range.next());
+    EXPECT_EQ   (12, range.front());
+    EXPECT_EQ   (std::vector<int>({ 18, 24, 30 }), range >> to_vector());
+
+    /* random access (vector), pulled (list) and parallel sources produce the same results */
+    EXPECT_EQ(std::vector<int>({ 12, 18, 24, 30 }), pipeline(from_container(data)) >> to_vector());
+    EXPECT_EQ(std::vector<int>({ 12, 18, 24, 30 }), pipeline(from_container(list)) >> to_vector());
+    EXPECT_EQ(std::vector<int>({ 12, 18, 24, 30 }), pipeline(from_container(data) >> parallel(3)) >> to_vector());
+    EXPECT_EQ(4,  pipeline(from_container(data)) >> count());
+    EXPECT_EQ(4,  pipeline(from_container(list)) >> count());
+    EXPECT_EQ(84, pipeline(from_container(list)) >> linq::sum());
+    EXPECT_EQ(std::list<int>({ 12, 18, 24, 30 }), pipeline(from_container(data)) >> to_list());
+
+    auto map = pipeline(from_container(data))
+        >>  to_map([](int i) { return i; }, [](int i) { return i / 3; });
+    EXPECT_EQ((std::map<int, int>({ { 12, 4 }, { 18, 6 }, { 24, 8 }, { 30, 10 } })), map);
+
+    /* references to the source elements are passed through where stages */
+    std::vector<int*> pointers;
+    from_container(data)
+        >>  where([](int& i) { return i > 8; })
+        >>  for_each([&pointers](int& i) { pointers.push_back(&i); });
+    EXPECT_EQ(std::vector<int*>({ &data[8], &data[9] }), pointers);
+}
+
+TEST(LinqTest, join)
+{
+    using order_type    = std::pair<int, std::string>;   // customer id, article
+    using customer_type = std::pair<int, std::string>;   // customer id, name
+    std::vector<order_type> orders({
+        { 2, "book" },
+        { 1, "pen"  },
+        { 3, "lamp" },
+        { 2, "cup"  },
+        { 4, "desk" },
+    });
+    std::vector<customer_type> customers({
+        { 1, "alice" },
+        { 2, "bob"   },
+        { 3, "carol" },
+        { 2, "bert"  },
+    });
+
+    auto range = from_container(orders)
+        >>  join(
+                from_container(customers),
+                [](order_type& o) { return o.first; },
+                [](customer_type& c) { return c.first; },
+                [](order_type& o, customer_type& c) { return std::make_pair(&o, &c); });
+    ASSERT_TRUE (range.next());
+    EXPECT_EQ   (&orders[0],    range.front().first);
+    EXPECT_EQ   (&customers[1], range.front().second);
+    ASSERT_TRUE (range.next());
+    EXPECT_EQ   (&orders[0],    range.front().first);
+    EXPECT_EQ   (&customers[3], range.front().second);
+    ASSERT_TRUE (range.next());
+    EXPECT_EQ   (&orders[1],    range.front().first);
+    EXPECT_EQ   (&customers[0], range.front().second);
+    ASSERT_TRUE (range.next());
+    EXPECT_EQ   (&orders[2],    range.front().first);
+    EXPECT_EQ   (&customers[2], range.front().second);
+    ASSERT_TRUE (range.next());
+    EXPECT_EQ   (&orders[3],    range.front().first);
+    EXPECT_EQ   (&customers[1], range.front().second);
+    ASSERT_TRUE (range.next());
+    EXPECT_EQ   (&orders[3],    range.front().first);
+    EXPECT_EQ   (&customers[3], range.front().second);
+    ASSERT_FALSE(range.next());
+
+    /* inner range of values */
+    auto names = from_container(orders)
+        >>  where([](order_type& o) { return o.second != "cup"; })
+        >>  join(
+                from_container(customers) >> select([](customer_type& c) { return c; }),
+                [](order_type& o) { return o.first; },
+                [](customer_type c) { return c.first; },
+                [](order_type& o, customer_type& c) { return c.second + ":" + o.second; })
+        >>  to_vector();
+    EXPECT_EQ(std::vector<std::string>({ "bob:book", "bert:book", "alice:pen", "carol:lamp" }), names);
+
+    std::vector<order_type> empty;
+    EXPECT_EQ(0, from_container(empty)
+        >>  join(
+                from_container(customers),
+                [](order_type& o) { return o.first; },
+                [](customer_type& c) { return c.first; },
+                [](order_type& o, customer_type&) { return o.first; })
+        >>  count());
+}
+
+TEST(LinqTest, join_copy)
+{
+    std::vector<int> outer({ 1, 2 });
+    std::vector<int> inner({ 1, 1, 2 });
+    auto range = from_container(outer)
+        >>  join(
+                from_container(inner),
+                [](int& i) { return i; },
+                [](int& i) { return i; },
+                [](int& o, int& i) { return std::make_pair(&o, &i); });
+    using pair_type = std::pair<int*, int*>;
+
+    /* copies and moves of a started join continue with the remaining matches */
+    ASSERT_TRUE (range.next());
+    EXPECT_EQ   (pair_type(&outer[0], &inner[0]), range.front());
+    const auto& crange = range;
+    auto copy = crange;
+    EXPECT_EQ   (pair_type(&outer[0], &inner[0]), copy.front());
+    auto moved = std::move(range);
+    EXPECT_EQ(std::vector<pair_type>({ { &outer[0], &inner[1] }, { &outer[1], &inner[2] } }), copy  >> to_vector());
+    EXPECT_EQ(std::vector<pair_type>({ { &outer[0], &inner[1] }, { &outer[1], &inner[2] } }), moved >> to_vector());
+
+    auto merge = from_container(outer)
+        >>  merge_join(
+                from_container(inner),
+                [](int& i) { return i; },
+                [](int& i) { return i; },
+                [](int& o, int& i) { return std::make_pair(&o, &i); });
+    ASSERT_TRUE (merge.next());
+    const auto& cmerge = merge;
+    auto merge_copy = cmerge;
+    EXPECT_EQ(std::vector<pair_type>({ { &outer[0], &inner[1] }, { &outer[1], &inner[2] } }), merge_copy >> to_vector());
+}
+
+TEST(LinqTest, merge_join)
+{
+    std::vector<int> outer({ 1, 2, 2, 4, 5, 7 });
+    std::vector<int> inner({ 0, 2, 2, 3, 5, 5, 7, 8 });
+
+    auto pairs = from_container(outer)
+        >>  merge_join(
+                from_container(inner),
+                [](int& i) { return i; },
+                [](int& i) { return i; },
+                [](int& o, int& i) { return std::make_pair(&o, &i); })
+        >>  to_vector();
+    using pair_type = std::pair<int*, int*>;
+    EXPECT_EQ(std::vector<pair_type>({
+        { &outer[1], &inner[1] },
+        { &outer[1], &inner[2] },
+        { &outer[2], &inner[1] },
+        { &outer[2], &inner[2] },
+        { &outer[4], &inner[4] },
+        { &outer[4], &inner[5] },
+        { &outer[5], &inner[6] },
+    }), pairs);
+
+    /* same result as the hash join */
+    auto hashed = from_container(outer)
+        >>  join(
+                from_container(inner),
+                [](int& i) { return i; },
+                [](int& i) { return i; },
+                [](int& o, int& i) { return std::make_pair(&o, &i); })
+        >>  to_vector();
+    EXPECT_EQ(hashed, pairs);
+
+    /* descending order */
+    std::vector<int> outer_desc(outer.rbegin(), outer.rend());
+    std::vector<int> inner_desc(inner.rbegin(), inner.rend());
+    EXPECT_EQ(7, from_container(outer_desc)
+        >>  merge_join(
+                from_container(inner_desc),
+                [](int& i) { return i; },
+                [](int& i) { return i; },
+                [](int& o, int&) { return o; },
+                [](int l, int r) { return l > r; })
+        >>  count());
+
+    std::vector<int> unordered({ 3, 1 });
+    EXPECT_THROW(from_container(unordered)
+        >>  merge_join(
+                from_container(inner),
+                [](int& i) { return i; },
+                [](int& i) { return i; },
+                [](int& o, int&) { return o; })
+        >>  count(), utl::exception);
+    EXPECT_THROW(from_container(outer)
+        >>  merge_join(
+                from_container(unordered),
+                [](int& i) { return i; },
+                [](int& i) { return i; },
+                [](int& o, int&) { return o; })
+        >>  count(), utl::exception);
+}
+
+TEST(LinqTest, batch)
+{
+    std::vector<int> data({ 1, 2, 3, 4, 5, 6, 7 });
+
+    /* batches of a contiguous range refer to the range */
+    auto range = from_container(data) >> batch(3);
+    ASSERT_TRUE (range.next());
+    ASSERT_EQ   (3, range.front().size());
+    EXPECT_EQ   (&data[0], range.front().data());
+    ASSERT_TRUE (range.next());
+    ASSERT_EQ   (3, range.front().size());
+    EXPECT_EQ   (&data[3], range.front().data());
+    ASSERT_TRUE (range.next());
+    ASSERT_EQ   (1, range.front().size());
+    EXPECT_EQ   (&data[6], range.front().data());
+    ASSERT_FALSE(range.next());
+
+    /* other ranges are copied into one reused buffer */
+    std::vector<size_t> sizes;
+    std::vector<int>    sums;
+    const int*          buffer = nullptr;
+    bool                reused = true;
+    from_container(data)
+        >>  where([](int& i) { return i != 4; })
+        >>  batch(4)
+        >>  for_each([&](linq::span<int>& b) {
+                if (buffer)
+                    reused = reused && buffer == b.data();
+                buffer = b.data();
+                sizes.push_back(b.size());
+                sums.push_back(std::accumulate(b.begin(), b.end(), 0));
+            });
+    EXPECT_TRUE(reused);
+    EXPECT_EQ  (std::vector<size_t>({ 4, 2 }), sizes);
+    EXPECT_EQ  (std::vector<int>({ 11, 13 }), sums);
+
+    /* batches can be passed to batched functions and flattened again */
+    auto doubled = from_container(data)
+        >>  batch(3)
+        >>  select([](linq::span<int>& b) {
+                std::vector<int> ret;
+                for (auto& i : b)
+                    ret.push_back(2 * i);
+                return ret;
+            })
+        >>  unbatch()
+        >>  to_vector();
+    EXPECT_EQ(std::vector<int>({ 2, 4, 6, 8, 10, 12, 14 }), doubled);
+
+    auto roundtrip = from_container(data)
+        >>  where([](int& i) { return i > 2; })
+        >>  batch(2)
+        >>  unbatch()
+        >>  to_vector();
+    EXPECT_EQ(std::vector<int>({ 3, 4, 5, 6, 7 }), roundtrip);
+
+    std::vector<int*> pointers;
+    from_container(data)
+        >>  batch(5)
+        >>  unbatch()
+        >>  for_each([&pointers](int& i) { pointers.push_back(&i); });
+    ASSERT_EQ(7, pointers.size());
+    EXPECT_EQ(&data[6], pointers.back());
+
+    std::vector<int> empty;
+    EXPECT_EQ   (0, from_container(empty) >> batch(3) >> count());
+    EXPECT_THROW(batch(0), utl::exception);
+}
@@ -0,0 +1,113 @@
+#include <cmath>
+#include <vector>
+#include <gtest/gtest.h>
+#include <cpputils/misc/simd.h>
+
+using namespace ::utl;
+using namespace ::utl::simd;
+
+namespace simd_tests
+{
+    /* all instruction sets that are supported by the executing cpu */
+    inline std::vector<instruction_set> instruction_sets()
+    {
+        std::vector<instruction_set> ret({ instruction_set::scalar });
+        if (supported_instruction_set() >= instruction_set::sse42)
+            ret.push_back(instruction_set::sse42);
+        if (supported_instruction_set() >= instruction_set::avx2)
+            ret.push_back(instruction_set::avx2);
+        return ret;
+    }
+
+    template<class T>
+    inline std::vector<T> make_data(size_t size)
+    {
+        std::vector<T> ret;
+        for (size_t i = 0; i < size; ++i)
+            ret.push_back(static_cast<T>(static_cast<int64_t>((i * 7919) % 1000) - 500));
+        return ret;
+    }
+
+    template<class T>
+    inline void check_reduce()
+    {
+        for (size_t size : { 0, 1, 3, 17, 1003 })
+        {
+            auto data = make_data<T>(size);
+            T expected_sum = T();
+            T expected_min = std::numeric_limits<T>::max();
+            T expected_max = std::numeric_limits<T>::lowest();
+            for (auto& v : data)
+            {
+                expected_sum = static_cast<T>(expected_sum + v);
+                expected_min = std::min(expected_min, v);
+                expected_max = std::max(expected_max, v);
+            }
+            for (auto is : instruction_sets())
+            {
+                EXPECT_EQ(expected_sum, simd::sum(data.data(), data.size(), is));
+                EXPECT_EQ(expected_min, simd::min(data.data(), data.size(), is));
+                EXPECT_EQ(expected_max, simd::max(data.data(), data.size(), is));
+            }
+        }
+    }
+
+    template<class T>
+    inline void check_nan()
+    {
+        const T nan = std::numeric_limits<T>::quiet_NaN();
+        for (size_t size : { 1, 5, 64, 203 })
+        {
+            for (size_t pos = 0; pos < size; ++pos)
+            {
+                auto data = make_data<T>(size);
+                data[pos] = nan;
+                T expected_min = std::numeric_limits<T>::max();
+                T expected_max = std::numeric_limits<T>::lowest();
+                for (auto& v : data)
+                {
+                    if (std::isnan(v))
+                        continue;
+                    expected_min = std::min(expected_min, v);
+                    expected_max = std::max(expected_max, v);
+                }
+                for (auto is : instruction_sets())
+                {
+                    EXPECT_EQ(expected_min, simd::min(data.data(), data.size(), is));
+                    EXPECT_EQ(expected_max, simd::max(data.data(), data.size(), is));
+                    EXPECT_TRUE(std::isnan(simd::sum(data.data(), data.size(), is)));
+                }
+            }
+        }
+
+        std::vector<T> data(64, nan);
+        for (auto is : instruction_sets())
+        {
+            EXPECT_EQ(std::numeric_limits<T>::max(),    simd::min(data.data(), data.size(), is));
+            EXPECT_EQ(std::numeric_limits<T>::lowest(), simd::max(data.data(), data.size(), is));
+        }
+    }
+}
+
+using namespace ::simd_tests;
+
+TEST(simd_tests, reduce_float)
+    { check_reduce<float>(); }
+
+TEST(simd_tests, reduce_double)
+    { check_reduce<double>(); }
+
+TEST(simd_tests, reduce_int32)
+    { check_reduce<int32_t>(); }
+
+TEST(simd_tests, reduce_int64)
+    { check_reduce<int64_t>(); }
+
+TEST(simd_tests, nan_float)
+    { check_nan<float>(); }
+
+TEST(simd_tests, nan_double)
+    { check_nan<double>(); }
+
+TEST(simd_tests, reduce_unsupported_type)
+    { check_reduce<int16_t>(); }